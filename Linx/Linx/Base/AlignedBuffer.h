@@ -6,6 +6,7 @@
 #define _LINXBASE_ALIGNEDBUFFER_H
 
 #include "Linx/Base/Exceptions.h"
+#include "Linx/Base/Instrumentation.h"
 #include "Linx/Base/TypeUtils.h"
 
 #include <algorithm> // copy_n
@@ -154,6 +155,7 @@ public:
   AlignedBuffer& operator=(const AlignedBuffer& other)
   {
     if (this != &other) {
+      reset();
       m_as = other.m_as; // Must be set before allocate()
       if (other.owns()) {
         allocate(other.m_end - other.m_begin);
@@ -173,6 +175,7 @@ public:
   AlignedBuffer& operator=(AlignedBuffer&& other)
   {
     if (this != &other) {
+      reset();
       m_container = other.release();
       m_begin = other.m_begin;
       m_end = other.m_end;
@@ -259,6 +262,7 @@ public:
   void reset()
   {
     if (m_container) {
+      instrument_deallocation<AlignedBuffer>(sizeof(T) * (m_end - m_begin));
       std::free(m_container);
       m_container = nullptr;
     }
@@ -273,6 +277,7 @@ private:
   {
     const auto valid_size = ((size + m_as - 1) / m_as) * m_as; // Smallest multiple of m_as >= size
     m_container = std::aligned_alloc(m_as, sizeof(T) * valid_size);
+    instrument_allocation<AlignedBuffer>(sizeof(T) * size);
     m_begin = reinterpret_cast<T*>(m_container);
     m_end = m_begin + size;
   }
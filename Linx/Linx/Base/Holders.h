@@ -6,6 +6,7 @@
 #define _LINXBASE_HOLDER_H
 
 #include "Linx/Base/Exceptions.h"
+#include "Linx/Base/Instrumentation.h"
 
 #include <algorithm> // copy_n
 #include <array>
@@ -65,7 +66,7 @@ inline const T* data(const T (&c)[N]) noexcept
  * @satisfies{ContiguousRange}
  */
 template <typename TContainer>
-class StdHolder {
+class StdHolder : private AllocationTracker<StdHolder<TContainer>> {
 public:
 
   /**
@@ -80,7 +81,8 @@ public:
    * @brief Default or size-based constructor.
    */
   template <typename U = typename TContainer::value_type>
-  explicit StdHolder(std::size_t size, U* data = nullptr) : m_container(size)
+  explicit StdHolder(std::size_t size, U* data = nullptr) :
+      AllocationTracker<StdHolder>(size * sizeof(typename TContainer::value_type)), m_container(size)
   {
     if (data) {
       std::copy_n(data, size, const_cast<typename TContainer::value_type*>(this->begin()));
@@ -90,7 +92,8 @@ public:
   /**
    * @brief Container-move constructor.
    */
-  explicit StdHolder(std::size_t size, Container&& container) : m_container(std::move(container))
+  explicit StdHolder(std::size_t size, Container&& container) :
+      AllocationTracker<StdHolder>(size * sizeof(typename TContainer::value_type)), m_container(std::move(container))
   {
     SizeError::may_throw(m_container.size(), size);
   }
@@ -214,19 +217,21 @@ private:
  * @brief `std::unique_ptr` specialization.
  */
 template <typename T>
-class StdHolder<std::unique_ptr<T[]>> {
+class StdHolder<std::unique_ptr<T[]>> : private AllocationTracker<StdHolder<std::unique_ptr<T[]>>> {
 public:
 
   using Container = std::unique_ptr<T[]>;
 
-  explicit StdHolder(std::size_t size, const T* data = nullptr) : m_size(size), m_container {new T[m_size]}
+  explicit StdHolder(std::size_t size, const T* data = nullptr) :
+      AllocationTracker<StdHolder>(size * sizeof(T)), m_size(size), m_container {new T[m_size]}
   {
     if (data) {
       std::copy_n(data, m_size, m_container.get());
     }
   }
 
-  explicit StdHolder(std::size_t size, Container&& container) : m_size(size), m_container(std::move(container))
+  explicit StdHolder(std::size_t size, Container&& container) :
+      AllocationTracker<StdHolder>(size * sizeof(T)), m_size(size), m_container(std::move(container))
   {
     SizeError::may_throw(m_container.size(), size);
   }
@@ -241,6 +246,7 @@ public:
 
   friend void swap(StdHolder& lhs, StdHolder& rhs)
   {
+    std::swap(static_cast<AllocationTracker<StdHolder>&>(lhs), static_cast<AllocationTracker<StdHolder>&>(rhs));
     std::swap(lhs.m_size, rhs.m_size);
     std::swap(lhs.m_container, rhs.m_container);
   }
@@ -0,0 +1,393 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXBASE_INSTRUMENTATION_H
+#define _LINXBASE_INSTRUMENTATION_H
+
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <typeindex>
+#include <typeinfo>
+
+namespace Linx {
+
+/**
+ * @brief Memory statistics.
+ *
+ * Byte counts are logical, i.e. they do not take into account padding or allocator overhead.
+ */
+struct MemoryStats {
+  /**
+   * @brief The number of allocations.
+   */
+  std::size_t allocations = 0;
+
+  /**
+   * @brief The number of deallocations.
+   */
+  std::size_t deallocations = 0;
+
+  /**
+   * @brief The cumulated number of allocated bytes.
+   */
+  std::size_t allocated_bytes = 0;
+
+  /**
+   * @brief The number of currently allocated bytes.
+   */
+  std::size_t live_bytes = 0;
+
+  /**
+   * @brief The maximum number of simultaneously allocated bytes.
+   */
+  std::size_t peak_bytes = 0;
+
+  /**
+   * @brief The number of bytes read by instrumented algorithms.
+   */
+  std::size_t read_bytes = 0;
+
+  /**
+   * @brief The number of bytes written by instrumented algorithms.
+   */
+  std::size_t written_bytes = 0;
+
+  /**
+   * @brief Record an allocation.
+   */
+  void allocate(std::size_t bytes)
+  {
+    ++allocations;
+    allocated_bytes += bytes;
+    live_bytes += bytes;
+    peak_bytes = std::max(peak_bytes, live_bytes);
+  }
+
+  /**
+   * @brief Record a deallocation.
+   */
+  void deallocate(std::size_t bytes)
+  {
+    ++deallocations;
+    live_bytes -= bytes;
+  }
+};
+
+/**
+ * @brief Allocation and memory traffic counters.
+ *
+ * The counters are only incremented if `LINX_INSTRUMENTATION` is defined,
+ * which must be done consistently for all translation units, e.g. with CMake option `LINX_INSTRUMENTATION`.
+ * Otherwise, the counters remain null and the instrumentation has no runtime cost.
+ *
+ * Allocations are counted per holder type (e.g. `StdHolder<std::vector<float>>` or `AlignedBuffer<float>`),
+ * and traffic is counted by the algorithms themselves:
+ * filters count the bytes they read from their input and write to their output,
+ * while I/O functions count the bytes read from or written to files.
+ *
+ * \code
+ * Instrumentation::instance().reset();
+ * auto out = filter * in;
+ * const auto stats = Instrumentation::instance().total();
+ * std::cout << stats.allocations << " allocations, " << stats.read_bytes << " bytes read" << std::endl;
+ * \endcode
+ *
+ * @see `StepperPipeline::memory()`
+ */
+class Instrumentation {
+private:
+
+  /**
+   * @brief Private constructor of the singleton.
+   */
+  Instrumentation() : m_mutex(), m_holders(), m_total(), m_local_peak(0) {}
+
+public:
+
+  /**
+   * @brief Get the unique instance.
+   */
+  static Instrumentation& instance()
+  {
+    static Instrumentation out;
+    return out;
+  }
+
+  /**
+   * @brief Check whether instrumentation is enabled at compile time.
+   */
+  static constexpr bool enabled()
+  {
+#ifdef LINX_INSTRUMENTATION
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  /**
+   * @brief Record an allocation by a given holder type.
+   */
+  void allocate(std::type_index holder, std::size_t bytes)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_holders[holder].allocate(bytes);
+    m_total.allocate(bytes);
+    m_local_peak = std::max(m_local_peak, m_total.live_bytes);
+  }
+
+  /**
+   * @brief Record a deallocation by a given holder type.
+   */
+  void deallocate(std::type_index holder, std::size_t bytes)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_holders[holder].deallocate(bytes);
+    m_total.deallocate(bytes);
+  }
+
+  /**
+   * @brief Record some bytes read.
+   */
+  void read(std::size_t bytes)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_total.read_bytes += bytes;
+  }
+
+  /**
+   * @brief Record some bytes written.
+   */
+  void write(std::size_t bytes)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_total.written_bytes += bytes;
+  }
+
+  /**
+   * @brief Get the statistics of a given holder type.
+   */
+  MemoryStats holder(std::type_index holder) const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto it = m_holders.find(holder);
+    return it == m_holders.end() ? MemoryStats() : it->second;
+  }
+
+  /**
+   * @brief Get the statistics of a given holder type.
+   */
+  template <typename THolder>
+  MemoryStats holder() const
+  {
+    return holder(std::type_index(typeid(THolder)));
+  }
+
+  /**
+   * @brief Get the statistics of all holder types.
+   */
+  std::map<std::type_index, MemoryStats> holders() const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_holders;
+  }
+
+  /**
+   * @brief Get the statistics of all holder types, cumulated, and the traffic.
+   */
+  MemoryStats total() const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_total;
+  }
+
+  /**
+   * @brief Get the peak live bytes since the last call to `reset_local_peak()`.
+   */
+  std::size_t local_peak() const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_local_peak;
+  }
+
+  /**
+   * @brief Reset the local peak to the current live bytes.
+   */
+  void reset_local_peak()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_local_peak = m_total.live_bytes;
+  }
+
+  /**
+   * @brief Raise the local peak to at least some value, e.g. an enclosing peak saved before a nested reset.
+   */
+  void merge_local_peak(std::size_t peak)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_local_peak = std::max(m_local_peak, peak);
+  }
+
+  /**
+   * @brief Reset the counters, except live bytes.
+   */
+  void reset()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& h : m_holders) {
+      h.second = reset(h.second);
+    }
+    m_total = reset(m_total);
+    m_local_peak = m_total.live_bytes;
+  }
+
+private:
+
+  /**
+   * @brief Reset some statistics, except live bytes.
+   */
+  static MemoryStats reset(const MemoryStats& in)
+  {
+    MemoryStats out;
+    out.live_bytes = in.live_bytes;
+    out.peak_bytes = in.live_bytes;
+    return out;
+  }
+
+  /**
+   * @brief The mutex.
+   */
+  mutable std::mutex m_mutex;
+
+  /**
+   * @brief The statistics per holder type.
+   */
+  std::map<std::type_index, MemoryStats> m_holders;
+
+  /**
+   * @brief The cumulated statistics.
+   */
+  MemoryStats m_total;
+
+  /**
+   * @brief The peak live bytes since the last reset.
+   */
+  std::size_t m_local_peak;
+};
+
+/**
+ * @brief Allocation tracker of holders.
+ * @tparam THolder The holder type
+ *
+ * Owning holders inherit this class and construct it with the number of bytes they allocate.
+ * Copies, moves and destruction are then tracked automatically.
+ * If `LINX_INSTRUMENTATION` is not defined, the class is empty and holders benefit from the empty base optimization.
+ */
+template <typename THolder>
+class AllocationTracker {
+public:
+
+#ifdef LINX_INSTRUMENTATION
+
+  explicit AllocationTracker(std::size_t bytes = 0) : m_bytes(bytes)
+  {
+    track();
+  }
+
+  AllocationTracker(const AllocationTracker& other) : AllocationTracker(other.m_bytes) {}
+
+  AllocationTracker(AllocationTracker&& other) : m_bytes(other.m_bytes)
+  {
+    other.m_bytes = 0;
+  }
+
+  AllocationTracker& operator=(const AllocationTracker& other)
+  {
+    if (this != &other) {
+      untrack();
+      m_bytes = other.m_bytes;
+      track();
+    }
+    return *this;
+  }
+
+  AllocationTracker& operator=(AllocationTracker&& other)
+  {
+    if (this != &other) {
+      untrack();
+      m_bytes = other.m_bytes;
+      other.m_bytes = 0;
+    }
+    return *this;
+  }
+
+  ~AllocationTracker()
+  {
+    untrack();
+  }
+
+private:
+
+  void track()
+  {
+    if (m_bytes) {
+      Instrumentation::instance().allocate(typeid(THolder), m_bytes);
+    }
+  }
+
+  void untrack()
+  {
+    if (m_bytes) {
+      Instrumentation::instance().deallocate(typeid(THolder), m_bytes);
+    }
+  }
+
+  std::size_t m_bytes;
+
+#else
+
+  explicit AllocationTracker(std::size_t = 0) {}
+
+#endif
+};
+
+/**
+ * @brief Record the allocation of some bytes by a holder of given type.
+ */
+template <typename THolder>
+inline void instrument_allocation([[maybe_unused]] std::size_t bytes)
+{
+#ifdef LINX_INSTRUMENTATION
+  Instrumentation::instance().allocate(typeid(THolder), bytes);
+#endif
+}
+
+/**
+ * @brief Record the deallocation of some bytes by a holder of given type.
+ */
+template <typename THolder>
+inline void instrument_deallocation([[maybe_unused]] std::size_t bytes)
+{
+#ifdef LINX_INSTRUMENTATION
+  Instrumentation::instance().deallocate(typeid(THolder), bytes);
+#endif
+}
+
+/**
+ * @brief Record some memory traffic.
+ */
+inline void instrument_traffic([[maybe_unused]] std::size_t read_bytes, [[maybe_unused]] std::size_t written_bytes)
+{
+#ifdef LINX_INSTRUMENTATION
+  auto& instrumentation = Instrumentation::instance();
+  instrumentation.read(read_bytes);
+  instrumentation.write(written_bytes);
+#endif
+}
+
+} // namespace Linx
+
+#endif
@@ -371,7 +371,8 @@ public:
    * @brief Multiple values constructor.
    */
   explicit ImpulseNoise(const std::map<T, double>& values_probabilities, std::size_t seed = -1) :
-      RandomGenerator(seed), m_values(values(values_probabilities)), m_distribution(distribution(values_probabilities))
+      RandomGenerator(seed), m_values(values(values_probabilities)), m_distribution(distribution(values_probabilities)),
+      m_probability(probability(values_probabilities)), m_value_distribution(value_distribution(values_probabilities))
   {}
 
   /**
@@ -399,6 +400,49 @@ public:
     return index < m_values.size() ? m_values[index] : in;
   }
 
+  /**
+   * @brief Apply impulse noise to the elements of a range, skipping unaffected elements.
+   * @return The indices of the affected elements, in increasing order
+   * 
+   * Applying the generator element-wise draws one random number per element, even for small probabilities.
+   * Instead, this method draws the gaps between affected elements from a geometric distribution,
+   * and then the impulse values of the affected elements only.
+   * The result is statistically equivalent to `in.apply(noise)`,
+   * but the cost is proportional to the number of affected elements instead of the size of the range.
+   */
+  template <typename TRange>
+  std::vector<std::size_t> sparse_apply(TRange& in)
+  {
+    std::vector<std::size_t> out;
+    if (m_probability <= 0) {
+      return out;
+    }
+    const auto begin = in.begin();
+    const std::size_t size = std::distance(begin, in.end());
+    const auto draw = [&]() {
+      return m_values.size() == 1 ? m_values[0] : m_values[generate<std::size_t>(m_value_distribution)];
+    };
+    if (m_probability >= 1) { // All elements are affected, and geometric_distribution requires p < 1
+      out.resize(size);
+      for (std::size_t i = 0; i < size; ++i) {
+        *(begin + i) = draw();
+        out[i] = i;
+      }
+      return out;
+    }
+    std::geometric_distribution<std::size_t> gaps(m_probability);
+    for (std::size_t i = generate<std::size_t>(gaps); i < size;) {
+      *(begin + i) = draw();
+      out.push_back(i);
+      const auto gap = generate<std::size_t>(gaps);
+      if (gap >= size - i - 1) {
+        break;
+      }
+      i += gap + 1;
+    }
+    return out;
+  }
+
 private:
 
   /**
@@ -441,6 +485,28 @@ private:
     return std::discrete_distribution<std::size_t>(w.begin(), w.end());
   }
 
+  /**
+   * @brief Compute the probability that an element is affected.
+   */
+  static double probability(const std::map<T, double>& values_probabilities)
+  {
+    double out = 0;
+    for (const auto& vp : values_probabilities) {
+      out += vp.second;
+    }
+    return out;
+  }
+
+  /**
+   * @brief Construct the distribution of the impulse values, given that an element is affected.
+   */
+  static std::discrete_distribution<std::size_t> value_distribution(const std::map<T, double>& values_probabilities)
+  {
+    auto w = weights(values_probabilities);
+    w.resize(values_probabilities.size()); // Discard null hypothesis
+    return std::discrete_distribution<std::size_t>(w.begin(), w.end());
+  }
+
   /**
    * @brief The impulse values.
    */
@@ -450,6 +516,16 @@ private:
    * @brief The impulse value index distribution.
    */
   std::discrete_distribution<std::size_t> m_distribution;
+
+  /**
+   * @brief The probability that an element is affected.
+   */
+  double m_probability;
+
+  /**
+   * @brief The impulse value index distribution, given that an element is affected.
+   */
+  std::discrete_distribution<std::size_t> m_value_distribution;
 };
 
 } // namespace Linx
@@ -0,0 +1,311 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXDATA_BLOCKEDRASTER_H
+#define _LINXDATA_BLOCKEDRASTER_H
+
+#include "Linx/Data/Raster.h"
+
+#include <algorithm> // min
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @ingroup data_classes
+ * @brief Raster with blocked memory layout.
+ * @tparam T The value type
+ * @tparam N The dimension
+ * @tparam B The base-2 logarithm of the block side, e.g. 6 for 64x64 blocks
+ *
+ * As opposed to `Raster`, where elements are stored in row-major ordering,
+ * elements are grouped into square blocks of side `2^B` in the plane of the first two axes,
+ * which are stored contiguously.
+ * Higher axes are not blocked: a 3D raster is a sequence of blocked planes,
+ * such that the block size does not grow with the dimension.
+ * Inside a block, elements are stored in row-major ordering, and so are the blocks themselves.
+ * The shape is padded to a multiple of the block side along the first two axes,
+ * but padding is not part of the domain.
+ *
+ * This layout is well suited to accesses which are local along the first two axes at once,
+ * e.g. when interpolating along rotated lines: neighbors along any axis are likely to belong to the same block.
+ * On the other hand, row-wise traversals are slower than with `Raster`, because of the more complex indexing.
+ *
+ * The class provides the same element access interface as `Raster`, such that it can be decorated
+ * with `Extrapolation` and `Interpolation`, or used as the output of `Affinity::transform()`.
+ * Conversion from and to rasters is performed with `blocked()` and `rasterize()`.
+ *
+ * \code
+ * const auto blocked_in = blocked(in);
+ * const auto out = rotate_deg<Linear>(extrapolation(blocked_in), 30); // Output is a Raster
+ * \endcode
+ */
+template <typename T, Index N = 2, Index B = 6>
+class BlockedRaster {
+public:
+
+  /**
+   * @brief The value type.
+   */
+  using Value = T;
+
+  /**
+   * @brief The value type, for compatibility with standard containers.
+   */
+  using value_type = T;
+
+  /**
+   * @brief The dimension parameter.
+   */
+  static constexpr Index Dimension = N;
+
+  /**
+   * @brief The base-2 logarithm of the block side.
+   */
+  static constexpr Index BlockExponent = B;
+
+  /**
+   * @brief The block side.
+   */
+  static constexpr Index BlockSide = Index(1) << B;
+
+  /**
+   * @brief The number of blocked axes, i.e. the first two axes at most.
+   */
+  static constexpr Index BlockedAxes = 2;
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Constructor.
+   */
+  explicit BlockedRaster(Position<N> shape = Position<N>::zero()) :
+      m_shape(LINX_MOVE(shape)), m_blocks(m_shape), m_block_size(Index(1) << (B * blocked_dimension())),
+      m_container()
+  {
+    for (Index i = 0; i < blocked_dimension(); ++i) {
+      m_blocks[i] = (m_shape[i] + BlockSide - 1) >> B;
+    }
+    m_container.resize(shape_size(m_blocks) * m_block_size);
+  }
+
+  /**
+   * @brief Copy constructor from any iterable object with a box domain.
+   *
+   * The elements of the input are expected to be iterated in row-major ordering, like rasters.
+   */
+  template <typename TIn>
+  explicit BlockedRaster(const TIn& in) : BlockedRaster(in.shape())
+  {
+    auto it = in.begin();
+    for (const auto& p : domain()) {
+      (*this)[p] = *it;
+      ++it;
+    }
+  }
+
+  /// @group_properties
+
+  /**
+   * @brief Get the number of dimensions.
+   */
+  Index dimension() const
+  {
+    return m_shape.size();
+  }
+
+  /**
+   * @brief Get the number of blocked axes.
+   */
+  Index blocked_dimension() const
+  {
+    return std::min(dimension(), BlockedAxes);
+  }
+
+  /**
+   * @brief Get the raster shape.
+   */
+  const Position<N>& shape() const
+  {
+    return m_shape;
+  }
+
+  /**
+   * @brief Get the raster domain.
+   */
+  Box<N> domain() const
+  {
+    return Box<N>::from_shape(m_shape);
+  }
+
+  /**
+   * @brief Get the number of elements, padding excluded.
+   */
+  Index size() const
+  {
+    return shape_size(m_shape);
+  }
+
+  /**
+   * @brief Get the number of blocks along each axis.
+   *
+   * Along unblocked axes, this is the length of the axis.
+   */
+  const Position<N>& blocks() const
+  {
+    return m_blocks;
+  }
+
+  /**
+   * @brief Check whether a position lies inside the domain.
+   */
+  template <typename TPosition>
+  bool contains(const TPosition& position) const
+  {
+    for (std::size_t i = 0; i < m_shape.size(); ++i) {
+      if (position[i] < 0 || position[i] >= m_shape[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// @group_elements
+
+  /**
+   * @brief Compute the storage index of a given position.
+   */
+  inline Index index(const Position<N>& position) const
+  {
+    constexpr Index mask = BlockSide - 1;
+    const auto blocked = blocked_dimension();
+    Index block = 0;
+    for (auto i = dimension() - 1; i >= blocked; --i) {
+      block = block * m_blocks[i] + position[i];
+    }
+    Index offset = 0;
+    for (auto i = blocked - 1; i >= 0; --i) {
+      block = block * m_blocks[i] + (position[i] >> B);
+      offset = (offset << B) + (position[i] & mask);
+    }
+    return block * m_block_size + offset;
+  }
+
+  /**
+   * @brief Access the element at given position.
+   */
+  inline const T& operator[](const Position<N>& position) const
+  {
+    return m_container[index(position)];
+  }
+
+  /**
+   * @copybrief operator[]()const
+   */
+  inline T& operator[](const Position<N>& position)
+  {
+    return m_container[index(position)];
+  }
+
+  /**
+   * @brief Get a patch.
+   */
+  template <typename TRegion, typename std::enable_if_t<is_region<TRegion>()>* = nullptr>
+  Patch<const T, const BlockedRaster, std::decay_t<TRegion>> operator()(TRegion&& region) const
+  {
+    return Patch<const T, const BlockedRaster, std::decay_t<TRegion>>(*this, LINX_FORWARD(region));
+  }
+
+  /**
+   * @copybrief operator()(TRegion)const
+   */
+  template <typename TRegion, typename std::enable_if_t<is_region<TRegion>()>* = nullptr>
+  Patch<T, BlockedRaster, std::decay_t<TRegion>> operator()(TRegion&& region)
+  {
+    return Patch<T, BlockedRaster, std::decay_t<TRegion>>(*this, LINX_FORWARD(region));
+  }
+
+  /**
+   * @brief Get a pointer to the storage, padding included.
+   */
+  const T* data() const
+  {
+    return m_container.data();
+  }
+
+  /**
+   * @copybrief data()const
+   */
+  T* data()
+  {
+    return m_container.data();
+  }
+
+  /// @group_modifiers
+
+  /**
+   * @brief Fill with a given value, padding included.
+   */
+  BlockedRaster& fill(const T& value)
+  {
+    std::fill(m_container.begin(), m_container.end(), value);
+    return *this;
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief The shape, padding excluded.
+   */
+  Position<N> m_shape;
+
+  /**
+   * @brief The number of blocks along each axis.
+   */
+  Position<N> m_blocks;
+
+  /**
+   * @brief The number of elements in a block.
+   */
+  Index m_block_size;
+
+  /**
+   * @brief The storage.
+   */
+  std::vector<T> m_container;
+};
+
+/**
+ * @relatesalso BlockedRaster
+ * @brief Copy a raster into a blocked raster.
+ * @tparam B The base-2 logarithm of the block side
+ */
+template <Index B = 6, typename T, Index N, typename THolder>
+BlockedRaster<std::decay_t<T>, N, B> blocked(const Raster<T, N, THolder>& in)
+{
+  return BlockedRaster<std::decay_t<T>, N, B>(in);
+}
+
+/**
+ * @relatesalso BlockedRaster
+ * @brief Copy a blocked raster into a raster.
+ */
+template <typename T, Index N, Index B>
+Raster<T, N> rasterize(const BlockedRaster<T, N, B>& in)
+{
+  Raster<T, N> out(in.shape());
+  auto it = out.begin();
+  for (const auto& p : out.domain()) {
+    *it = in[p];
+    ++it;
+  }
+  return out;
+}
+
+} // namespace Linx
+
+#endif
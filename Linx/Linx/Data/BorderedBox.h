@@ -7,6 +7,7 @@
 
 #include "Linx/Data/Box.h"
 
+#include <algorithm>
 #include <deque>
 #include <vector>
 
@@ -36,22 +37,32 @@ public:
    */
   BorderedBox(const Box<N>& box, const Box<N>& margin) : m_inner(box - margin), m_fronts(), m_backs()
   {
-    // FIXME m_fronts = {box} if m_inner.size() <= 0
-    auto current = m_inner;
     const auto dim = m_inner.dimension();
+    bool is_empty = false;
+    for (Index i = 0; i < dim; ++i) { // Margins which do not contain the origin
+      m_inner.m_front[i] = std::max(m_inner.m_front[i], box.m_front[i]);
+      m_inner.m_back[i] = std::min(m_inner.m_back[i], box.m_back[i]);
+      is_empty |= m_inner.m_front[i] > m_inner.m_back[i];
+    }
+    if (is_empty) { // Margin larger than the box
+      m_inner.m_back[0] = m_inner.m_front[0] - 1;
+      m_fronts.push_back(box);
+      return;
+    }
+    auto current = m_inner;
     m_backs.reserve(dim);
     for (Index i = 0; i < dim; ++i) {
-      const auto f = margin.front()[i];
-      if (f < 0) {
+      const auto f = current.m_front[i] - box.m_front[i];
+      if (f > 0) {
         auto before = current;
         before.m_back[i] = current.m_front[i] - 1;
-        before.m_front[i] = current.m_front[i] += f;
+        before.m_front[i] = current.m_front[i] -= f;
         if (before.size() > 0) {
           m_fronts.push_front(std::move(before));
         }
       }
 
-      const auto b = margin.back()[i];
+      const auto b = box.m_back[i] - current.m_back[i];
       if (b > 0) {
         auto after = current;
         after.m_front[i] = current.m_back[i] + 1;
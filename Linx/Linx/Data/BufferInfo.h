@@ -0,0 +1,270 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXDATA_BUFFERINFO_H
+#define _LINXDATA_BUFFERINFO_H
+
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Data/Raster.h"
+
+#include <complex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @ingroup exceptions
+ * @brief Exception thrown when a buffer cannot be viewed as a raster.
+ */
+class BufferError : public Exception {
+public:
+
+  /**
+   * @brief Constructor.
+   */
+  BufferError(const std::string& message) : Exception("Buffer error", message) {}
+
+  /**
+   * @brief Throw if a condition is false.
+   */
+  static void may_throw(bool condition, const std::string& message)
+  {
+    if (not condition) {
+      throw BufferError(message);
+    }
+  }
+};
+
+/**
+ * @ingroup data_classes
+ * @brief Description of a strided memory buffer, as in the Python buffer protocol (PEP 3118).
+ *
+ * This is the common ground to share memory with foreign array libraries like NumPy, without copy:
+ * - `ptr_raster()` views a foreign buffer as a `PtrRaster`;
+ * - `buffer_info()` describes the memory of a `Raster` such that it can be viewed as a foreign array.
+ *
+ * Like NumPy's default layout, buffers are in C order, i.e. the last axis is the fastest varying one,
+ * while the first axis of a raster is the fastest varying one.
+ * Therefore, axes are reversed, e.g. a NumPy array of shape `(height, width)` is viewed as a raster of shape `{width, height}`.
+ *
+ * Shape and strides are given in buffer order, and strides are in bytes.
+ */
+struct BufferInfo {
+  /**
+   * @brief Pointer to the first element.
+   */
+  void* data = nullptr;
+
+  /**
+   * @brief The size of an element in bytes.
+   */
+  Index itemsize = 0;
+
+  /**
+   * @brief The element format, as in the `struct` Python module, e.g. `"f"` for `float`.
+   */
+  std::string format = "";
+
+  /**
+   * @brief The lengths along each axis, in buffer order.
+   */
+  std::vector<Index> shape = {};
+
+  /**
+   * @brief The strides along each axis, in bytes and buffer order.
+   */
+  std::vector<Index> strides = {};
+
+  /**
+   * @brief Whether the buffer is read-only.
+   */
+  bool readonly = false;
+
+  /**
+   * @brief Get the number of dimensions.
+   */
+  Index ndim() const
+  {
+    return shape.size();
+  }
+
+  /**
+   * @brief Get the number of elements.
+   */
+  Index size() const
+  {
+    Index out = 1;
+    for (auto s : shape) {
+      out *= s;
+    }
+    return out;
+  }
+
+  /**
+   * @brief Check whether the buffer is contiguous in C order.
+   */
+  bool is_contiguous() const
+  {
+    Index expected = itemsize;
+    for (auto i = ndim() - 1; i >= 0; --i) {
+      if (shape[i] > 1 && strides[i] != expected) {
+        return false;
+      }
+      expected *= shape[i];
+    }
+    return true;
+  }
+};
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Get the kind of a format, i.e. its last character for scalars, or `'Z'` for complex values.
+ *
+ * Byte order prefixes are skipped, and big-endian prefixes `'>'` and `'!'` are rejected.
+ */
+inline char format_kind(const std::string& format)
+{
+  std::size_t i = 0;
+  while (i < format.size() && std::string("@=<>!").find(format[i]) != std::string::npos) {
+    BufferError::may_throw(format[i] != '>' && format[i] != '!', "Big-endian buffers are not supported");
+    ++i;
+  }
+  BufferError::may_throw(i < format.size(), "Empty format");
+  return format[i];
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @relatesalso BufferInfo
+ * @brief Get the canonical format of a type.
+ */
+template <typename T>
+std::string buffer_format()
+{
+  using U = std::decay_t<T>;
+  if constexpr (std::is_same<U, bool>::value) {
+    return "?";
+  } else if constexpr (std::is_same<U, float>::value) {
+    return "f";
+  } else if constexpr (std::is_same<U, double>::value) {
+    return "d";
+  } else if constexpr (std::is_same<U, long double>::value) {
+    return "g";
+  } else if constexpr (std::is_same<U, std::complex<float>>::value) {
+    return "Zf";
+  } else if constexpr (std::is_same<U, std::complex<double>>::value) {
+    return "Zd";
+  } else if constexpr (std::is_integral<U>::value) {
+    constexpr const char* signed_formats = "bhiq";
+    constexpr const char* unsigned_formats = "BHIQ";
+    const auto index = sizeof(U) == 1 ? 0 : sizeof(U) == 2 ? 1 : sizeof(U) == 4 ? 2 : 3;
+    return std::string(1, std::is_signed<U>::value ? signed_formats[index] : unsigned_formats[index]);
+  } else {
+    static_assert(std::is_arithmetic<U>::value, "Unsupported buffer value type");
+  }
+}
+
+/**
+ * @relatesalso BufferInfo
+ * @brief Check whether a buffer format and item size match a given type.
+ *
+ * Integer formats are matched by signedness and size, such that e.g. both `"l"` and `"q"` match `std::int64_t`.
+ */
+template <typename T>
+bool is_buffer_compatible(const std::string& format, Index itemsize)
+{
+  using U = std::decay_t<T>;
+  if (itemsize != Index(sizeof(U))) {
+    return false;
+  }
+  const auto kind = Internal::format_kind(format);
+  if constexpr (std::is_same<U, bool>::value) {
+    return kind == '?';
+  } else if constexpr (std::is_floating_point<U>::value) {
+    return std::string("efdg").find(kind) != std::string::npos;
+  } else if constexpr (std::is_integral<U>::value && std::is_signed<U>::value) {
+    return std::string("bhilqn").find(kind) != std::string::npos;
+  } else if constexpr (std::is_integral<U>::value) {
+    return std::string("BHILQN").find(kind) != std::string::npos;
+  } else {
+    return kind == 'Z';
+  }
+}
+
+/**
+ * @relatesalso BufferInfo
+ * @brief View a buffer as a raster, without copy.
+ * @tparam T The value type, which must be const-qualified for read-only buffers
+ * @tparam N The dimension, or -1 to take the buffer dimension
+ *
+ * The buffer must be contiguous in C order, and its axes are reversed.
+ * The raster does not own the data, which must therefore outlive it.
+ */
+template <typename T, Index N = -1>
+PtrRaster<T, N> ptr_raster(const BufferInfo& info)
+{
+  BufferError::may_throw(info.data, "Null buffer");
+  BufferError::may_throw(
+      is_buffer_compatible<T>(info.format, info.itemsize),
+      "Incompatible format: " + info.format + " (" + std::to_string(info.itemsize) + " bytes), expected " +
+          buffer_format<T>() + " (" + std::to_string(sizeof(T)) + " bytes)");
+  BufferError::may_throw(std::is_const<T>::value || not info.readonly, "Read-only buffer viewed as mutable");
+  BufferError::may_throw(
+      N == -1 || info.ndim() == N,
+      "Dimension mismatch: " + std::to_string(info.ndim()) + ", expected " + std::to_string(N));
+  BufferError::may_throw(info.strides.size() == info.shape.size(), "Shape and strides sizes differ");
+  BufferError::may_throw(info.is_contiguous(), "Non-contiguous buffer");
+  Position<N> shape(info.ndim());
+  std::copy(info.shape.rbegin(), info.shape.rend(), shape.begin());
+  return PtrRaster<T, N>(shape, static_cast<T*>(info.data));
+}
+
+/**
+ * @relatesalso BufferInfo
+ * @brief Describe the memory of a raster as a buffer.
+ *
+ * The buffer is read-only if `T` is const-qualified.
+ * It does not own the data, which must therefore outlive it.
+ */
+template <typename T, Index N, typename THolder>
+BufferInfo buffer_info(Raster<T, N, THolder>& raster)
+{
+  BufferInfo out;
+  out.data = const_cast<std::decay_t<T>*>(raster.data());
+  out.itemsize = sizeof(T);
+  out.format = buffer_format<T>();
+  const auto dim = raster.dimension();
+  out.shape.resize(dim);
+  out.strides.resize(dim);
+  Index stride = sizeof(T);
+  for (Index i = 0; i < dim; ++i) {
+    out.shape[dim - 1 - i] = raster.length(i);
+    out.strides[dim - 1 - i] = stride;
+    stride *= raster.length(i);
+  }
+  out.readonly = std::is_const<T>::value;
+  return out;
+}
+
+/**
+ * @relatesalso BufferInfo
+ * @brief Describe the memory of a constant raster as a read-only buffer.
+ */
+template <typename T, Index N, typename THolder>
+BufferInfo buffer_info(const Raster<T, N, THolder>& raster)
+{
+  auto out = buffer_info(const_cast<Raster<T, N, THolder>&>(raster));
+  out.readonly = true;
+  return out;
+}
+
+} // namespace Linx
+
+#endif
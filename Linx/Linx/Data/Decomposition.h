@@ -0,0 +1,172 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXDATA_DECOMPOSITION_H
+#define _LINXDATA_DECOMPOSITION_H
+
+#include "Linx/Data/Box.h"
+
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @ingroup regions
+ * @brief Decomposition of a box domain into slabs with halos.
+ * @tparam N The dimension
+ *
+ * The domain is split along its last axis into as many parts as requested, of lengths which differ by at most one.
+ * Each part is grown by a margin -- typically the window of a filter -- and clipped to the domain, which gives its halo box.
+ * Because parts are slabs along the last axis, parts and halos are contiguous in row-major ordering,
+ * and so are the regions which have to be exchanged between parts to fill the halos.
+ *
+ * \code
+ * SlabDecomposition<2> decomposition(raster.domain(), Box<2>({-2, -2}, {2, 2}), 4);
+ * for (Index i = 0; i < decomposition.size(); ++i) {
+ *   auto local = Raster<float>(raster(decomposition.halo(i))); // Copy part and halo
+ *   ... // Process local(decomposition.part(i) - decomposition.halo(i).front())
+ * }
+ * \endcode
+ */
+template <Index N = 2>
+class SlabDecomposition {
+public:
+
+  /**
+   * @brief The dimension parameter.
+   */
+  static constexpr Index Dimension = N;
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Constructor.
+   * @param domain The domain to be decomposed
+   * @param margin The margin of the halos, e.g. the window of a filter
+   * @param count The number of parts
+   */
+  SlabDecomposition(Box<N> domain, Box<N> margin, Index count) :
+      m_domain(LINX_MOVE(domain)), m_margin(LINX_MOVE(margin)), m_parts(), m_halos()
+  {
+    const auto last = m_domain.dimension() - 1;
+    const auto length = m_domain.length(last);
+    m_parts.reserve(count);
+    m_halos.reserve(count);
+    for (Index i = 0; i < count; ++i) {
+      auto front = m_domain.front();
+      auto back = m_domain.back();
+      front[last] = m_domain.front()[last] + length * i / count;
+      back[last] = m_domain.front()[last] + length * (i + 1) / count - 1;
+      Box<N> part(front, back);
+      m_halos.push_back((part + m_margin) & m_domain);
+      m_parts.push_back(LINX_MOVE(part));
+    }
+  }
+
+  /// @group_properties
+
+  /**
+   * @brief Get the number of parts.
+   */
+  Index size() const
+  {
+    return m_parts.size();
+  }
+
+  /**
+   * @brief Get the decomposed domain.
+   */
+  const Box<N>& domain() const
+  {
+    return m_domain;
+  }
+
+  /**
+   * @brief Get the halo margin.
+   */
+  const Box<N>& margin() const
+  {
+    return m_margin;
+  }
+
+  /// @group_elements
+
+  /**
+   * @brief Get the part of given index.
+   */
+  const Box<N>& part(Index i) const
+  {
+    return m_parts[i];
+  }
+
+  /**
+   * @brief Get the halo box of given part index, i.e. the part grown by the margin and clipped to the domain.
+   */
+  const Box<N>& halo(Index i) const
+  {
+    return m_halos[i];
+  }
+
+  /**
+   * @brief Get the region of part `from` which lies in the halo of part `to`.
+   *
+   * This is the region which has to be sent by `from` to `to` to fill its halo.
+   * The returned box is empty (i.e. has a non-positive length along the last axis) if the parts do not interact,
+   * which is always the case if `from == to`.
+   */
+  Box<N> overlap(Index from, Index to) const
+  {
+    if (from == to) {
+      return empty();
+    }
+    return m_parts[from] & m_halos[to];
+  }
+
+  /**
+   * @brief Check whether a region returned by `overlap()` is empty.
+   */
+  static bool is_empty(const Box<N>& region)
+  {
+    return region.length(region.dimension() - 1) <= 0;
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief Make an empty box.
+   */
+  Box<N> empty() const
+  {
+    auto back = m_domain.front();
+    back[back.size() - 1] -= 1;
+    return Box<N>(m_domain.front(), back);
+  }
+
+  /**
+   * @brief The domain.
+   */
+  Box<N> m_domain;
+
+  /**
+   * @brief The margin.
+   */
+  Box<N> m_margin;
+
+  /**
+   * @brief The parts.
+   */
+  std::vector<Box<N>> m_parts;
+
+  /**
+   * @brief The halos.
+   */
+  std::vector<Box<N>> m_halos;
+};
+
+} // namespace Linx
+
+#endif
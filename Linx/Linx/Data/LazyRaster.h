@@ -0,0 +1,205 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXDATA_LAZYRASTER_H
+#define _LINXDATA_LAZYRASTER_H
+
+#include "Linx/Data/Raster.h"
+
+#include <type_traits>
+#include <utility>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace Linx {
+
+/**
+ * @ingroup data_classes
+ * @brief A raster whose values are computed on demand from a function of the position.
+ * @tparam T The value type
+ * @tparam N The dimension
+ * @tparam TFunc The function type, which takes a `const Position<N>&` and returns a `T`
+ *
+ * As opposed to a raster, no data is stored: values are generated chunk by chunk,
+ * where a chunk is a set of consecutive sections (e.g. rows of a 2D raster or planes of a 3D raster),
+ * such that rasters larger than memory can be generated and written in a stream.
+ *
+ * Chunks are generated row by row: the coordinates of the current row are computed once
+ * and only the coordinate along the first axis is incremented from one pixel to the next,
+ * such that no index computation nor position lookup happens in the inner loop.
+ * Rows are split between threads if OpenMP is enabled: the function must therefore be thread-safe.
+ *
+ * Lazy rasters satisfy the raster source requirements, i.e. they provide:
+ * - `Value` and `Dimension`,
+ * - `shape()`,
+ * - `generate(chunk, front)`, which fills a chunk whose first section has index `front`,
+ * - `chunk(front, back)`, which returns a newly allocated chunk.
+ *
+ * Sources can be filtered lazily with `lazy_filter()` and written to FITS files with `Fits::write_stream()`.
+ *
+ * \code
+ * auto scene = lazy_raster(Position<2> {100000, 100000}, [&](const auto& p) {
+ *   return background + gaussian(p[0] - x0, p[1] - y0);
+ * });
+ * Fits("scene.fits").write_stream(scene);
+ * \endcode
+ *
+ * @see `lazy_raster()`
+ */
+template <typename T, Index N, typename TFunc>
+class LazyRaster {
+public:
+
+  /**
+   * @brief The value type.
+   */
+  using Value = T;
+
+  /**
+   * @brief The dimension parameter.
+   */
+  static constexpr Index Dimension = N;
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Constructor.
+   * @param shape The raster shape
+   * @param func The generating function
+   */
+  LazyRaster(Position<N> shape, TFunc func) : m_shape(LINX_MOVE(shape)), m_func(LINX_MOVE(func)) {}
+
+  /// @group_properties
+
+  /**
+   * @brief Get the raster shape.
+   */
+  const Position<N>& shape() const
+  {
+    return m_shape;
+  }
+
+  /**
+   * @brief Get the raster domain.
+   */
+  Box<N> domain() const
+  {
+    return Box<N>::from_shape(m_shape);
+  }
+
+  /**
+   * @brief Get the number of pixels.
+   */
+  Index size() const
+  {
+    return shape_size(m_shape);
+  }
+
+  /**
+   * @brief Get the length along given axis.
+   */
+  Index length(Index i) const
+  {
+    return m_shape[i];
+  }
+
+  /// @group_elements
+
+  /**
+   * @brief Compute the value at given position.
+   */
+  T operator[](const Position<N>& position) const
+  {
+    return m_func(position);
+  }
+
+  /// @group_operations
+
+  /**
+   * @brief Generate the values of a chunk.
+   * @param out The output chunk, whose shape matches the raster shape except along the last axis
+   * @param front The index of the first section of the chunk along the last axis
+   */
+  template <typename THolder>
+  void generate(Raster<T, N, THolder>& out, Index front) const
+  {
+    const auto dim = out.dimension();
+    const auto width = out.length(0);
+    const auto row_count = width > 0 ? static_cast<Index>(out.size()) / width : 0;
+    const auto x_front = dim == 1 ? front : 0;
+    const auto x_end = x_front + width;
+    auto* data = out.data();
+
+#pragma omp parallel for
+    for (Index r = 0; r < row_count; ++r) {
+      auto p = Position<N>::zero(dim);
+      auto index = r;
+      for (Index i = 1; i < dim; ++i) {
+        p[i] = index % out.length(i);
+        index /= out.length(i);
+      }
+      if (dim > 1) {
+        p[dim - 1] += front;
+      }
+      auto* it = data + r * width;
+      for (p[0] = x_front; p[0] < x_end; ++p[0], ++it) {
+        *it = m_func(p);
+      }
+    }
+  }
+
+  /**
+   * @brief Generate a chunk between given indices along the last axis.
+   */
+  Raster<T, N> chunk(Index front, Index back) const
+  {
+    auto shape = m_shape;
+    shape[shape.size() - 1] = back - front + 1;
+    Raster<T, N> out(shape);
+    generate(out, front);
+    return out;
+  }
+
+  /**
+   * @brief Generate the whole raster.
+   */
+  Raster<T, N> raster() const
+  {
+    return chunk(0, m_shape[m_shape.size() - 1] - 1);
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief The raster shape.
+   */
+  Position<N> m_shape;
+
+  /**
+   * @brief The generating function.
+   */
+  TFunc m_func;
+};
+
+/**
+ * @relatesalso LazyRaster
+ * @brief Make a lazy raster from a function of the position.
+ *
+ * The value type is deduced from the return type of the function.
+ */
+template <Index N, typename TFunc>
+auto lazy_raster(Position<N> shape, TFunc&& func)
+{
+  using T = std::decay_t<std::invoke_result_t<const std::decay_t<TFunc>&, const Position<N>&>>;
+  return LazyRaster<T, N, std::decay_t<TFunc>>(LINX_MOVE(shape), LINX_FORWARD(func));
+}
+
+} // namespace Linx
+
+#endif
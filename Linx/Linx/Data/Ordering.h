@@ -0,0 +1,265 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXDATA_ORDERING_H
+#define _LINXDATA_ORDERING_H
+
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Sequence.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @ingroup regions
+ * @brief Row-major ordering of positions, i.e. the ordering of raster elements in memory.
+ */
+struct RowMajorOrder {
+  /**
+   * @brief Compute the sort key of a position inside a bounding box.
+   */
+  template <Index N>
+  static std::uint64_t key(const Position<N>& position, const Box<N>& bounds)
+  {
+    std::uint64_t out = 0;
+    for (auto i = bounds.dimension() - 1; i >= 0; --i) {
+      out = out * bounds.length(i) + (position[i] - bounds.front()[i]);
+    }
+    return out;
+  }
+};
+
+/**
+ * @ingroup regions
+ * @brief Morton ordering of positions, a.k.a. Z-order.
+ *
+ * The key of a position is obtained by interleaving the bits of its coordinates.
+ * Positions which are close in space tend to be close in the ordering, whatever the axis.
+ * At most `64 / N` bits per coordinate are taken into account.
+ */
+struct MortonOrder {
+  /**
+   * @brief Compute the sort key of a position inside a bounding box.
+   */
+  template <Index N>
+  static std::uint64_t key(const Position<N>& position, const Box<N>& bounds)
+  {
+    const auto dim = bounds.dimension();
+    const Index bits = 64 / dim;
+    std::uint64_t out = 0;
+    for (Index b = 0; b < bits; ++b) {
+      for (Index i = 0; i < dim; ++i) {
+        const std::uint64_t coordinate = position[i] - bounds.front()[i];
+        out |= ((coordinate >> b) & 1) << (b * dim + i);
+      }
+    }
+    return out;
+  }
+};
+
+/**
+ * @ingroup regions
+ * @brief Hilbert ordering of 2D positions.
+ *
+ * As opposed to the Morton curve, the Hilbert curve has no jumps,
+ * which results in a slightly better locality at a slightly higher cost.
+ */
+struct HilbertOrder {
+  /**
+   * @brief Compute the sort key of a position inside a bounding box.
+   */
+  static std::uint64_t key(const Position<2>& position, const Box<2>& bounds)
+  {
+    std::uint64_t side = 1;
+    while (side < std::uint64_t(std::max(bounds.length(0), bounds.length(1)))) {
+      side <<= 1;
+    }
+    std::uint64_t x = position[0] - bounds.front()[0];
+    std::uint64_t y = position[1] - bounds.front()[1];
+    std::uint64_t out = 0;
+    for (auto s = side >> 1; s > 0; s >>= 1) {
+      const std::uint64_t rx = (x & s) > 0;
+      const std::uint64_t ry = (y & s) > 0;
+      out += s * s * ((3 * rx) ^ ry);
+      if (ry == 0) { // Rotate quadrant
+        if (rx == 1) {
+          x = s - 1 - x;
+          y = s - 1 - y;
+        }
+        std::swap(x, y);
+      }
+    }
+    return out;
+  }
+};
+
+/**
+ * @ingroup regions
+ * @brief Get the bounding box of a range of positions.
+ */
+template <typename TRange>
+auto bounding_box(const TRange& positions)
+{
+  using TPosition = std::decay_t<decltype(*positions.begin())>;
+  auto it = positions.begin();
+  const auto end = positions.end();
+  if (it == end) {
+    return Box<TPosition::Dimension>();
+  }
+  auto front = *it;
+  auto back = *it;
+  for (++it; it != end; ++it) {
+    for (std::size_t i = 0; i < front.size(); ++i) {
+      front[i] = std::min(front[i], (*it)[i]);
+      back[i] = std::max(back[i], (*it)[i]);
+    }
+  }
+  return Box<TPosition::Dimension>(front, back);
+}
+
+/**
+ * @ingroup regions
+ * @brief Compute the permutation which sorts a range of positions according to a given ordering.
+ * @tparam TOrder The ordering, e.g. `MortonOrder`
+ *
+ * The `i`-th element of the output is the index in `positions` of the `i`-th position in the ordering.
+ */
+template <typename TOrder = MortonOrder, typename TRange>
+std::vector<Index> order_indices(const TRange& positions)
+{
+  const auto bounds = bounding_box(positions);
+  std::vector<std::pair<std::uint64_t, Index>> keys;
+  keys.reserve(std::distance(positions.begin(), positions.end()));
+  Index i = 0;
+  for (const auto& p : positions) {
+    keys.emplace_back(TOrder::key(p, bounds), i);
+    ++i;
+  }
+  std::sort(keys.begin(), keys.end());
+  std::vector<Index> out(keys.size());
+  std::transform(keys.begin(), keys.end(), out.begin(), [](const auto& k) {
+    return k.second;
+  });
+  return out;
+}
+
+/**
+ * @ingroup regions
+ * @brief Test whether a range of positions is sorted according to a given ordering.
+ *
+ * This is cheaper than `order_indices()`: keys are compared on the fly, without allocation nor sorting.
+ */
+template <typename TOrder = MortonOrder, typename TRange>
+bool is_ordered(const TRange& positions)
+{
+  const auto bounds = bounding_box(positions);
+  auto it = positions.begin();
+  const auto end = positions.end();
+  if (it == end) {
+    return true;
+  }
+  auto previous = TOrder::key(*it, bounds);
+  for (++it; it != end; ++it) {
+    const auto current = TOrder::key(*it, bounds);
+    if (current < previous) {
+      return false;
+    }
+    previous = current;
+  }
+  return true;
+}
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Test whether a range provides random access iterators.
+ */
+template <typename TRange>
+constexpr bool is_random_access()
+{
+  using TIterator = decltype(std::declval<const TRange&>().begin());
+  return std::is_base_of_v<std::random_access_iterator_tag, typename std::iterator_traits<TIterator>::iterator_category>;
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup regions
+ * @brief Copy a range of positions into a sequence sorted according to a given ordering.
+ *
+ * Sorting once is useful when the same positions are visited repeatedly with `ordered_map()`,
+ * e.g. when filtering a `Sequence` patch with several filters, since sorted ranges are not sorted again.
+ */
+template <typename TOrder = MortonOrder, typename TRange>
+auto sorted(const TRange& positions)
+{
+  using TPosition = std::decay_t<decltype(*positions.begin())>;
+  if constexpr (not Internal::is_random_access<TRange>()) { // Avoid quadratic std::next
+    return sorted<TOrder>(std::vector<TPosition>(positions.begin(), positions.end()));
+  } else {
+    const auto indices = order_indices<TOrder>(positions);
+    Sequence<TPosition> out(indices.size());
+    const auto begin = positions.begin();
+    std::transform(indices.begin(), indices.end(), out.begin(), [&](auto i) {
+      return begin[i];
+    });
+    return out;
+  }
+}
+
+/**
+ * @ingroup regions
+ * @brief Apply a function to each position of a range, in a given ordering.
+ * @tparam TOrder The ordering, e.g. `MortonOrder`
+ * @return The sequence of results, in the order of `positions`
+ *
+ * Positions are visited in the cache-friendly ordering and the results are scattered back to the input ordering.
+ * This is useful when `positions` is in some arbitrary order, e.g. that of a catalog,
+ * and `func` reads data in the neighborhood of the positions, e.g. to measure sources.
+ * If `positions` is already sorted, e.g. by `sorted()`, it is visited in place, without sorting.
+ *
+ * \code
+ * auto peaks = ordered_map(catalog, [&](const auto& p) {
+ *   const auto patch = raster(Box<2>(p - 2, p + 2));
+ *   return *std::max_element(patch.begin(), patch.end());
+ * });
+ * \endcode
+ */
+template <typename TOrder = MortonOrder, typename TRange, typename TFunc>
+auto ordered_map(const TRange& positions, TFunc&& func)
+{
+  using TPosition = std::decay_t<decltype(*positions.begin())>;
+  using Value = std::decay_t<decltype(func(*positions.begin()))>;
+  if constexpr (not Internal::is_random_access<TRange>()) { // Avoid quadratic std::next
+    return ordered_map<TOrder>(std::vector<TPosition>(positions.begin(), positions.end()), LINX_FORWARD(func));
+  } else {
+    const auto begin = positions.begin();
+    if (is_ordered<TOrder>(positions)) {
+      Sequence<Value> out(std::distance(begin, positions.end()));
+      auto it = out.begin();
+      for (const auto& p : positions) {
+        *it = func(p);
+        ++it;
+      }
+      return out;
+    }
+    const auto indices = order_indices<TOrder>(positions);
+    Sequence<Value> out(indices.size());
+    for (auto i : indices) {
+      out[i] = func(begin[i]);
+    }
+    return out;
+  }
+}
+
+} // namespace Linx
+
+#endif
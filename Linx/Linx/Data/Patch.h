@@ -99,7 +99,7 @@ public:
    */
   Box<Patch::Dimension> box() const
   {
-    return box(m_region);
+    return Linx::box(m_region);
   }
 
   /**
@@ -232,6 +232,7 @@ public:
   Patch& operator>>=(const Position<Patch::Dimension>& vector)
   {
     m_region += vector;
+    m_indexing.translate(*m_parent, vector, 1);
     return *this;
   }
 
@@ -241,6 +242,40 @@ public:
   Patch& operator<<=(const Position<Patch::Dimension>& vector)
   {
     m_region -= vector;
+    m_indexing.translate(*m_parent, vector, -1);
+    return *this;
+  }
+
+  /**
+   * @brief Fill the patch with a single value.
+   * 
+   * Box-based patches of rasters are filled row-wise, in parallel for large patches if OpenMP is enabled.
+   * @see `copy()`
+   */
+  Patch& fill(const T& value);
+
+  /**
+   * @brief Translate the patch along axis 0.
+   *
+   * This is equivalent to `patch >>= {offset, 0, ...}`, yet cheaper for raster parents:
+   * the index of the front pixel is incremented by the offset instead of being recomputed from the translated region.
+   * This is the method of choice to slide a window along a row, e.g. in filtering kernels:
+   *
+   * \code
+   * patch >>= row_front;
+   * for (Index x = 0; x < width; ++x, patch.slide()) {
+   *   *out_it++ = std::accumulate(patch.begin(), patch.end(), T());
+   * }
+   * patch.slide(-width);
+   * patch <<= row_front;
+   * \endcode
+   */
+  Patch& slide(Index offset = 1)
+  {
+    auto vector = Position<Patch::Dimension>::zero(box().dimension());
+    vector[0] = offset;
+    m_region += vector;
+    m_indexing.slide(offset);
     return *this;
   }
 
@@ -0,0 +1,491 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXDATA_PLANARRASTER_H
+#define _LINXDATA_PLANARRASTER_H
+
+#include "Linx/Data/Raster.h"
+
+#include <array>
+
+namespace Linx {
+
+/**
+ * @ingroup data_classes
+ * @brief Proxy to the channels of a pixel of a `PlanarRaster`.
+ * @tparam T The channel type, possibly const-qualified
+ * @tparam C The number of channels
+ *
+ * Channels are accessed with `operator[]()`, and the proxy is convertible to and from `std::array`.
+ */
+template <typename T, Index C>
+class PlanarPixel {
+public:
+
+  /**
+   * @brief The channel type.
+   */
+  using Value = std::decay_t<T>;
+
+  /**
+   * @brief The channels, by value.
+   */
+  using Channels = std::array<Value, C>;
+
+  /**
+   * @brief Constructor.
+   * @param data Pointer to the first channel
+   * @param stride The distance between two consecutive channels, i.e. the plane size
+   */
+  PlanarPixel(T* data, Index stride) : m_data(data), m_stride(stride) {}
+
+  /**
+   * @brief Assign the channels.
+   */
+  const PlanarPixel& operator=(const Channels& channels) const
+  {
+    for (Index c = 0; c < C; ++c) {
+      m_data[c * m_stride] = channels[c];
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Access the channel of given index.
+   */
+  T& operator[](Index c) const
+  {
+    return m_data[c * m_stride];
+  }
+
+  /**
+   * @brief Copy the channels.
+   */
+  Channels channels() const
+  {
+    Channels out;
+    for (Index c = 0; c < C; ++c) {
+      out[c] = m_data[c * m_stride];
+    }
+    return out;
+  }
+
+  /**
+   * @copybrief channels()
+   */
+  operator Channels() const
+  {
+    return channels();
+  }
+
+private:
+
+  /**
+   * @brief The pointer to the first channel.
+   */
+  T* m_data;
+
+  /**
+   * @brief The plane size.
+   */
+  Index m_stride;
+};
+
+/**
+ * @ingroup data_classes
+ * @brief Multi-channel raster with planar memory layout.
+ * @tparam T The channel type
+ * @tparam C The number of channels
+ * @tparam N The dimension of the planes, or -1 for variable dimension
+ *
+ * As opposed to a raster of structures (e.g. `Raster<Rgb>`), each channel is stored in its own contiguous plane.
+ * This structure-of-arrays layout makes per-channel operations -- e.g. band-wise filtering or arithmetics --
+ * work on contiguous data, which can be vectorized.
+ *
+ * The planes are stored consecutively in a raster of one more dimension, which can be accessed with `planes()`,
+ * while individual planes are accessed with `plane()`.
+ * Elements are accessed per pixel with `operator[]()`, which returns a `PlanarPixel` proxy.
+ *
+ * \code
+ * auto rgb = planar<3>(interleaved_rgb); // Raster<std::array<unsigned char, 3>> to PlanarRaster<unsigned char, 3>
+ * rgb.plane(0) *= 2; // Double red channel, vectorized
+ * rgb[{1, 2}] = {255, 0, 0}; // Set a pixel to red
+ * auto hsv = PlanarRaster<double, 3>(rgb.shape()).generate(rgb_to_hsv, rgb); // Per-pixel conversion
+ * auto blurred = map_planes(rgb, [&](const auto& plane) { // Band-wise filtering
+ *   return mean_filter<float>(Box<2>({-1, -1}, {1, 1})) * extrapolation(plane);
+ * });
+ * \endcode
+ *
+ * @see `planar()`, `interleaved()`, `map_planes()`, `planewise()`
+ */
+template <typename T, Index C, Index N = 2>
+class PlanarRaster {
+public:
+
+  /**
+   * @brief The channel type.
+   */
+  using Value = T;
+
+  /**
+   * @brief The channels of a pixel, by value.
+   */
+  using Channels = std::array<T, C>;
+
+  /**
+   * @brief The dimension parameter of the planes.
+   */
+  static constexpr Index Dimension = N;
+
+  /**
+   * @brief The number of channels.
+   */
+  static constexpr Index ChannelCount = C;
+
+  /**
+   * @brief The storage type, whose last axis indexes the channels.
+   */
+  using Planes = Raster<T, Dimensional<N>::OneMoreDimension>;
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Constructor.
+   */
+  explicit PlanarRaster(const Position<N>& shape = Position<N>::zero()) :
+      m_planes(append(shape, C))
+  {}
+
+  /**
+   * @brief Constructor from the planes.
+   */
+  explicit PlanarRaster(Planes planes) : m_planes(LINX_MOVE(planes))
+  {
+    const auto channel_count = m_planes.length(m_planes.dimension() - 1);
+    if (channel_count != C) {
+      throw SizeError(channel_count, C);
+    }
+  }
+
+  /// @group_properties
+
+  /**
+   * @brief Get the number of channels.
+   */
+  static constexpr Index channels()
+  {
+    return C;
+  }
+
+  /**
+   * @brief Get the number of dimensions of the planes.
+   */
+  Index dimension() const
+  {
+    return m_planes.dimension() - 1;
+  }
+
+  /**
+   * @brief Get the shape of the planes.
+   */
+  Position<N> shape() const
+  {
+    const auto n = dimension();
+    Position<N> out(n);
+    std::copy_n(m_planes.shape().begin(), n, out.begin());
+    return out;
+  }
+
+  /**
+   * @brief Get the domain of the planes.
+   */
+  Box<N> domain() const
+  {
+    return Box<N>::from_shape(shape());
+  }
+
+  /**
+   * @brief Get the number of pixels.
+   */
+  Index size() const
+  {
+    return m_planes.size() / C;
+  }
+
+  /// @group_elements
+
+  /**
+   * @brief Get the raster of planes.
+   *
+   * As opposed to planes, the raster of planes is itself contiguous,
+   * such that element-wise operations which apply to all channels alike are best performed on it,
+   * e.g. `raster.planes() *= 2`.
+   */
+  const Planes& planes() const
+  {
+    return m_planes;
+  }
+
+  /**
+   * @copybrief planes()const
+   */
+  Planes& planes()
+  {
+    return m_planes;
+  }
+
+  /**
+   * @brief Get the plane of given channel.
+   */
+  PtrRaster<const T, N> plane(Index c) const
+  {
+    return PtrRaster<const T, N>(shape(), m_planes.data() + c * size());
+  }
+
+  /**
+   * @copybrief plane()const
+   */
+  PtrRaster<T, N> plane(Index c)
+  {
+    return PtrRaster<T, N>(shape(), m_planes.data() + c * size());
+  }
+
+  /**
+   * @brief Access the pixel at given position.
+   */
+  PlanarPixel<const T, C> operator[](const Position<N>& position) const
+  {
+    return pixel(m_planes.index(append(position, 0)));
+  }
+
+  /**
+   * @copybrief operator[]()const
+   */
+  PlanarPixel<T, C> operator[](const Position<N>& position)
+  {
+    return pixel(m_planes.index(append(position, 0)));
+  }
+
+  /**
+   * @brief Access the pixel at given index.
+   */
+  PlanarPixel<const T, C> pixel(Index i) const
+  {
+    return PlanarPixel<const T, C>(m_planes.data() + i, size());
+  }
+
+  /**
+   * @copybrief pixel()const
+   */
+  PlanarPixel<T, C> pixel(Index i)
+  {
+    return PlanarPixel<T, C>(m_planes.data() + i, size());
+  }
+
+  /// @group_modifiers
+
+  /**
+   * @brief Fill all the pixels with given channels.
+   */
+  PlanarRaster& fill(const Channels& channels)
+  {
+    for (Index c = 0; c < C; ++c) {
+      plane(c).fill(channels[c]);
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Assign the channels of each pixel from a function of the channels of input planar rasters.
+   * @param func The generator function, which takes as many `std::array` as there are inputs and returns a `Channels`
+   * @param args The inputs, which must have the same shape as this
+   *
+   * Channels are loaded from and stored to the planes with unit stride,
+   * such that this is usually vectorizable even if `func` mixes channels, like color space conversions do.
+   */
+  template <typename TFunc, typename... TIns>
+  PlanarRaster& generate(TFunc&& func, const TIns&... args)
+  {
+    const auto s = size();
+    auto* data = m_planes.data();
+    for (Index i = 0; i < s; ++i) {
+      const Channels out = func(args.pixel(i).channels()...);
+      for (Index c = 0; c < C; ++c) {
+        data[c * s + i] = out[c];
+      }
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Apply a function of the channels to each pixel.
+   * @see `generate()`
+   */
+  template <typename TFunc, typename... TIns>
+  PlanarRaster& apply(TFunc&& func, const TIns&... args)
+  {
+    return generate(LINX_FORWARD(func), *this, args...);
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief Append the channel coordinate to a plane position.
+   */
+  static Position<Dimensional<N>::OneMoreDimension> append(const Position<N>& position, Index channel)
+  {
+    Position<Dimensional<N>::OneMoreDimension> out(position.size() + 1);
+    std::copy(position.begin(), position.end(), out.begin());
+    out[position.size()] = channel;
+    return out;
+  }
+
+  /**
+   * @brief The planes.
+   */
+  Planes m_planes;
+};
+
+/**
+ * @relatesalso PlanarRaster
+ * @brief Copy an interleaved raster into a planar raster.
+ * @tparam C The number of channels
+ * @param in The interleaved raster, whose values are subscriptable, e.g. `Raster<std::array<T, C>>`
+ */
+template <Index C, typename T, Index N, typename THolder>
+auto planar(const Raster<T, N, THolder>& in)
+{
+  using Value = std::decay_t<decltype(std::declval<const T&>()[0])>;
+  PlanarRaster<Value, C, N> out(in.shape());
+  auto* data = out.planes().data();
+  const auto s = out.size();
+  Index i = 0;
+  for (const auto& v : in) {
+    for (Index c = 0; c < C; ++c) {
+      data[c * s + i] = v[c];
+    }
+    ++i;
+  }
+  return out;
+}
+
+/**
+ * @relatesalso PlanarRaster
+ * @brief Copy an interleaved raster of any type into a planar raster.
+ * @param in The interleaved raster, e.g. `Raster<Rgb>`
+ * @param func The splitting function, which maps an input value to a `std::array`
+ *
+ * \code
+ * auto planar_rgb = planar(rgb, [](const Rgb& v) {
+ *   return std::array<unsigned char, 3> {v.r, v.g, v.b};
+ * });
+ * \endcode
+ */
+template <typename T, Index N, typename THolder, typename TFunc>
+auto planar(const Raster<T, N, THolder>& in, TFunc&& func)
+{
+  using Channels = decltype(func(*in.begin()));
+  using Value = typename Channels::value_type;
+  constexpr Index C = std::tuple_size<Channels>::value;
+  PlanarRaster<Value, C, N> out(in.shape());
+  auto* data = out.planes().data();
+  const auto s = out.size();
+  Index i = 0;
+  for (const auto& v : in) {
+    const Channels channels = func(v);
+    for (Index c = 0; c < C; ++c) {
+      data[c * s + i] = channels[c];
+    }
+    ++i;
+  }
+  return out;
+}
+
+/**
+ * @relatesalso PlanarRaster
+ * @brief Copy a planar raster into an interleaved raster of `std::array`.
+ */
+template <typename T, Index C, Index N>
+Raster<std::array<T, C>, N> interleaved(const PlanarRaster<T, C, N>& in)
+{
+  Raster<std::array<T, C>, N> out(in.shape());
+  Index i = 0;
+  for (auto& v : out) {
+    v = in.pixel(i).channels();
+    ++i;
+  }
+  return out;
+}
+
+/**
+ * @relatesalso PlanarRaster
+ * @brief Copy a planar raster into an interleaved raster of any type.
+ * @param func The merging function, which maps a `std::array` to an output value
+ */
+template <typename T, Index C, Index N, typename TFunc>
+auto interleaved(const PlanarRaster<T, C, N>& in, TFunc&& func)
+{
+  using Value = std::decay_t<decltype(func(std::declval<std::array<T, C>>()))>;
+  Raster<Value, N> out(in.shape());
+  Index i = 0;
+  for (auto& v : out) {
+    v = func(in.pixel(i).channels());
+    ++i;
+  }
+  return out;
+}
+
+/**
+ * @relatesalso PlanarRaster
+ * @brief Apply a function to each plane of a planar raster.
+ * @param func The function, which maps a `PtrRaster<const T, N>` to a raster
+ *
+ * The output planes are expected to be of equal shapes, e.g. when `func` is a filter application.
+ */
+template <typename T, Index C, Index N, typename TFunc>
+auto map_planes(const PlanarRaster<T, C, N>& in, TFunc&& func)
+{
+  auto first = func(in.plane(0));
+  using Value = std::decay_t<typename decltype(first)::Value>;
+  PlanarRaster<Value, C, N> out(first.shape());
+  out.plane(0).generate(
+      [](auto v) {
+        return v;
+      },
+      first);
+  for (Index c = 1; c < C; ++c) {
+    const auto plane = func(in.plane(c));
+    out.plane(c).generate(
+        [](auto v) {
+          return v;
+        },
+        plane);
+  }
+  return out;
+}
+
+/**
+ * @relatesalso PlanarRaster
+ * @brief Filter each plane of a planar raster.
+ *
+ * Like with a raster, the output is cropped to the inner domain of the filter.
+ *
+ * \code
+ * auto smoothed = planewise(mean_filter<float>(Box<2>({-1, -1}, {1, 1})), rgb);
+ * \endcode
+ */
+template <typename TFilter, typename T, Index C, Index N>
+auto planewise(const TFilter& filter, const PlanarRaster<T, C, N>& in)
+{
+  return map_planes(in, [&](const auto& plane) {
+    return filter * plane;
+  });
+}
+
+} // namespace Linx
+
+#endif
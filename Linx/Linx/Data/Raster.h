@@ -320,10 +320,10 @@ public:
   /**
    * @brief Patch-copy constructor.
    * @param patch The box- or grid-based patch to be copied (can be an extrapolator).
+   * @see `copy()`
    */
   template <typename U, typename TRaster, typename TRegion>
-  explicit Raster(const Patch<U, TRaster, TRegion>& patch) : Raster(patch.domain().shape(), patch)
-  {}
+  explicit Raster(const Patch<U, TRaster, TRegion>& patch);
 
   /// @group_properties
 
@@ -383,6 +383,15 @@ public:
     return m_shape[i];
   }
 
+  /// @group_modifiers
+
+  /**
+   * @brief Fill the raster with a single value.
+   * 
+   * Large rasters are filled in parallel if OpenMP is enabled.
+   */
+  Raster& fill(const T& value);
+
   /// @group_elements
 
   using Container::operator[];
@@ -735,9 +744,33 @@ Raster<T, N> random(const Position<N>& shape)
   return out;
 }
 
+/**
+ * @relatesalso Raster
+ * @brief Apply impulse noise to a raster, skipping unaffected pixels.
+ * @return The positions of the affected pixels
+ * @see `ImpulseNoise::sparse_apply()`
+ */
+template <typename T, Index N, typename THolder>
+Sequence<Position<N>> sparse_apply(Raster<T, N, THolder>& in, ImpulseNoise<std::decay_t<T>>& noise)
+{
+  const auto indices = noise.sparse_apply(in);
+  const auto& shape = in.shape();
+  Sequence<Position<N>> out(indices.size());
+  std::transform(indices.begin(), indices.end(), out.begin(), [&](Index index) {
+    Position<N> p(shape.size());
+    for (std::size_t i = 0; i < shape.size(); ++i) {
+      p[i] = index % shape[i];
+      index /= shape[i];
+    }
+    return p;
+  });
+  return out;
+}
+
 } // namespace Linx
 
 #include "Linx/Data/Patch.h"
 #include "Linx/Data/impl/Raster.hpp"
+#include "Linx/Data/impl/RasterCopy.h"
 
 #endif
@@ -52,6 +52,12 @@ public:
   {
     return begin<T>(parent, region) + region.size();
   }
+
+  template <typename TVector>
+  void translate(const TParent&, const TVector&, Index)
+  {}
+
+  void slide(Index) {}
 };
 
 /**
@@ -94,6 +100,18 @@ public:
   {
     return Iterator<T>(parent, region.end());
   }
+
+  /**
+   * @brief Translate the indexing, which is a no-op since positions are computed from the region.
+   */
+  template <typename TVector>
+  void translate(const TParent&, const TVector&, Index)
+  {}
+
+  /**
+   * @brief Translate the indexing along axis 0, which is a no-op.
+   */
+  void slide(Index) {}
 };
 
 /**
@@ -112,13 +130,14 @@ public:
   /**
    * @brief Default constructor.
    */
-  StrideBasedIndexing() : m_step(1), m_width(0), m_offsets(1) {}
+  StrideBasedIndexing() : m_step(1), m_width(0), m_offsets(1), m_front(0) {}
 
   /**
    * @brief Constructor for boxes.
    */
   StrideBasedIndexing(const TParent& parent, const Box<TParent::Dimension>& region) :
-      m_step(1), m_width(region.length(0)), m_offsets(region.size() / std::max(m_width, 1L) + 1)
+      m_step(1), m_width(region.length(0)), m_offsets(region.size() / std::max(m_width, 1L) + 1),
+      m_front(parent.index(region.front()))
   // max to prevent division by 0, +1 in order to dereference m_offsets.end() in iterator
   {
     if (region.size() <= 0) { // FIXME needed?
@@ -134,7 +153,8 @@ public:
    * @brief Constructor for grids.
    */
   StrideBasedIndexing(const TParent& parent, const Grid<TParent::Dimension>& region) :
-      m_step(region.step()[0]), m_width(region.length(0)), m_offsets(region.size() / std::max(m_width, 1L) + 1)
+      m_step(region.step()[0]), m_width(region.length(0)), m_offsets(region.size() / std::max(m_width, 1L) + 1),
+      m_front(parent.index(region.front()))
   // for max and +1 see above
   {
     if (region.size() <= 0) { // FIXME needed?
@@ -152,25 +172,42 @@ public:
   template <Index I>
   StrideBasedIndexing(const TParent& parent, const Line<I, TParent::Dimension>& region) :
       m_step(shape_stride<I>(parent.shape()) * region.step()), m_width(m_step * (region.size() - 1) + 1),
-      m_offsets(2, 0)
+      m_offsets(2, 0), m_front(parent.index(region.front()))
   {} // 1+1 see above
 
   /**
    * @brief Get an iterator to the beginning.
    */
   template <typename T>
-  Iterator<T> begin(TParent& raster, const TRegion& region) const
+  Iterator<T> begin(TParent& raster, const TRegion&) const
   {
-    return Iterator<T>(&raster[region.front()], m_step, m_width, m_offsets.data());
+    return Iterator<T>(raster.data() + m_front, m_step, m_width, m_offsets.data());
   }
 
   /**
    * @brief Get an iterator to the end.
    */
   template <typename T>
-  Iterator<T> end(TParent& raster, const TRegion& region) const
+  Iterator<T> end(TParent& raster, const TRegion&) const
+  {
+    return Iterator<T>(raster.data() + m_front, m_step, m_width, m_offsets.data() + m_offsets.size() - 1);
+  }
+
+  /**
+   * @brief Translate the indexing by a vector times a sign.
+   */
+  template <typename TVector>
+  void translate(const TParent& raster, const TVector& vector, Index sign)
+  {
+    m_front += sign * raster.index(vector);
+  }
+
+  /**
+   * @brief Translate the indexing along axis 0.
+   */
+  void slide(Index offset)
   {
-    return Iterator<T>(&raster[region.front()], m_step, m_width, m_offsets.data() + m_offsets.size() - 1);
+    m_front += offset;
   }
 
 private:
@@ -189,6 +226,11 @@ private:
    * @brief The offsets relative to the region front.
    */
   std::vector<Index> m_offsets;
+
+  /**
+   * @brief The index of the region front in the raster.
+   */
+  Index m_front;
 };
 
 /**
@@ -207,13 +249,14 @@ public:
   /**
    * @brief Default constructor.
    */
-  OffsetBasedIndexing() : m_offsets(1) {}
+  OffsetBasedIndexing() : m_offsets(1), m_front(0) {}
 
   /**
    * @brief Constructor.
    */
   OffsetBasedIndexing(const TParent& parent, const TRegion& region) :
-      m_offsets(region.size() + 1) // +1 in order to dereference m_offsets.end() in iterator
+      m_offsets(region.size() + 1), // +1 in order to dereference m_offsets.end() in iterator
+      m_front(parent.index(box(region).front()))
   {
     const auto front = box(region).front();
     std::transform(region.begin(), region.end(), m_offsets.begin(), [&](const auto& p) {
@@ -225,18 +268,35 @@ public:
    * @brief Get an iterator to the beginning.
    */
   template <typename T>
-  Iterator<T> begin(TParent& raster, const TRegion& region) const
+  Iterator<T> begin(TParent& raster, const TRegion&) const
   {
-    return Iterator<T>(&raster[box(region).front()], m_offsets.data());
+    return Iterator<T>(raster.data() + m_front, m_offsets.data());
   }
 
   /**
    * @brief Get an iterator to the end.
    */
   template <typename T>
-  Iterator<T> end(TParent& raster, const TRegion& region) const
+  Iterator<T> end(TParent& raster, const TRegion&) const
+  {
+    return Iterator<T>(raster.data() + m_front, m_offsets.data() + m_offsets.size() - 1);
+  }
+
+  /**
+   * @brief Translate the indexing by a vector times a sign.
+   */
+  template <typename TVector>
+  void translate(const TParent& raster, const TVector& vector, Index sign)
   {
-    return Iterator<T>(&raster[box(region).front()], m_offsets.data() + m_offsets.size() - 1);
+    m_front += sign * raster.index(vector);
+  }
+
+  /**
+   * @brief Translate the indexing along axis 0.
+   */
+  void slide(Index offset)
+  {
+    m_front += offset;
   }
 
 private:
@@ -245,6 +305,11 @@ private:
    * @brief The offsets relative to the front index.
    */
   std::vector<Index> m_offsets;
+
+  /**
+   * @brief The index of the region front in the raster.
+   */
+  Index m_front;
 };
 
 template <typename TParent, typename TRegion, bool IsContiguous = false>
@@ -0,0 +1,224 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXDATA_IMPL_RASTERCOPY_H
+#define _LINXDATA_IMPL_RASTERCOPY_H
+
+#include "Linx/Data/Raster.h"
+
+#include <algorithm>
+#include <type_traits>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace Linx {
+
+/// @cond INTERNAL
+namespace Internal {
+
+/**
+ * @brief The minimum number of elements for a copy or fill to be parallelized.
+ */
+constexpr Index ParallelCopySize = 1 << 18;
+
+/**
+ * @brief The maximum length of a contiguous run processed as a single task.
+ */
+constexpr Index CopyChunkLength = 1 << 16;
+
+/**
+ * @brief Check whether a class is a raster or a box-based patch of a raster,
+ * i.e. a strided box of contiguous rows.
+ */
+template <typename T>
+struct IsStridedBoxImpl : IsRasterImpl<T> {};
+
+template <typename T, typename TParent, Index N, bool IsContiguous>
+struct IsStridedBoxImpl<Patch<T, TParent, Box<N>, IsContiguous>> : IsRasterImpl<std::decay_t<TParent>> {};
+
+template <typename T>
+constexpr bool is_strided_box()
+{
+  return IsStridedBoxImpl<std::decay_t<T>>::value;
+}
+
+/**
+ * @brief A box of contiguous rows in a parent raster.
+ */
+template <typename T, Index N>
+struct StridedBox {
+  T* front; ///< The pointer to the front pixel
+  Position<N> parent; ///< The parent shape
+  Position<N> shape; ///< The box shape
+};
+
+/**
+ * @brief Get the strided box of a raster.
+ */
+template <typename TRaster, typename std::enable_if_t<is_raster<TRaster>()>* = nullptr>
+auto strided_box(TRaster& in)
+{
+  using Value = std::remove_pointer_t<decltype(in.data())>;
+  return StridedBox<Value, std::decay_t<TRaster>::Dimension> {in.data(), in.shape(), in.shape()};
+}
+
+/**
+ * @brief Get the strided box of a box-based patch of a raster.
+ */
+template <typename TPatch, typename std::enable_if_t<is_patch<TPatch>()>* = nullptr>
+auto strided_box(TPatch& in)
+{
+  auto& parent = in.parent();
+  using Value = std::remove_pointer_t<decltype(parent.data())>;
+  return StridedBox<Value, std::decay_t<TPatch>::Dimension> {
+      parent.data() + parent.index(in.domain().front()),
+      parent.shape(),
+      in.domain().shape()};
+}
+
+/**
+ * @brief Get the number of leading axes spanned by the contiguous runs of a box of given shape in a parent.
+ *
+ * Runs extend to the next axis as long as the box covers the whole parent along the current axis.
+ */
+template <Index N>
+Index run_axis_count(const Position<N>& parent, const Position<N>& shape)
+{
+  const Index dim = shape.size();
+  Index count = std::min<Index>(dim, 1);
+  while (count < dim && shape[count - 1] == parent[count - 1]) {
+    ++count;
+  }
+  return count;
+}
+
+/**
+ * @brief Decompose a box of a source and destination parents into common contiguous runs.
+ * @param shape The box shape
+ * @param in_parent The source parent shape
+ * @param out_parent The destination parent shape
+ * @param func The function to be called as `func(in_offset, out_offset, length)` for each run
+ *
+ * Runs are rows, or merged consecutive rows where the box covers whole parent rows, e.g. for full rasters.
+ * Long runs are split into chunks of at most `CopyChunkLength` elements.
+ * For large boxes, runs are processed in parallel if OpenMP is enabled.
+ */
+template <Index N, typename TFunc>
+void for_each_run(const Position<N>& shape, const Position<N>& in_parent, const Position<N>& out_parent, TFunc&& func)
+{
+  const auto size = shape_size(shape);
+  if (size <= 0) {
+    return;
+  }
+  const Index dim = shape.size();
+  const auto axis_count = std::min(run_axis_count(in_parent, shape), run_axis_count(out_parent, shape));
+  const auto length = shape_stride(shape, axis_count);
+  const auto run_count = size / length;
+  const auto chunk_count = (length + CopyChunkLength - 1) / CopyChunkLength;
+  const auto task_count = run_count * chunk_count;
+  auto in_strides = in_parent;
+  auto out_strides = out_parent;
+  for (Index i = 0; i < dim; ++i) {
+    in_strides[i] = shape_stride(in_parent, i);
+    out_strides[i] = shape_stride(out_parent, i);
+  }
+
+#pragma omp parallel for if (size >= ParallelCopySize && task_count > 1)
+  for (Index t = 0; t < task_count; ++t) {
+    auto run = t / chunk_count;
+    const auto begin = (t % chunk_count) * CopyChunkLength;
+    Index in_offset = begin;
+    Index out_offset = begin;
+    for (Index i = axis_count; i < dim; ++i) {
+      const auto coordinate = run % shape[i];
+      run /= shape[i];
+      in_offset += coordinate * in_strides[i];
+      out_offset += coordinate * out_strides[i];
+    }
+    func(in_offset, out_offset, std::min(CopyChunkLength, length - begin));
+  }
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @relatesalso Raster
+ * @brief Copy the values of a raster or patch into a raster or patch of the same size.
+ * @param in The source
+ * @param out The destination, e.g. a raster or a patch of a raster
+ *
+ * When both the source and destination are rasters or box-based patches of rasters with the same shape,
+ * they are decomposed into common contiguous runs (rows or merged rows, or the whole data for rasters),
+ * which are copied with `std::copy_n()`, i.e. with `memmove()` when the value types allow it.
+ * Large copies are split between threads if OpenMP is enabled.
+ * Otherwise, values are copied element-wise with iterators.
+ *
+ * This is the method of choice to crop, pad and stamp images:
+ *
+ * \code
+ * Raster<float> stamp(box.shape());
+ * copy(image(box), stamp); // Crop
+ * copy(stamp, image(box)); // Stamp
+ * \endcode
+ */
+template <typename TIn, typename TOut>
+void copy(const TIn& in, TOut&& out)
+{
+  if constexpr (Internal::is_strided_box<TIn>() && Internal::is_strided_box<TOut>()) {
+    if constexpr (std::decay_t<TIn>::Dimension == std::decay_t<TOut>::Dimension) {
+      const auto src = Internal::strided_box(in);
+      const auto dst = Internal::strided_box(out);
+      if (src.shape == dst.shape) {
+        Internal::for_each_run(src.shape, src.parent, dst.parent, [&](Index i, Index o, Index length) {
+          std::copy_n(src.front + i, length, dst.front + o);
+        });
+        return;
+      }
+    }
+  }
+  SizeError::may_throw(out.size(), in.size());
+  std::copy(in.begin(), in.end(), out.begin());
+}
+
+/// @cond
+
+template <typename T, Index N, typename THolder>
+template <typename U, typename TRaster, typename TRegion>
+Raster<T, N, THolder>::Raster(const Patch<U, TRaster, TRegion>& patch) : Raster(patch.domain().shape())
+{
+  Linx::copy(patch, *this);
+}
+
+template <typename T, Index N, typename THolder>
+Raster<T, N, THolder>& Raster<T, N, THolder>::fill(const T& value)
+{
+  auto* front = this->data();
+  Internal::for_each_run(m_shape, m_shape, m_shape, [&](Index i, Index, Index length) {
+    std::fill_n(front + i, length, value);
+  });
+  return *this;
+}
+
+template <typename T, typename TParent, typename TRegion, bool IsContiguous>
+Patch<T, TParent, TRegion, IsContiguous>& Patch<T, TParent, TRegion, IsContiguous>::fill(const T& value)
+{
+  if constexpr (Internal::is_strided_box<Patch>()) {
+    const auto dst = Internal::strided_box(*this);
+    Internal::for_each_run(dst.shape, dst.parent, dst.parent, [&](Index i, Index, Index length) {
+      std::fill_n(dst.front + i, length, value);
+    });
+  } else {
+    std::fill(begin(), end(), value);
+  }
+  return *this;
+}
+
+/// @endcond
+
+} // namespace Linx
+
+#endif
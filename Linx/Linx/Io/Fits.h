@@ -90,6 +90,59 @@ public:
       throw Error("Cannot read file", m_path, status);
     }
     fptr = nullptr;
+    instrument_traffic(out.size() * sizeof(typename TRaster::Value), 0);
+    return out;
+  }
+
+  /**
+   * @brief Read the shape of an image at given (0-based) HDU index, without reading the data.
+   */
+  template <Index N = 2>
+  Position<N> read_shape(Index hdu = 0)
+  {
+    int status = 0;
+    fitsfile* fptr = open_for_reading(hdu);
+    int naxis = 0;
+    fits_get_img_dim(fptr, &naxis, &status);
+    Position<N> shape(naxis);
+    fits_get_img_size(fptr, naxis, shape.data(), &status);
+    fits_close_file(fptr, &status);
+    if (status != 0) {
+      throw Error("Cannot read file", m_path, status);
+    }
+    return shape;
+  }
+
+  /**
+   * @brief Read a region of an image at given (0-based) HDU index.
+   *
+   * Only the region is read from the file, which makes it possible to process large images by pieces,
+   * e.g. one piece per process.
+   */
+  template <typename TRaster>
+  TRaster read_region(const Box<TRaster::Dimension>& region, Index hdu = 0)
+  {
+    int status = 0;
+    fitsfile* fptr = open_for_reading(hdu);
+    auto fpixel = region.front() + 1;
+    auto lpixel = region.back() + 1;
+    auto inc = Position<TRaster::Dimension>::one(region.dimension());
+    TRaster out(region.shape());
+    fits_read_subset(
+        fptr,
+        typecode<typename TRaster::Value>(),
+        fpixel.data(),
+        lpixel.data(),
+        inc.data(),
+        nullptr,
+        out.data(),
+        nullptr,
+        &status);
+    fits_close_file(fptr, &status);
+    if (status != 0) {
+      throw Error("Cannot read file", m_path, status);
+    }
+    instrument_traffic(out.size() * sizeof(typename TRaster::Value), 0);
     return out;
   }
 
@@ -102,38 +155,121 @@ public:
   void write(TRaster raster, char mode = 'x')
   {
     int status = 0;
-    fitsfile* fptr;
-    std::string path = "!"; // For overwriting
-    switch (mode) {
-      case 'x':
-        PathExistsError::may_throw(m_path);
-        fits_create_file(&fptr, m_path.c_str(), &status);
-        break;
-      case 'w':
-        path += m_path;
-        fits_create_file(&fptr, path.c_str(), &status);
-        break;
-      case 'a':
-        FileNotFoundError::may_throw(m_path);
-        fits_open_file(&fptr, m_path.c_str(), READWRITE, &status);
-        break;
-      default:
-        throw Exception("Unknown write mode", std::string(1, mode));
-    }
-    if (status != 0) {
-      throw FileFormatError("Cannot write file", m_path);
-    }
+    fitsfile* fptr = open_for_writing(mode);
     auto shape = raster.shape();
     fits_create_img(fptr, image_typecode<typename TRaster::Value>(), raster.dimension(), shape.data(), &status);
+    using T = std::decay_t<typename TRaster::Value>;
     if (raster.size() > 0) {
-      std::vector<std::decay_t<typename TRaster::Value>> nonconst(raster.begin(), raster.end());
-      fits_write_img(fptr, typecode<typename TRaster::Value>(), 1, raster.size(), nonconst.data(), &status);
+      if constexpr (is_raster<TRaster>()) { // Contiguous: CFITSIO does not modify the data
+        fits_write_img(fptr, typecode<T>(), 1, raster.size(), const_cast<T*>(raster.data()), &status);
+      } else {
+        std::vector<T> contiguous(raster.begin(), raster.end());
+        fits_write_img(fptr, typecode<T>(), 1, raster.size(), contiguous.data(), &status);
+      }
     }
     fits_close_file(fptr, &status);
     if (status != 0) {
       throw Error("Cannot write file", m_path, status);
     }
     fptr = nullptr;
+    instrument_traffic(0, raster.size() * sizeof(typename TRaster::Value));
+  }
+
+  /**
+   * @brief Create an image HDU of given shape, without writing the data.
+   * @param shape The image shape
+   * @param mode `x` to create a new file, `w` to create or overwrite, `a` to append an HDU
+   *
+   * @return The (0-based) index of the created HDU
+   *
+   * The data is initialized to zero by CFITSIO, and regions can then be written with `write_region()`.
+   */
+  template <typename T, Index N>
+  Index create(Position<N> shape, char mode = 'x')
+  {
+    int status = 0;
+    fitsfile* fptr = open_for_writing(mode);
+    fits_create_img(fptr, image_typecode<T>(), shape.size(), shape.data(), &status);
+    int hdu_num = 0;
+    fits_get_hdu_num(fptr, &hdu_num);
+    fits_close_file(fptr, &status);
+    if (status != 0) {
+      throw Error("Cannot write file", m_path, status);
+    }
+    return hdu_num - 1;
+  }
+
+  /**
+   * @brief Write a raster into a region of an existing image at given (0-based) HDU index.
+   * @param raster The raster to be written
+   * @param front The front position of the region in the image
+   *
+   * Writes are not synchronized: when several processes write the same file, they must do it in turn.
+   */
+  template <typename TRaster>
+  void write_region(const TRaster& raster, const Position<TRaster::Dimension>& front, Index hdu = 0)
+  {
+    int status = 0;
+    fitsfile* fptr = open_for_writing('a');
+    fits_movabs_hdu(fptr, hdu + 1, nullptr, &status);
+    auto fpixel = front + 1;
+    auto lpixel = front + raster.domain().shape();
+    using T = std::decay_t<typename TRaster::Value>;
+    if constexpr (is_raster<TRaster>()) { // Contiguous: CFITSIO does not modify the data despite the non-const pointer
+      auto* data = const_cast<T*>(raster.data());
+      fits_write_subset(fptr, typecode<T>(), fpixel.data(), lpixel.data(), data, &status);
+    } else {
+      std::vector<T> contiguous(raster.begin(), raster.end());
+      fits_write_subset(fptr, typecode<T>(), fpixel.data(), lpixel.data(), contiguous.data(), &status);
+    }
+    fits_close_file(fptr, &status);
+    if (status != 0) {
+      throw Error("Cannot write file", m_path, status);
+    }
+    instrument_traffic(0, raster.size() * sizeof(typename TRaster::Value));
+  }
+
+  /**
+   * @brief Write an image from a raster source as a new FITS file, chunk by chunk.
+   * @param source The raster source, e.g. a `LazyRaster` or `LazyFiltered`
+   * @param chunk_length The number of sections per chunk, or 0 to write chunks of about 4M pixels
+   * @param mode `x` to create a new file, `w` to create or overwrite, `a` to append an HDU
+   *
+   * Chunks are generated with `source.generate()` into a single buffer, and written while the file is kept open,
+   * such that images larger than memory can be written.
+   */
+  template <typename TSource>
+  void write_stream(const TSource& source, Index chunk_length = 0, char mode = 'x')
+  {
+    using T = std::decay_t<typename TSource::Value>;
+    int status = 0;
+    fitsfile* fptr = open_for_writing(mode);
+    auto shape = source.shape();
+    const auto dim = shape.size();
+    fits_create_img(fptr, image_typecode<T>(), dim, shape.data(), &status);
+    const auto size = shape_size(shape);
+    if (size > 0) {
+      const auto length = shape[dim - 1];
+      const auto section_size = size / length;
+      if (chunk_length <= 0) {
+        chunk_length = std::max<Index>(1, (1 << 22) / section_size);
+      }
+      Raster<T, TSource::Dimension> chunk;
+      for (Index front = 0; front < length && status == 0; front += chunk_length) {
+        auto chunk_shape = shape;
+        chunk_shape[dim - 1] = std::min(chunk_length, length - front);
+        if (chunk.shape() != chunk_shape) {
+          chunk = Raster<T, TSource::Dimension>(chunk_shape);
+        }
+        source.generate(chunk, front);
+        fits_write_img(fptr, typecode<T>(), front * section_size + 1, chunk.size(), chunk.data(), &status);
+      }
+    }
+    fits_close_file(fptr, &status);
+    if (status != 0) {
+      throw Error("Cannot write file", m_path, status);
+    }
+    instrument_traffic(0, size * sizeof(T));
   }
 
   /**
@@ -153,6 +289,57 @@ public:
 
 private:
 
+  /**
+   * @brief Open the file for reading and move to given (0-based) HDU index.
+   */
+  fitsfile* open_for_reading(Index hdu)
+  {
+    FileNotFoundError::may_throw(m_path);
+    int status = 0;
+    fitsfile* fptr;
+    fits_open_file(&fptr, m_path.c_str(), READONLY, &status);
+    if (status != 0) {
+      throw FileFormatError("Cannot read file", m_path);
+    }
+    fits_movabs_hdu(fptr, hdu + 1, nullptr, &status);
+    if (status != 0) {
+      fits_close_file(fptr, &status);
+      throw Error("Cannot read file", m_path, status);
+    }
+    return fptr;
+  }
+
+  /**
+   * @brief Open the file for writing according to some mode.
+   * @see `write()`
+   */
+  fitsfile* open_for_writing(char mode)
+  {
+    int status = 0;
+    fitsfile* fptr;
+    std::string path = "!"; // For overwriting
+    switch (mode) {
+      case 'x':
+        PathExistsError::may_throw(m_path);
+        fits_create_file(&fptr, m_path.c_str(), &status);
+        break;
+      case 'w':
+        path += m_path;
+        fits_create_file(&fptr, path.c_str(), &status);
+        break;
+      case 'a':
+        FileNotFoundError::may_throw(m_path);
+        fits_open_file(&fptr, m_path.c_str(), READWRITE, &status);
+        break;
+      default:
+        throw Exception("Unknown write mode", std::string(1, mode));
+    }
+    if (status != 0) {
+      throw FileFormatError("Cannot write file", m_path);
+    }
+    return fptr;
+  }
+
   /**
    * @brief Get CFITSIO's typecode.
    */
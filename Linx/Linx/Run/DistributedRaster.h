@@ -0,0 +1,601 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXRUN_DISTRIBUTEDRASTER_H
+#define _LINXRUN_DISTRIBUTEDRASTER_H
+
+#include "Linx/Data/BorderedBox.h"
+#include "Linx/Data/Decomposition.h"
+#include "Linx/Data/Raster.h"
+#include "Linx/Transforms/Extrapolation.h"
+
+#include <algorithm>
+#include <mpi.h>
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @ingroup data_classes
+ * @brief Raster distributed over the processes of an MPI communicator.
+ * @tparam T The value type
+ * @tparam N The dimension
+ *
+ * The domain is decomposed into slabs along the last axis with `SlabDecomposition`, one per process.
+ * Each process stores its part, surrounded by a halo of given margin, in a local raster.
+ * Halos are filled from the neighboring processes with `exchange()`,
+ * or asynchronously with `start_exchange()` and `finish_exchange()`.
+ *
+ * Pixelwise operations apply to the whole local raster, halos included, and therefore do not require an exchange.
+ * Filters are applied with `filter()`, which overlaps the halo exchange with the filtering of the inner part.
+ *
+ * \code
+ * const auto kernel = convolution(values);
+ * auto in = DistributedRaster<float>::read(fits, box(kernel.window())); // Each process reads its part and halo
+ * in.apply([](auto v) { return std::log(v); });
+ * auto out = in.filter<Nearest>(kernel);
+ * Fits out_fits("out.fits");
+ * out.write(out_fits, 'w'); // Processes write their part in turn
+ * \endcode
+ *
+ * The margin must contain the windows of the filters, and since the local raster is extrapolated at the domain boundaries,
+ * extrapolation methods which read values across the domain (i.e. `Periodic`) are not supported.
+ */
+template <typename T, Index N = 2>
+class DistributedRaster {
+public:
+
+  /**
+   * @brief The value type.
+   */
+  using Value = T;
+
+  /**
+   * @brief The dimension parameter.
+   */
+  static constexpr Index Dimension = N;
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Constructor.
+   * @param shape The global shape
+   * @param margin The halo margin, which must contain the windows of the filters to be applied
+   * @param comm The communicator
+   */
+  DistributedRaster(const Position<N>& shape, const Box<N>& margin, MPI_Comm comm = MPI_COMM_WORLD) :
+      m_comm(comm), m_rank(rank_of(comm)), m_decomposition(Box<N>::from_shape(shape), margin, size_of(comm)),
+      m_local(m_decomposition.halo(m_rank).shape()), m_requests(), m_slice_type(MPI_DATATYPE_NULL)
+  {}
+
+  /**
+   * @brief Destructor.
+   */
+  ~DistributedRaster()
+  {
+    if (m_slice_type != MPI_DATATYPE_NULL) {
+      finish_exchange();
+    }
+  }
+
+  /**
+   * @brief Copy constructor.
+   *
+   * Pending exchanges are completed before copying.
+   */
+  DistributedRaster(const DistributedRaster& other) :
+      m_comm(other.m_comm), m_rank(other.m_rank), m_decomposition(other.m_decomposition), m_local(),
+      m_requests(), m_slice_type(MPI_DATATYPE_NULL)
+  {
+    const_cast<DistributedRaster&>(other).finish_exchange();
+    m_local = other.m_local;
+  }
+
+  /**
+   * @brief Move constructor.
+   *
+   * Pending exchanges are completed before moving.
+   */
+  DistributedRaster(DistributedRaster&& other) :
+      m_comm(other.m_comm), m_rank(other.m_rank), m_decomposition(LINX_MOVE(other.m_decomposition)), m_local(),
+      m_requests(), m_slice_type(MPI_DATATYPE_NULL)
+  {
+    other.finish_exchange();
+    m_local = LINX_MOVE(other.m_local);
+  }
+
+  /**
+   * @brief Copy assignment.
+   */
+  DistributedRaster& operator=(const DistributedRaster& other)
+  {
+    if (this != &other) {
+      finish_exchange();
+      const_cast<DistributedRaster&>(other).finish_exchange();
+      m_comm = other.m_comm;
+      m_rank = other.m_rank;
+      m_decomposition = other.m_decomposition;
+      m_local = other.m_local;
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Move assignment.
+   */
+  DistributedRaster& operator=(DistributedRaster&& other)
+  {
+    if (this != &other) {
+      finish_exchange();
+      other.finish_exchange();
+      m_comm = other.m_comm;
+      m_rank = other.m_rank;
+      m_decomposition = LINX_MOVE(other.m_decomposition);
+      m_local = LINX_MOVE(other.m_local);
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Distribute a raster held by a root process.
+   *
+   * Halos are exchanged, such that the output is ready to be filtered.
+   */
+  template <typename TRaster>
+  static DistributedRaster
+  scatter(const TRaster& in, const Box<N>& margin, int root = 0, MPI_Comm comm = MPI_COMM_WORLD)
+  {
+    Position<N> shape = in.shape();
+    MPI_Bcast(shape.data(), shape.size(), MPI_LONG, root, comm);
+    DistributedRaster out(shape, margin, comm);
+    auto type = out.slice_type();
+    std::vector<int> counts;
+    std::vector<int> displacements;
+    out.slab_layout(counts, displacements);
+    MPI_Scatterv(
+        in.data(),
+        counts.data(),
+        displacements.data(),
+        type,
+        out.part_data(),
+        counts[out.m_rank],
+        type,
+        root,
+        comm);
+    MPI_Type_free(&type);
+    out.exchange();
+    return out;
+  }
+
+  /**
+   * @brief Read the part and halo of each process from an image file.
+   * @param file The file handler, e.g. `Fits`
+   *
+   * Every process reads its part and halo, such that no exchange is needed.
+   */
+  template <typename TFile>
+  static DistributedRaster read(TFile& file, const Box<N>& margin, Index hdu = 0, MPI_Comm comm = MPI_COMM_WORLD)
+  {
+    const auto shape = file.template read_shape<N>(hdu);
+    DistributedRaster out(shape, margin, comm);
+    out.m_local = file.template read_region<Raster<T, N>>(out.halo(), hdu);
+    return out;
+  }
+
+  /// @group_properties
+
+  /**
+   * @brief Get the communicator.
+   */
+  MPI_Comm communicator() const
+  {
+    return m_comm;
+  }
+
+  /**
+   * @brief Get the rank of the calling process.
+   */
+  int rank() const
+  {
+    return m_rank;
+  }
+
+  /**
+   * @brief Get the domain decomposition.
+   */
+  const SlabDecomposition<N>& decomposition() const
+  {
+    return m_decomposition;
+  }
+
+  /**
+   * @brief Get the global shape.
+   */
+  Position<N> shape() const
+  {
+    return m_decomposition.domain().shape();
+  }
+
+  /**
+   * @brief Get the global domain.
+   */
+  const Box<N>& domain() const
+  {
+    return m_decomposition.domain();
+  }
+
+  /**
+   * @brief Get the part of the domain which is owned by the calling process.
+   */
+  const Box<N>& part() const
+  {
+    return m_decomposition.part(m_rank);
+  }
+
+  /**
+   * @brief Get the part of the domain which is stored by the calling process, i.e. its part and halo.
+   */
+  const Box<N>& halo() const
+  {
+    return m_decomposition.halo(m_rank);
+  }
+
+  /// @group_elements
+
+  /**
+   * @brief Get the local raster, which covers `halo()`.
+   */
+  const Raster<T, N>& local() const
+  {
+    return m_local;
+  }
+
+  /**
+   * @copybrief local()const
+   */
+  Raster<T, N>& local()
+  {
+    return m_local;
+  }
+
+  /**
+   * @brief Get the part of the local raster which is owned by the calling process.
+   */
+  auto local_part() const
+  {
+    return m_local(part() - halo().front());
+  }
+
+  /**
+   * @copybrief local_part()const
+   */
+  auto local_part()
+  {
+    return m_local(part() - halo().front());
+  }
+
+  /**
+   * @brief Access the element at given global position, which must lie in `halo()`.
+   */
+  const T& operator[](const Position<N>& position) const
+  {
+    return m_local[position - halo().front()];
+  }
+
+  /**
+   * @copybrief operator[]()const
+   */
+  T& operator[](const Position<N>& position)
+  {
+    return m_local[position - halo().front()];
+  }
+
+  /// @group_modifiers
+
+  /**
+   * @brief Start exchanging the halos asynchronously.
+   *
+   * Until `finish_exchange()` is called, the halos must not be read, and the part must not be modified.
+   */
+  void start_exchange()
+  {
+    finish_exchange();
+    m_slice_type = slice_type();
+    const auto size = m_decomposition.size();
+    const auto& origin = halo().front();
+    for (int r = 0; r < size; ++r) {
+      const auto recv = m_decomposition.overlap(r, m_rank);
+      if (not m_decomposition.is_empty(recv)) {
+        m_requests.emplace_back();
+        MPI_Irecv(
+            &m_local[recv.front() - origin],
+            slice_count(recv),
+            m_slice_type,
+            r,
+            0,
+            m_comm,
+            &m_requests.back());
+      }
+      const auto send = m_decomposition.overlap(m_rank, r);
+      if (not m_decomposition.is_empty(send)) {
+        m_requests.emplace_back();
+        MPI_Isend(
+            &m_local[send.front() - origin],
+            slice_count(send),
+            m_slice_type,
+            r,
+            0,
+            m_comm,
+            &m_requests.back());
+      }
+    }
+  }
+
+  /**
+   * @brief Wait for the completion of the exchange started by `start_exchange()`, if any.
+   */
+  void finish_exchange()
+  {
+    if (m_slice_type == MPI_DATATYPE_NULL) {
+      return;
+    }
+    MPI_Waitall(m_requests.size(), m_requests.data(), MPI_STATUSES_IGNORE);
+    m_requests.clear();
+    MPI_Type_free(&m_slice_type);
+    m_slice_type = MPI_DATATYPE_NULL;
+  }
+
+  /**
+   * @brief Exchange the halos synchronously.
+   */
+  DistributedRaster& exchange()
+  {
+    start_exchange();
+    finish_exchange();
+    return *this;
+  }
+
+  /**
+   * @brief Assign the local elements, halos included, from a function of the local elements of other distributed rasters.
+   *
+   * The other distributed rasters must have the same decomposition.
+   * If their halos are up-to-date, then so are the halos of this raster.
+   */
+  template <typename TFunc, typename... TDistributed>
+  DistributedRaster& generate(TFunc&& func, const TDistributed&... args)
+  {
+    m_local.generate(LINX_FORWARD(func), args.local()...);
+    return *this;
+  }
+
+  /**
+   * @brief Apply a function to the local elements, halos included.
+   * @see `generate()`
+   */
+  template <typename TFunc, typename... TDistributed>
+  DistributedRaster& apply(TFunc&& func, const TDistributed&... args)
+  {
+    m_local.apply(LINX_FORWARD(func), args.local()...);
+    return *this;
+  }
+
+  /// @group_operations
+
+  /**
+   * @brief Apply a filter with given extrapolation method.
+   * @param filter The filter, whose window must be contained in the halo margin
+   * @param args The extrapolation arguments, if any
+   *
+   * The halo exchange is started, then the inner part of the local raster, which does not depend on the halos,
+   * is filtered while the exchange is in progress. The borders are filtered after the exchange is completed.
+   *
+   * The output has the same decomposition, and its halos are not filled: `exchange()` must be called if needed.
+   */
+  template <typename TMethod = Nearest, typename TFilter, typename... TArgs>
+  DistributedRaster<std::decay_t<typename TFilter::Value>, N> filter(const TFilter& filter, TArgs&&... args)
+  {
+    const auto window = box(filter.window());
+    if (not(window <= m_decomposition.margin())) {
+      throw Exception("Filter window exceeds the halo margin");
+    }
+    DistributedRaster<std::decay_t<typename TFilter::Value>, N> out(shape(), m_decomposition.margin(), m_comm);
+    const auto extrapolated = extrapolation<TMethod>(m_local, LINX_FORWARD(args)...);
+    const auto apply_to = [&](const Box<N>& region) {
+      Raster<std::decay_t<typename TFilter::Value>, N> filtered(region.shape());
+      filter.transform(extrapolated(region), filtered);
+      auto out_patch = out.m_local(region);
+      std::copy(filtered.begin(), filtered.end(), out_patch.begin());
+    };
+    const auto local_part = part() - halo().front();
+    const auto inner = local_part - window;
+    if (inner.size() <= 0 || SlabDecomposition<N>::is_empty(inner)) { // Thin part: nothing to overlap
+      exchange();
+      if (not SlabDecomposition<N>::is_empty(local_part)) {
+        apply_to(local_part);
+      }
+      return out;
+    }
+    const Internal::BorderedBox<N> bordered(local_part, window);
+    const auto ignore = [](const Box<N>&) {};
+    start_exchange();
+    bordered.apply_inner_border(apply_to, ignore);
+    finish_exchange();
+    bordered.apply_inner_border(ignore, apply_to);
+    return out;
+  }
+
+  /**
+   * @brief Gather the parts into a raster held by a root process.
+   *
+   * The output is empty in the other processes.
+   */
+  Raster<T, N> gather(int root = 0) const
+  {
+    Raster<T, N> out(m_rank == root ? shape() : Position<N>::zero(shape().size()));
+    auto type = slice_type();
+    std::vector<int> counts;
+    std::vector<int> displacements;
+    slab_layout(counts, displacements);
+    MPI_Gatherv(
+        part_data(),
+        counts[m_rank],
+        type,
+        out.data(),
+        counts.data(),
+        displacements.data(),
+        type,
+        root,
+        m_comm);
+    MPI_Type_free(&type);
+    return out;
+  }
+
+  /**
+   * @brief Write the parts into a new image HDU.
+   * @param file The file handler, e.g. `Fits`
+   * @param mode The file creation mode of the root process, e.g. `'w'`
+   * @return The (0-based) index of the created HDU
+   *
+   * The root process creates the HDU, and then the processes write their parts in turn.
+   */
+  template <typename TFile>
+  Index write(TFile& file, char mode = 'x', int root = 0) const
+  {
+    long hdu = 0;
+    if (m_rank == root) {
+      hdu = file.template create<T>(shape(), mode);
+    }
+    MPI_Bcast(&hdu, 1, MPI_LONG, root, m_comm);
+    const auto size = m_decomposition.size();
+    for (int r = 0; r < size; ++r) {
+      if (r == m_rank) {
+        file.write_region(local_part(), part().front(), hdu);
+      }
+      MPI_Barrier(m_comm);
+    }
+    return hdu;
+  }
+
+  /// @}
+
+private:
+
+  template <typename U, Index M>
+  friend class DistributedRaster;
+
+  /**
+   * @brief Get the rank of the calling process in a communicator.
+   */
+  static int rank_of(MPI_Comm comm)
+  {
+    int out = 0;
+    MPI_Comm_rank(comm, &out);
+    return out;
+  }
+
+  /**
+   * @brief Get the number of processes in a communicator.
+   */
+  static int size_of(MPI_Comm comm)
+  {
+    int out = 0;
+    MPI_Comm_size(comm, &out);
+    return out;
+  }
+
+  /**
+   * @brief Create and commit the datatype of a slice, i.e. a section orthogonal to the last axis.
+   *
+   * Transferring slices instead of bytes or values keeps counts small, even for huge rasters.
+   */
+  MPI_Datatype slice_type() const
+  {
+    const auto last = m_local.dimension() - 1;
+    Index slice_size = 1;
+    for (Index i = 0; i < last; ++i) {
+      slice_size *= domain().length(i);
+    }
+    MPI_Datatype out;
+    MPI_Type_contiguous(slice_size * sizeof(T), MPI_BYTE, &out);
+    MPI_Type_commit(&out);
+    return out;
+  }
+
+  /**
+   * @brief Get a pointer to the first element of the part in the local raster.
+   */
+  const T* part_data() const
+  {
+    const auto last = domain().dimension() - 1;
+    const auto offset = part().front()[last] - halo().front()[last];
+    return m_local.data() + offset * (m_local.size() / std::max<Index>(m_local.length(last), 1));
+  }
+
+  /**
+   * @copybrief part_data()const
+   */
+  T* part_data()
+  {
+    return const_cast<T*>(const_cast<const DistributedRaster&>(*this).part_data());
+  }
+
+  /**
+   * @brief Get the number of slices of a region.
+   */
+  static int slice_count(const Box<N>& region)
+  {
+    return region.length(region.dimension() - 1);
+  }
+
+  /**
+   * @brief Get the number of slices and offset of each part, for gather and scatter operations.
+   */
+  void slab_layout(std::vector<int>& counts, std::vector<int>& displacements) const
+  {
+    const auto size = m_decomposition.size();
+    const auto last = domain().dimension() - 1;
+    counts.resize(size);
+    displacements.resize(size);
+    for (Index r = 0; r < size; ++r) {
+      const auto& p = m_decomposition.part(r);
+      counts[r] = slice_count(p);
+      displacements[r] = p.front()[last] - domain().front()[last];
+    }
+  }
+
+  /**
+   * @brief The communicator.
+   */
+  MPI_Comm m_comm;
+
+  /**
+   * @brief The rank of the calling process.
+   */
+  int m_rank;
+
+  /**
+   * @brief The domain decomposition.
+   */
+  SlabDecomposition<N> m_decomposition;
+
+  /**
+   * @brief The local raster.
+   */
+  Raster<T, N> m_local;
+
+  /**
+   * @brief The pending requests.
+   */
+  std::vector<MPI_Request> m_requests;
+
+  /**
+   * @brief The slice datatype of the pending exchange, if any.
+   */
+  MPI_Datatype m_slice_type;
+};
+
+} // namespace Linx
+
+#endif
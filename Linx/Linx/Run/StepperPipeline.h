@@ -5,6 +5,7 @@
 #ifndef _LINXRUN_STEPPERPIPELINE_H
 #define _LINXRUN_STEPPERPIPELINE_H
 
+#include "Linx/Base/Instrumentation.h"
 #include "PipelineStep.h"
 
 #include <chrono>
@@ -21,6 +22,8 @@ namespace Linx {
  * The main method, `get<S>()`, returns the value of step `S`.
  * If not already done, the prerequisites of `S` are first triggered, recursively.
  * Run times of the steps are stored; They are accessed with `milliseconds()`.
+ * If instrumentation is enabled (see `Instrumentation`), memory statistics of the steps are stored, too;
+ * They are accessed with `memory()`.
  * 
  * This class relies on the CRTP, i.e. child classes should inherit this class with their name as template parameter, e.g.
  * \code
@@ -89,6 +92,23 @@ public:
     });
   }
 
+  /**
+   * @brief Get the memory statistics of step `S`.
+   * 
+   * Allocation counts, allocated bytes and traffic are those of the step only,
+   * while live bytes are those at the end of the step, and peak bytes are the peak live bytes during the step.
+   * If instrumentation is disabled or if the step was not evaluated, null statistics are returned.
+   */
+  template <typename S>
+  MemoryStats memory() const
+  {
+    const auto it = m_memory.find(key<S>());
+    if (it != m_memory.end()) {
+      return it->second;
+    }
+    return MemoryStats();
+  }
+
 protected:
 
   /**
@@ -97,6 +117,7 @@ protected:
   void reset()
   {
     m_milliseconds.clear();
+    m_memory.clear();
   }
 
 private:
@@ -143,10 +164,29 @@ private:
   typename S::Value evaluate_get()
   {
     if (not evaluated<S>()) { // FIXME not thread-safe
+      auto& instrumentation = Instrumentation::instance();
+      MemoryStats before;
+      std::size_t enclosing_peak = 0;
+      if constexpr (Instrumentation::enabled()) { // Locks a mutex
+        before = instrumentation.total();
+        enclosing_peak = instrumentation.local_peak();
+        instrumentation.reset_local_peak();
+      }
       const auto start = std::chrono::high_resolution_clock::now();
       Accessor<S>::evaluate(derived());
       const auto stop = std::chrono::high_resolution_clock::now();
       m_milliseconds[key<S>()] = std::chrono::duration<double, std::milli>(stop - start).count();
+      if constexpr (Instrumentation::enabled()) {
+        auto after = instrumentation.total();
+        after.allocations -= before.allocations;
+        after.deallocations -= before.deallocations;
+        after.allocated_bytes -= before.allocated_bytes;
+        after.peak_bytes = instrumentation.local_peak();
+        instrumentation.merge_local_peak(enclosing_peak); // In case S is nested in another step
+        after.read_bytes -= before.read_bytes;
+        after.written_bytes -= before.written_bytes;
+        m_memory[key<S>()] = after;
+      }
     }
     return Accessor<S>::get(derived());
   }
@@ -174,6 +214,11 @@ private:
    * @brief The set of performed steps and durations.
    */
   std::map<std::type_index, double> m_milliseconds;
+
+  /**
+   * @brief The memory statistics of the performed steps.
+   */
+  std::map<std::type_index, MemoryStats> m_memory;
 };
 
 } // namespace Linx
@@ -6,16 +6,83 @@
 #define _LINXTRANSFORMS_AFFINITY_H
 
 #include "Linx/Data/Raster.h"
+#include "Linx/Data/Tiling.h"
 #include "Linx/Data/Vector.h"
 #include "Linx/Transforms/Interpolation.h"
 
+#include <cmath>
 #include <eigen3/Eigen/Core>
 #include <eigen3/Eigen/LU> // inverse
+#include <type_traits>
+#include <vector>
 
 namespace Linx {
 
 /// @cond
 
+namespace Internal {
+
+/**
+ * @brief The 1D kernel which implements a constant shift with some interpolation method.
+ * 
+ * Specializations provide `weights(shift, front)`, which returns the weights of the taps
+ * `front`, `front + 1`... such that the value at `x + shift` is the weighted sum of the values at `x + front + k`.
+ * Methods without specialization are not separable and fall back to per-pixel interpolation.
+ */
+template <typename TMethod>
+struct ShiftKernel;
+
+template <>
+struct ShiftKernel<Nearest> {
+  static std::vector<double> weights(double shift, Index& front)
+  {
+    front = std::floor(shift + .5);
+    return {1};
+  }
+};
+
+template <>
+struct ShiftKernel<Linear> {
+  static std::vector<double> weights(double shift, Index& front)
+  {
+    front = std::floor(shift);
+    const auto d = shift - front;
+    if (d == 0) {
+      return {1};
+    }
+    return {1 - d, d};
+  }
+};
+
+template <>
+struct ShiftKernel<Cubic> {
+  static std::vector<double> weights(double shift, Index& front)
+  {
+    front = std::floor(shift);
+    const auto d = shift - front;
+    if (d == 0) {
+      return {1};
+    }
+    --front;
+    const auto d2 = d * d;
+    const auto d3 = d2 * d;
+    return {0.5 * (-d + 2 * d2 - d3), 1 + 0.5 * (-5 * d2 + 3 * d3), 0.5 * (d + 4 * d2 - 3 * d3), 0.5 * (-d2 + d3)};
+  }
+};
+
+/**
+ * @brief Check whether an interpolator can be shifted by a separable kernel.
+ */
+template <typename TIn, typename = void>
+struct IsShiftable : std::false_type {};
+
+template <typename TParent, typename TMethod>
+struct IsShiftable<
+    Interpolation<TParent, TMethod>,
+    std::void_t<decltype(ShiftKernel<TMethod>::weights(0., std::declval<Index&>()))>> : std::true_type {};
+
+} // namespace Internal
+
 // Forward declare for inverse
 template <Index N = 2>
 class Affinity;
@@ -33,7 +100,7 @@ Affinity<N> inverse(const Affinity<N>& in);
 template <typename TIn>
 Vector<double, TIn::Dimension> center(const TIn& in)
 {
-  const auto& domain = box(in.domain());
+  const auto domain = box(in.domain());
   Vector<double, TIn::Dimension> out(domain.front() + domain.back());
   out /= 2;
   return out;
@@ -288,6 +355,14 @@ public:
     return *this;
   }
 
+  /**
+   * @brief Check whether the affinity is a pure translation, i.e. whether the linear map is the identity.
+   */
+  bool is_translation() const
+  {
+    return m_map == EigenMatrix::Identity(m_map.rows(), m_map.cols());
+  }
+
   /**
    * @brief Apply the transform to an input vector.
    */
@@ -302,9 +377,9 @@ public:
    * @brief Apply the transform with a given interpolation method.
    */
   template <typename TInterpolation, typename TIn, typename... TArgs>
-  Raster<typename TIn::Value, TIn::Dimension> warp(const TIn& in, TArgs&&... args) const
+  Raster<std::decay_t<typename TIn::Value>, TIn::Dimension> warp(const TIn& in, TArgs&&... args) const
   {
-    Raster<typename TIn::Value, TIn::Dimension> out(in.shape());
+    Raster<std::decay_t<typename TIn::Value>, TIn::Dimension> out(in.shape());
     transform(interpolation<TInterpolation>(in, LINX_FORWARD(args)...), out);
     return out;
   }
@@ -315,11 +390,51 @@ public:
    * The domain of the output parameter (which can be a raster or a patch)
    * is used to decide which positions to take into account.
    * If positions outside the input domain are required, then `in` must be an extrapolator, too.
+   * 
+   * Pure translations with nearest-neighbor, linear or cubic interpolation over a box
+   * are performed as a separable correlation with precomputed 1D kernels,
+   * which is much faster than evaluating the interpolation formula at each pixel.
+   * 
+   * Otherwise, box domains are traversed tile by tile (see `TileSide`) in the plane of the first two axes,
+   * such that the input is read in a bounded neighborhood whatever the rotation angle.
+   * The input locality is further improved if `in` decorates a `BlockedRaster`.
    */
   template <typename TIn, typename TOut>
   TOut& transform(const TIn& in, TOut& out) const
   {
     const Affinity inv = Linx::inverse(*this);
+    if constexpr (std::is_same_v<std::decay_t<decltype(out.domain())>, Box<TIn::Dimension>>) {
+      if constexpr (Internal::IsShiftable<TIn>::value) {
+        if (is_translation()) {
+          return shift(in, out);
+        }
+      }
+      auto shape = Position<TIn::Dimension>::one(out.domain().dimension());
+      for (Index i = 0; i < std::min<Index>(2, shape.size()); ++i) {
+        shape[i] = TileSide;
+      }
+      for (auto&& tile : tiles(out, shape)) {
+        transform_region(inv, in, tile);
+      }
+      return out;
+    } else {
+      return transform_region(inv, in, out);
+    }
+  }
+
+  /**
+   * @brief The side of the tiles along the first two axes, for `transform()`.
+   */
+  static constexpr Index TileSide = 64;
+
+private:
+
+  /**
+   * @brief Apply an inverse transform to each position of the output domain.
+   */
+  template <typename TIn, typename TOut>
+  static TOut& transform_region(const Affinity& inv, const TIn& in, TOut& out)
+  {
     auto it = out.begin();
     for (const auto& p : out.domain()) {
       *it = in(inv(p));
@@ -328,7 +443,80 @@ public:
     return out;
   }
 
-private:
+  /**
+   * @brief Apply a pure translation as a separable correlation.
+   * 
+   * The input values are first copied with an integer offset into a working buffer,
+   * which is then correlated in place along each axis with the 1D kernel of the interpolation method.
+   * As the output value at index `j` only depends on the input values at indices `j` and above,
+   * the correlation can be performed in place without temporary line buffer.
+   */
+  template <typename TIn, typename TOut>
+  TOut& shift(const TIn& in, TOut& out) const
+  {
+    using Kernel = Internal::ShiftKernel<std::decay_t<decltype(in.method())>>;
+    const Box<TIn::Dimension> domain = out.domain();
+    const auto dim = domain.dimension();
+
+    // Precompute the 1D kernels and deduce the input box
+    std::vector<std::vector<double>> weights(dim);
+    auto front = domain.front();
+    auto back = domain.back();
+    for (Index i = 0; i < dim; ++i) {
+      Index offset;
+      weights[i] = Kernel::weights(-m_translation[i], offset);
+      front[i] += offset;
+      back[i] += offset + Index(weights[i].size()) - 1;
+    }
+
+    // Copy with integer offset
+    Raster<std::decay_t<typename TIn::Floating>, TIn::Dimension> buffer(Box<TIn::Dimension>(front, back).shape());
+    auto bit = buffer.begin();
+    for (const auto& p : Box<TIn::Dimension>(front, back)) {
+      *bit = in[p];
+      ++bit;
+    }
+
+    // Correlate in place along each axis
+    const auto& shape = buffer.shape();
+    auto* data = buffer.data();
+    Index stride = 1;
+    for (Index i = 0; i < dim; ++i) {
+      const auto& w = weights[i];
+      const Index size = w.size();
+      const auto length = shape[i];
+      const Index outer = buffer.size() / (stride * length);
+      const auto valid = length - size + 1;
+      if (size > 1) {
+        for (Index o = 0; o < outer; ++o) {
+          auto* line = data + o * stride * length;
+          for (Index j = 0; j < valid; ++j) {
+            auto* row = line + j * stride;
+            for (Index n = 0; n < stride; ++n) {
+              row[n] *= w[0];
+            }
+            for (Index k = 1; k < size; ++k) {
+              const auto* next = row + k * stride;
+              const auto wk = w[k];
+              for (Index n = 0; n < stride; ++n) {
+                row[n] += wk * next[n];
+              }
+            }
+          }
+        }
+      }
+      stride *= length;
+    }
+
+    // Crop
+    auto patch = out(domain);
+    auto it = patch.begin();
+    for (const auto& p : Box<TIn::Dimension>::from_shape(domain.shape())) {
+      *it = buffer[p];
+      ++it;
+    }
+    return out;
+  }
 
   /**
    * @brief Copy a vector into an `EigenVector`.
@@ -374,9 +562,9 @@ Affinity<N> inverse(const Affinity<N>& in)
  * @brief Translate some input data using a given interpolation method.
  */
 template <typename TInterpolation, typename TIn>
-Raster<typename TIn::Value, TIn::Dimension> translate(const TIn& in, const Vector<double, TIn::Dimension>& vector)
+Raster<std::decay_t<typename TIn::Value>, TIn::Dimension> translate(const TIn& in, const Vector<double, TIn::Dimension>& vector)
 {
-  return Affinity<TIn::Dimension>::translate(vector).template warp<TInterpolation>(in); // FIXME optimize
+  return Affinity<TIn::Dimension>::translation(vector).template warp<TInterpolation>(in);
 }
 
 /**
@@ -384,7 +572,7 @@ Raster<typename TIn::Value, TIn::Dimension> translate(const TIn& in, const Vecto
  * @brief Scale some input data from its center using a given interpolation method.
  */
 template <typename TInterpolation, typename TIn>
-Raster<typename TIn::Value, TIn::Dimension> scale(const TIn& in, double factor)
+Raster<std::decay_t<typename TIn::Value>, TIn::Dimension> scale(const TIn& in, double factor)
 {
   return Affinity<TIn::Dimension>::scaling(factor, center(in)).template warp<TInterpolation>(in); // FIXME optimize
 }
@@ -396,7 +584,7 @@ Raster<typename TIn::Value, TIn::Dimension> scale(const TIn& in, double factor)
  * @tparam M The number of sampling dimensions
  */
 template <typename TInterpolation, Index M = 2, typename TIn>
-Raster<typename TIn::Value, TIn::Dimension> upsample(const TIn& in, double factor)
+Raster<std::decay_t<typename TIn::Value>, TIn::Dimension> upsample(const TIn& in, double factor)
 {
   Vector<double, TIn::Dimension> factors(in.dimension());
   auto shape = in.shape();
@@ -407,7 +595,7 @@ Raster<typename TIn::Value, TIn::Dimension> upsample(const TIn& in, double facto
   for (Index i = M; i < in.dimension(); ++i) {
     factors[i] = 1;
   }
-  Raster<typename TIn::Value, TIn::Dimension> out(std::move(shape));
+  Raster<std::decay_t<typename TIn::Value>, TIn::Dimension> out(std::move(shape));
   const auto scaling = Affinity<TIn::Dimension>::scaling(std::move(factors));
   scaling.transform(interpolation<TInterpolation>(in), out);
   return out;
@@ -420,7 +608,7 @@ Raster<typename TIn::Value, TIn::Dimension> upsample(const TIn& in, double facto
  * @tparam M The number of sampling dimensions
  */
 template <typename TInterpolation, Index M = 2, typename TIn>
-Raster<typename TIn::Value, TIn::Dimension> downsample(const TIn& in, double factor)
+Raster<std::decay_t<typename TIn::Value>, TIn::Dimension> downsample(const TIn& in, double factor)
 {
   return upsample<TInterpolation, M>(in, 1. / factor);
 }
@@ -430,7 +618,7 @@ Raster<typename TIn::Value, TIn::Dimension> downsample(const TIn& in, double fac
  * @brief Rotate some input data around its center using a given interpolation method.
  */
 template <typename TInterpolation, typename TIn>
-Raster<typename TIn::Value, TIn::Dimension> rotate_rad(const TIn& in, double angle, Index from = 0, Index to = 1)
+Raster<std::decay_t<typename TIn::Value>, TIn::Dimension> rotate_rad(const TIn& in, double angle, Index from = 0, Index to = 1)
 {
   return Affinity<TIn::Dimension>::rotation_rad(angle, from, to, center(in)).template warp<TInterpolation>(in);
 }
@@ -440,7 +628,7 @@ Raster<typename TIn::Value, TIn::Dimension> rotate_rad(const TIn& in, double ang
  * @brief Rotate some input data around its center using a given interpolation method.
  */
 template <typename TInterpolation, typename TIn>
-Raster<typename TIn::Value, TIn::Dimension> rotate_deg(const TIn& in, double angle, Index from = 0, Index to = 1)
+Raster<std::decay_t<typename TIn::Value>, TIn::Dimension> rotate_deg(const TIn& in, double angle, Index from = 0, Index to = 1)
 {
   return Affinity<TIn::Dimension>::rotation_deg(angle, from, to, center(in)).template warp<TInterpolation>(in);
 }
@@ -0,0 +1,312 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_BACKGROUND_H
+#define _LINXTRANSFORMS_BACKGROUND_H
+
+#include "Linx/Data/Raster.h"
+
+#include <algorithm>
+#include <eigen3/Eigen/Cholesky> // ldlt
+#include <eigen3/Eigen/Core>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace Linx {
+
+/**
+ * @ingroup filtering
+ * @brief 2D polynomial background surface, fitted by least squares.
+ *
+ * The surface is the sum of the terms `a_ij u^i v^j` for `i + j <= degree`,
+ * where `u` and `v` are the pixel coordinates mapped to `[-1, 1]` over the fitted domain for conditioning.
+ *
+ * The fit accumulates the normal equations in a single pass over the raster, without design matrix:
+ * as `v` is constant along a row, each row only contributes the sums of the powers of `u` (times the value),
+ * which are then multiplied by the powers of `v`.
+ * The cost per pixel is therefore linear in the degree instead of quadratic in the number of terms.
+ * Rows are split between threads if OpenMP is enabled.
+ * The normal equations are then solved with Eigen's robust Cholesky decomposition.
+ *
+ * The surface is evaluated row by row, with Horner's scheme along `v` to get the 1D polynomial of the row,
+ * and then along `u` for each pixel.
+ *
+ * \code
+ * PolynomialBackground background(3);
+ * background.fit(image, valid); // valid is a Raster<bool> or a Mask<2>
+ * image -= background.raster<float>();
+ * \endcode
+ */
+class PolynomialBackground {
+public:
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Constructor.
+   * @param degree The polynomial degree
+   */
+  explicit PolynomialBackground(Index degree) :
+      m_degree(degree), m_shape(Position<2>::zero()), m_coefficients((degree + 1) * (degree + 1), 0.)
+  {}
+
+  /// @group_properties
+
+  /**
+   * @brief Get the polynomial degree.
+   */
+  Index degree() const
+  {
+    return m_degree;
+  }
+
+  /**
+   * @brief Get the number of terms.
+   */
+  Index term_count() const
+  {
+    return (m_degree + 1) * (m_degree + 2) / 2;
+  }
+
+  /**
+   * @brief Get the shape of the fitted domain.
+   */
+  const Position<2>& shape() const
+  {
+    return m_shape;
+  }
+
+  /**
+   * @brief Get the coefficient `a_ij` of the term `u^i v^j`.
+   */
+  double coefficient(Index i, Index j) const
+  {
+    return m_coefficients[j * (m_degree + 1) + i];
+  }
+
+  /// @group_modifiers
+
+  /**
+   * @brief Fit the surface to the non-NaN values of a raster.
+   */
+  template <typename T, typename THolder>
+  void fit(const Raster<T, 2, THolder>& in)
+  {
+    fit_impl(in, [](const auto&) {
+      return true;
+    });
+  }
+
+  /**
+   * @brief Fit the surface to the non-NaN values of a raster where a validity map is true.
+   * @param in The input raster
+   * @param validity A raster of Booleans or a `Mask` of the same domain
+   */
+  template <typename T, typename THolder, typename TValidity>
+  void fit(const Raster<T, 2, THolder>& in, const TValidity& validity)
+  {
+    fit_impl(in, [&](const auto& p) {
+      return bool(validity[p]);
+    });
+  }
+
+  /// @group_operations
+
+  /**
+   * @brief Evaluate the surface at a given position.
+   */
+  double operator()(double x, double y) const
+  {
+    const auto u = normalized(x, 0);
+    const auto v = normalized(y, 1);
+    const auto d = m_degree;
+    double out = 0;
+    for (Index i = d; i >= 0; --i) {
+      double c = 0;
+      for (Index j = d - i; j >= 0; --j) {
+        c = c * v + coefficient(i, j);
+      }
+      out = out * u + c;
+    }
+    return out;
+  }
+
+  /**
+   * @brief Evaluate the surface over a raster.
+   */
+  template <typename TOut>
+  TOut& evaluate(TOut& out) const
+  {
+    const auto d = m_degree;
+    const auto width = out.length(0);
+    const auto height = out.length(1);
+#pragma omp parallel
+    {
+      std::vector<double> row_coefficients(d + 1);
+#pragma omp for
+      for (Index y = 0; y < height; ++y) {
+        const auto v = normalized(y, 1);
+        for (Index i = 0; i <= d; ++i) {
+          double c = 0;
+          for (Index j = d - i; j >= 0; --j) {
+            c = c * v + coefficient(i, j);
+          }
+          row_coefficients[i] = c;
+        }
+        auto* it = &out[{0, y}];
+        for (Index x = 0; x < width; ++x, ++it) {
+          const auto u = normalized(x, 0);
+          double value = 0;
+          for (Index i = d; i >= 0; --i) {
+            value = value * u + row_coefficients[i];
+          }
+          *it = value;
+        }
+      }
+    }
+    return out;
+  }
+
+  /**
+   * @brief Evaluate the surface over the fitted domain.
+   */
+  template <typename T = double>
+  Raster<T> raster() const
+  {
+    Raster<T> out(m_shape);
+    evaluate(out);
+    return out;
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief Map a coordinate to `[-1, 1]` over the fitted domain.
+   */
+  double normalized(double coordinate, Index axis) const
+  {
+    const auto half = std::max<double>(m_shape[axis] - 1, 1) * .5;
+    return (coordinate - (m_shape[axis] - 1) * .5) / half;
+  }
+
+  /**
+   * @brief Accumulate and solve the normal equations.
+   */
+  template <typename TRaster, typename TValidFunc>
+  void fit_impl(const TRaster& in, TValidFunc&& is_valid)
+  {
+    m_shape = in.shape();
+    const auto d = m_degree;
+    const auto moment_count = 2 * d + 1;
+    const auto width = in.length(0);
+    const auto height = in.length(1);
+
+    // Moments sum(u^a v^b) and sum(u^a v^b z), indexed as [b * moment_count + a]
+    std::vector<double> moments(moment_count * moment_count, 0.);
+    std::vector<double> projections(moment_count * moment_count, 0.);
+
+#pragma omp parallel
+    {
+      std::vector<double> local_moments(moments.size(), 0.);
+      std::vector<double> local_projections(projections.size(), 0.);
+      std::vector<double> row_moments(moment_count);
+      std::vector<double> row_projections(d + 1);
+#pragma omp for
+      for (Index y = 0; y < height; ++y) {
+        std::fill(row_moments.begin(), row_moments.end(), 0.);
+        std::fill(row_projections.begin(), row_projections.end(), 0.);
+        for (Index x = 0; x < width; ++x) {
+          const Position<2> p {x, y};
+          const double z = in[p];
+          if (not(z == z) || not is_valid(p)) {
+            continue;
+          }
+          const auto u = normalized(x, 0);
+          double power = 1;
+          for (Index a = 0; a <= d; ++a, power *= u) {
+            row_moments[a] += power;
+            row_projections[a] += power * z;
+          }
+          for (Index a = d + 1; a < moment_count; ++a, power *= u) {
+            row_moments[a] += power;
+          }
+        }
+        const auto v = normalized(y, 1);
+        double power = 1;
+        for (Index b = 0; b < moment_count; ++b, power *= v) {
+          for (Index a = 0; a + b < moment_count; ++a) {
+            local_moments[b * moment_count + a] += row_moments[a] * power;
+          }
+          for (Index a = 0; a + b <= d; ++a) {
+            local_projections[b * moment_count + a] += row_projections[a] * power;
+          }
+        }
+      }
+#pragma omp critical
+      {
+        std::transform(moments.begin(), moments.end(), local_moments.begin(), moments.begin(), std::plus<double>());
+        std::transform(
+            projections.begin(),
+            projections.end(),
+            local_projections.begin(),
+            projections.begin(),
+            std::plus<double>());
+      }
+    }
+
+    // Normal equations
+    const auto count = term_count();
+    std::vector<std::pair<Index, Index>> terms;
+    terms.reserve(count);
+    for (Index j = 0; j <= d; ++j) {
+      for (Index i = 0; i + j <= d; ++i) {
+        terms.emplace_back(i, j);
+      }
+    }
+    Eigen::MatrixXd matrix(count, count);
+    Eigen::VectorXd vector(count);
+    for (Index k = 0; k < count; ++k) {
+      const auto [ik, jk] = terms[k];
+      for (Index l = 0; l < count; ++l) {
+        const auto [il, jl] = terms[l];
+        matrix(k, l) = moments[(jk + jl) * moment_count + ik + il];
+      }
+      vector(k) = projections[jk * moment_count + ik];
+    }
+    const Eigen::VectorXd solution = matrix.ldlt().solve(vector);
+
+    std::fill(m_coefficients.begin(), m_coefficients.end(), 0.);
+    for (Index k = 0; k < count; ++k) {
+      const auto [i, j] = terms[k];
+      m_coefficients[j * (d + 1) + i] = solution(k);
+    }
+  }
+
+  /**
+   * @brief The polynomial degree.
+   */
+  Index m_degree;
+
+  /**
+   * @brief The shape of the fitted domain.
+   */
+  Position<2> m_shape;
+
+  /**
+   * @brief The coefficients, indexed as `[j * (degree + 1) + i]`.
+   */
+  std::vector<double> m_coefficients;
+};
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,423 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_COADDITION_H
+#define _LINXTRANSFORMS_COADDITION_H
+
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Raster.h"
+#include "Linx/Transforms/Affinity.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @ingroup resampling
+ * @brief Streaming weighted co-addition of frames into a mosaic.
+ * @tparam T The value type
+ * @tparam N The dimension
+ * @tparam THolder The holder of the accumulators
+ *
+ * The co-addition holds the weighted sums of the values and the sums of the weights,
+ * into which frames are accumulated one by one.
+ * Each frame only writes into the bounding box of its footprint,
+ * such that no frame is ever allocated at the mosaic size:
+ * the memory is bounded by the size of the mosaic instead of the number of frames times the size of the mosaic.
+ *
+ * Frames are either given as patches already resampled over their footprint,
+ * or as interpolators which are warped on the fly with an affine transform,
+ * in which case only the footprint is traversed.
+ *
+ * The mosaic is split into tiles, each of which is protected by a mutex,
+ * such that frames can be added concurrently, e.g. from a parallel loop over the frames:
+ * threads only wait for each other when they write into the same tile at the same time.
+ *
+ * The accumulators can be owned by the co-addition, or be provided at construction,
+ * e.g. as `PtrRaster`s which point to memory-mapped files for mosaics larger than the memory.
+ *
+ * NaNs and pixels of null weight are ignored.
+ *
+ * \code
+ * Coaddition<float> mosaic({20000, 20000});
+ * #pragma omp parallel for
+ * for (std::size_t i = 0; i < frames.size(); ++i) {
+ *   const auto frame = read_frame(i);
+ *   mosaic.add(interpolation<Linear>(extrapolation(frame, nan)), transforms[i]);
+ * }
+ * auto coadd = mosaic.image();
+ * \endcode
+ *
+ * @see `Drizzle` for flux-conserving resampling
+ */
+template <typename T, Index N = 2, typename THolder = DefaultHolder<T>>
+class Coaddition {
+public:
+
+  /**
+   * @brief The value type.
+   */
+  using Value = T;
+
+  /**
+   * @brief The dimension parameter.
+   */
+  static constexpr Index Dimension = N;
+
+  /**
+   * @brief The default tile side.
+   */
+  static constexpr Index TileSide = 256;
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Constructor.
+   * @param shape The mosaic shape
+   * @param tile_shape The shape of the locked tiles
+   */
+  explicit Coaddition(const Position<N>& shape, const Position<N>& tile_shape = Position<N>::one() * TileSide) :
+      Coaddition(Raster<T, N, THolder>(shape), Raster<T, N, THolder>(shape), tile_shape)
+  {
+    reset();
+  }
+
+  /**
+   * @brief Accumulators-move constructor.
+   * @param sums The weighted sums of the values
+   * @param weights The sums of the weights, of same shape as `sums`
+   * @param tile_shape The shape of the locked tiles
+   *
+   * The accumulators are not reset, such that a co-addition can be resumed.
+   */
+  Coaddition(
+      Raster<T, N, THolder> sums,
+      Raster<T, N, THolder> weights,
+      const Position<N>& tile_shape = Position<N>::one() * TileSide) :
+      m_sums(std::move(sums)),
+      m_weights(std::move(weights)), m_tile_shape(tile_shape), m_grid_shape(m_sums.shape()), m_locks()
+  {
+    if (m_weights.shape() != m_sums.shape()) {
+      throw SizeError(m_weights.size(), m_sums.size());
+    }
+    const Index dim = m_grid_shape.size();
+    Index count = 1;
+    for (Index i = 0; i < dim; ++i) {
+      m_tile_shape[i] = std::min(m_tile_shape[i], m_grid_shape[i]);
+      m_grid_shape[i] = (m_grid_shape[i] + m_tile_shape[i] - 1) / m_tile_shape[i];
+      count *= m_grid_shape[i];
+    }
+    m_locks = std::vector<std::mutex>(count);
+  }
+
+  /// @group_properties
+
+  /**
+   * @brief Get the mosaic shape.
+   */
+  const Position<N>& shape() const
+  {
+    return m_sums.shape();
+  }
+
+  /**
+   * @brief Get the mosaic domain.
+   */
+  Box<N> domain() const
+  {
+    return m_sums.domain();
+  }
+
+  /**
+   * @brief Get the shape of the locked tiles.
+   */
+  const Position<N>& tile_shape() const
+  {
+    return m_tile_shape;
+  }
+
+  /**
+   * @brief Get the weighted sums of the values.
+   */
+  const Raster<T, N, THolder>& sums() const
+  {
+    return m_sums;
+  }
+
+  /**
+   * @brief Get the sums of the weights.
+   */
+  const Raster<T, N, THolder>& weights() const
+  {
+    return m_weights;
+  }
+
+  /**
+   * @brief Compute the bounding box of the footprint of a frame in the mosaic.
+   * @param frame The frame domain
+   * @param transform The transform from frame to mosaic coordinates
+   *
+   * Pixels are considered as squares centered on integer positions.
+   * The result is clipped to the mosaic domain, and may therefore be empty.
+   */
+  Box<N> footprint(const Box<N>& frame, const Affinity<N>& transform) const
+  {
+    const auto dim = frame.dimension();
+    Vector<double, N> front(dim);
+    Vector<double, N> back(dim);
+    std::fill(front.begin(), front.end(), std::numeric_limits<double>::max());
+    std::fill(back.begin(), back.end(), std::numeric_limits<double>::lowest());
+    Vector<double, N> corner(dim);
+    for (Index c = 0; c < (Index(1) << dim); ++c) {
+      for (Index i = 0; i < dim; ++i) {
+        corner[i] = (c >> i) & 1 ? frame.back()[i] + .5 : frame.front()[i] - .5;
+      }
+      const auto projected = transform(corner);
+      for (Index i = 0; i < dim; ++i) {
+        front[i] = std::min(front[i], projected[i]);
+        back[i] = std::max(back[i], projected[i]);
+      }
+    }
+    Position<N> f(dim);
+    Position<N> b(dim);
+    for (Index i = 0; i < dim; ++i) {
+      f[i] = std::floor(front[i] + .5);
+      b[i] = std::ceil(back[i] - .5);
+    }
+    return Box<N>(f, b) & domain();
+  }
+
+  /// @group_modifiers
+
+  /**
+   * @brief Add a frame resampled over its footprint, with uniform weights.
+   * @param in The resampled frame, whose shape is that of the footprint
+   * @param footprint The footprint in the mosaic, which may exceed the mosaic domain
+   */
+  template <typename TIn>
+  void add(const TIn& in, const Box<N>& footprint)
+  {
+    add_patch(in, footprint, [](const auto&) {
+      return T(1);
+    });
+  }
+
+  /**
+   * @brief Add a frame resampled over its footprint, with a weight map of same shape.
+   */
+  template <typename TIn, typename TWeights>
+  void add(const TIn& in, const TWeights& weights, const Box<N>& footprint)
+  {
+    add_patch(in, footprint, [&](const auto& p) {
+      return T(weights[p]);
+    });
+  }
+
+  /**
+   * @brief Warp a frame into the mosaic.
+   * @param in The frame interpolator
+   * @param transform The transform from frame to mosaic coordinates
+   * @param weight The weight of the frame, e.g. its inverse variance
+   *
+   * The mosaic pixels whose inverse transform lands in the frame pixels are accumulated,
+   * where pixels are considered as squares centered on integer positions.
+   * The interpolator should be decorating an extrapolator as soon as it reads neighbors,
+   * e.g. for linear interpolation, in which case a NaN constant discards incomplete neighborhoods.
+   */
+  template <typename TIn>
+  void add(const TIn& in, const Affinity<N>& transform, T weight = 1)
+  {
+    const auto frame = in.domain();
+    const auto box = footprint(frame, transform);
+    if (is_empty(box) || weight == 0) {
+      return;
+    }
+    const auto inv = inverse(transform);
+    const auto dim = box.dimension();
+    auto step = inv(unit(dim));
+    step -= inv(Position<N>::zero(dim));
+    for_each_tile(box, [&](const Box<N>& region) {
+      auto rows = region;
+      auto rows_back = rows.back();
+      rows_back[0] = rows.front()[0];
+      for (const auto& row : Box<N>(rows.front(), rows_back)) {
+        auto q = inv(row);
+        auto* sum = &m_sums[row];
+        auto* w = &m_weights[row];
+        for (Index x = region.front()[0]; x <= region.back()[0]; ++x, ++sum, ++w, q += step) {
+          if (contains(frame, q, dim)) {
+            const T v = in(q);
+            if (v == v) {
+              *sum += weight * v;
+              *w += weight;
+            }
+          }
+        }
+      }
+    });
+  }
+
+  /**
+   * @brief Reset the accumulators.
+   */
+  void reset()
+  {
+    m_sums.fill(0);
+    m_weights.fill(0);
+  }
+
+  /// @group_operations
+
+  /**
+   * @brief Compute the co-added image, i.e. the weighted mean of the frames.
+   * @param fill The value of the pixels without contribution
+   */
+  Raster<T, N> image(T fill = 0) const
+  {
+    Raster<T, N> out(shape());
+    out.generate(
+        [=](auto v, auto w) {
+          return w > 0 ? v / w : fill;
+        },
+        m_sums,
+        m_weights);
+    return out;
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief Get the first unit vector.
+   */
+  static Position<N> unit(Index dimension)
+  {
+    auto out = Position<N>::zero(dimension);
+    out[0] = 1;
+    return out;
+  }
+
+  /**
+   * @brief Check whether a box is empty.
+   */
+  static bool is_empty(const Box<N>& box)
+  {
+    for (Index i = 0; i < box.dimension(); ++i) {
+      if (box.length(i) <= 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Check whether a position lies in the pixels of a box.
+   */
+  static bool contains(const Box<N>& box, const Vector<double, N>& position, Index dimension)
+  {
+    for (Index i = 0; i < dimension; ++i) {
+      if (not(position[i] >= box.front()[i] - .5 && position[i] < box.back()[i] + .5)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Apply a function to the intersection of a box with each tile, while holding the tile lock.
+   *
+   * Locks are acquired one at a time, such that no deadlock can occur.
+   */
+  template <typename TFunc>
+  void for_each_tile(const Box<N>& box, TFunc&& func)
+  {
+    const auto dim = box.dimension();
+    Position<N> front(dim);
+    Position<N> back(dim);
+    for (Index i = 0; i < dim; ++i) {
+      front[i] = box.front()[i] / m_tile_shape[i];
+      back[i] = box.back()[i] / m_tile_shape[i];
+    }
+    for (const auto& t : Box<N>(front, back)) {
+      Index index = 0;
+      for (Index i = dim - 1; i >= 0; --i) {
+        index = index * m_grid_shape[i] + t[i];
+      }
+      auto tile_front = t;
+      for (Index i = 0; i < dim; ++i) {
+        tile_front[i] *= m_tile_shape[i];
+      }
+      const auto tile = Box<N>::from_shape(tile_front, m_tile_shape) & box;
+      std::lock_guard<std::mutex> lock(m_locks[index]);
+      func(tile);
+    }
+  }
+
+  /**
+   * @brief Add a patch over a footprint.
+   */
+  template <typename TIn, typename TWeightFunc>
+  void add_patch(const TIn& in, const Box<N>& footprint, TWeightFunc&& weight)
+  {
+    if (in.shape() != footprint.shape()) {
+      throw SizeError(in.size(), footprint.size());
+    }
+    const auto box = footprint & domain();
+    if (is_empty(box)) {
+      return;
+    }
+    for_each_tile(box, [&](const Box<N>& region) {
+      auto rows_back = region.back();
+      rows_back[0] = region.front()[0];
+      for (const auto& row : Box<N>(region.front(), rows_back)) {
+        auto p = row - footprint.front();
+        auto* sum = &m_sums[row];
+        auto* w = &m_weights[row];
+        for (Index x = region.front()[0]; x <= region.back()[0]; ++x, ++sum, ++w, ++p[0]) {
+          const T v = in[p];
+          const auto wp = weight(p);
+          if (v == v && wp != 0) {
+            *sum += wp * v;
+            *w += wp;
+          }
+        }
+      }
+    });
+  }
+
+  /**
+   * @brief The weighted sums of the values.
+   */
+  Raster<T, N, THolder> m_sums;
+
+  /**
+   * @brief The sums of the weights.
+   */
+  Raster<T, N, THolder> m_weights;
+
+  /**
+   * @brief The shape of the tiles.
+   */
+  Position<N> m_tile_shape;
+
+  /**
+   * @brief The number of tiles along each axis.
+   */
+  Position<N> m_grid_shape;
+
+  /**
+   * @brief The tile locks.
+   */
+  std::vector<std::mutex> m_locks;
+};
+
+} // namespace Linx
+
+#endif
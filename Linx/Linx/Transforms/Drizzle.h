@@ -0,0 +1,363 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_DRIZZLE_H
+#define _LINXTRANSFORMS_DRIZZLE_H
+
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Raster.h"
+#include "Linx/Transforms/Affinity.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief A convex polygon with at most 8 vertices, enough for a quadrilateral clipped by a square.
+ */
+struct DropPolygon {
+  std::array<double, 16> coords; ///< The interleaved vertex coordinates
+  Index size = 0; ///< The number of vertices
+
+  void push(double x, double y)
+  {
+    coords[2 * size] = x;
+    coords[2 * size + 1] = y;
+    ++size;
+  }
+
+  /**
+   * @brief Compute the area with the shoelace formula.
+   */
+  double area() const
+  {
+    double twice = 0;
+    for (Index i = 0, j = size - 1; i < size; j = i++) {
+      twice += coords[2 * j] * coords[2 * i + 1] - coords[2 * i] * coords[2 * j + 1];
+    }
+    return std::abs(twice) * .5;
+  }
+
+  /**
+   * @brief Clip with the half-plane `sign * (coord[axis] - bound) <= 0`.
+   */
+  DropPolygon clip(Index axis, double bound, double sign) const
+  {
+    DropPolygon out;
+    for (Index i = 0, j = size - 1; i < size; j = i++) {
+      const auto di = sign * (coords[2 * i + axis] - bound);
+      const auto dj = sign * (coords[2 * j + axis] - bound);
+      if ((di <= 0) != (dj <= 0)) {
+        const auto t = dj / (dj - di);
+        out.push(
+            coords[2 * j] + t * (coords[2 * i] - coords[2 * j]),
+            coords[2 * j + 1] + t * (coords[2 * i + 1] - coords[2 * j + 1]));
+      }
+      if (di <= 0) {
+        out.push(coords[2 * i], coords[2 * i + 1]);
+      }
+    }
+    return out;
+  }
+
+  /**
+   * @brief Compute the area of the intersection with the square `[x0, x0 + 1] x [y0, y0 + 1]`.
+   */
+  double overlap(double x0, double y0) const
+  {
+    return clip(0, x0, -1).clip(0, x0 + 1, 1).clip(1, y0, -1).clip(1, y0 + 1, 1).area();
+  }
+};
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup resampling
+ * @brief Flux-conserving area-weighted resampler, a.k.a. drizzle.
+ * @tparam T The value type
+ *
+ * Input pixels are shrunk into square drops, whose side is `pixfrac` times the input pixel side,
+ * and drops are projected onto the output grid with an affine transform.
+ * Each output pixel accumulates the values of the drops weighted by the overlap areas (and optional input weights),
+ * as well as the sum of the weights.
+ * Overlaps are computed exactly by clipping the projected drops (which are parallelograms) with the output pixels.
+ *
+ * Input values are fluxes per pixel, which are converted to fluxes per output pixel,
+ * such that the total flux is conserved.
+ * The resampler can be fed with many input frames, e.g. dithered exposures,
+ * before the co-added image is normalized with `image()`.
+ *
+ * Pixel centers are at integer coordinates, i.e. pixel `p` covers `[p - 1/2, p + 1/2]` along each axis.
+ * NaNs and pixels of null weight are ignored.
+ *
+ * The output is split into tiles, which are processed in parallel if OpenMP is enabled.
+ * For each tile, only the input pixels whose drops may overlap the tile are visited,
+ * and each thread accumulates directly into its own tiles, such that no lock nor frame-size buffer is needed,
+ * whatever the rotation.
+ *
+ * \code
+ * Drizzle<float> drizzle({4096, 4096}, .8);
+ * for (const auto& [frame, transform] : exposures) {
+ *   drizzle.add(frame, transform);
+ * }
+ * auto coadd = drizzle.image();
+ * \endcode
+ */
+template <typename T>
+class Drizzle {
+public:
+
+  /**
+   * @brief The value type.
+   */
+  using Value = T;
+
+  /**
+   * @brief The side of the output tiles which are processed in parallel.
+   */
+  static constexpr Index TileSide = 256;
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Constructor.
+   * @param shape The output shape
+   * @param pixfrac The ratio between the drop side and the input pixel side, in `(0, 1]`
+   */
+  explicit Drizzle(const Position<2>& shape, double pixfrac = 1) :
+      m_pixfrac(pixfrac), m_values(shape), m_weights(shape)
+  {
+    m_values.fill(0);
+    m_weights.fill(0);
+  }
+
+  /// @group_properties
+
+  /**
+   * @brief Get the output shape.
+   */
+  const Position<2>& shape() const
+  {
+    return m_values.shape();
+  }
+
+  /**
+   * @brief Get the drop size ratio.
+   */
+  double pixfrac() const
+  {
+    return m_pixfrac;
+  }
+
+  /**
+   * @brief Get the accumulated weights.
+   */
+  const Raster<T>& weights() const
+  {
+    return m_weights;
+  }
+
+  /// @group_modifiers
+
+  /**
+   * @brief Add an input frame with uniform weights.
+   * @param in The input frame
+   * @param transform The transform from input to output coordinates
+   */
+  template <typename TIn>
+  void add(const TIn& in, const Affinity<2>& transform)
+  {
+    add_impl(in, transform, [](const auto&) {
+      return T(1);
+    });
+  }
+
+  /**
+   * @brief Add an input frame with a weight map, e.g. inverse variances or a bad pixel map.
+   */
+  template <typename TIn, typename TWeights>
+  void add(const TIn& in, const Affinity<2>& transform, const TWeights& weights)
+  {
+    add_impl(in, transform, [&](const auto& p) {
+      return T(weights[p]);
+    });
+  }
+
+  /**
+   * @brief Reset the accumulators.
+   */
+  void reset()
+  {
+    m_values.fill(0);
+    m_weights.fill(0);
+  }
+
+  /// @group_operations
+
+  /**
+   * @brief Compute the co-added image, i.e. the weighted mean of the drops.
+   * @param fill The value of the pixels without contribution
+   */
+  Raster<T> image(T fill = 0) const
+  {
+    Raster<T> out(shape());
+    out.generate(
+        [=](auto v, auto w) {
+          return w > 0 ? v / w : fill;
+        },
+        m_values,
+        m_weights);
+    return out;
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief Accumulate the drops of an input region into an output tile.
+   *
+   * Drops are clipped to the tile, such that tiles can be processed concurrently.
+   */
+  template <typename TIn, typename TWeightFunc>
+  void drizzle_tile(
+      const TIn& in,
+      const Box<2>& region,
+      const std::array<double, 6>& map,
+      double scale,
+      TWeightFunc&& weight,
+      const Box<2>& tile)
+  {
+    const auto half = m_pixfrac * .5;
+    const auto project = [&](double x, double y, Internal::DropPolygon& polygon) {
+      polygon.push(map[0] + map[1] * x + map[2] * y, map[3] + map[4] * x + map[5] * y);
+    };
+    for (Index y = region.front()[1]; y <= region.back()[1]; ++y) {
+      for (Index x = region.front()[0]; x <= region.back()[0]; ++x) {
+        const Position<2> p {x, y};
+        const T v = in[p];
+        const auto w = weight(p);
+        if (not(v == v) || w == 0) {
+          continue;
+        }
+        Internal::DropPolygon drop;
+        project(x - half, y - half, drop);
+        project(x + half, y - half, drop);
+        project(x + half, y + half, drop);
+        project(x - half, y + half, drop);
+        double xmin = drop.coords[0];
+        double xmax = xmin;
+        double ymin = drop.coords[1];
+        double ymax = ymin;
+        for (Index i = 1; i < 4; ++i) {
+          xmin = std::min(xmin, drop.coords[2 * i]);
+          xmax = std::max(xmax, drop.coords[2 * i]);
+          ymin = std::min(ymin, drop.coords[2 * i + 1]);
+          ymax = std::max(ymax, drop.coords[2 * i + 1]);
+        }
+        const auto drop_area = drop.area();
+        const auto box = Box<2>({Index(std::floor(xmin + .5)), Index(std::floor(ymin + .5))},
+                                {Index(std::floor(xmax + .5)), Index(std::floor(ymax + .5))}) &
+            tile;
+        for (const auto& q : box) {
+          const auto a = drop.overlap(q[0] - .5, q[1] - .5) / drop_area;
+          if (a > 0) {
+            m_values[q] += v * scale * w * a;
+            m_weights[q] += w * a;
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Add an input frame.
+   */
+  template <typename TIn, typename TWeightFunc>
+  void add_impl(const TIn& in, const Affinity<2>& transform, TWeightFunc&& weight)
+  {
+    const auto origin = transform(Vector<double, 2>({0, 0}));
+    const auto ex = transform(Vector<double, 2>({1, 0}));
+    const auto ey = transform(Vector<double, 2>({0, 1}));
+    const std::array<double, 6> map {
+        origin[0],
+        ex[0] - origin[0],
+        ey[0] - origin[0],
+        origin[1],
+        ex[1] - origin[1],
+        ey[1] - origin[1]};
+    const auto det = map[1] * map[5] - map[2] * map[4];
+    const auto scale = 1. / std::abs(det); // Flux per input pixel to flux per output pixel
+    const auto unproject = [&](double u, double v) {
+      u -= map[0];
+      v -= map[3];
+      return std::array<double, 2> {(map[5] * u - map[2] * v) / det, (map[1] * v - map[4] * u) / det};
+    };
+
+    const auto input_domain = in.domain();
+    const auto domain = m_values.domain();
+    Position<2> tile_shape;
+    Position<2> grid_shape;
+    for (Index i = 0; i < 2; ++i) {
+      tile_shape[i] = std::max<Index>(std::min(TileSide, domain.length(i)), 1);
+      grid_shape[i] = (domain.length(i) + tile_shape[i] - 1) / tile_shape[i];
+    }
+    const auto tile_count = shape_size(grid_shape);
+
+#pragma omp parallel for schedule(dynamic)
+    for (Index t = 0; t < tile_count; ++t) {
+      const Position<2> tile_front {t % grid_shape[0] * tile_shape[0], t / grid_shape[0] * tile_shape[1]};
+      const auto tile = Box<2>::from_shape(tile_front, tile_shape) & domain;
+
+      // Bounding box of the tile projected onto the input, enlarged by the drop half-side
+      double xmin = std::numeric_limits<double>::max();
+      double xmax = std::numeric_limits<double>::lowest();
+      double ymin = xmin;
+      double ymax = xmax;
+      for (double u : {tile.front()[0] - .5, tile.back()[0] + .5}) {
+        for (double v : {tile.front()[1] - .5, tile.back()[1] + .5}) {
+          const auto xy = unproject(u, v);
+          xmin = std::min(xmin, xy[0]);
+          xmax = std::max(xmax, xy[0]);
+          ymin = std::min(ymin, xy[1]);
+          ymax = std::max(ymax, xy[1]);
+        }
+      }
+      const auto region = Box<2>({Index(std::floor(xmin)) - 1, Index(std::floor(ymin)) - 1},
+                                 {Index(std::ceil(xmax)) + 1, Index(std::ceil(ymax)) + 1}) &
+          input_domain;
+      if (region.length(0) <= 0 || region.length(1) <= 0) {
+        continue;
+      }
+      drizzle_tile(in, region, map, scale, weight, tile);
+    }
+  }
+
+  /**
+   * @brief The drop size ratio.
+   */
+  double m_pixfrac;
+
+  /**
+   * @brief The weighted sums of the values.
+   */
+  Raster<T> m_values;
+
+  /**
+   * @brief The sums of the weights.
+   */
+  Raster<T> m_weights;
+};
+
+} // namespace Linx
+
+#endif
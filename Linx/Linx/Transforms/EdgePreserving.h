@@ -0,0 +1,323 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_EDGEPRESERVING_H
+#define _LINXTRANSFORMS_EDGEPRESERVING_H
+
+#include "Linx/Base/TypeUtils.h"
+#include "Linx/Data/Raster.h"
+#include "Linx/Transforms/Extrapolation.h"
+#include "Linx/Transforms/LocalMoments.h"
+
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Compute the mean over a window clipped to the domain, in place.
+ */
+template <typename T, Index N>
+void box_means(Raster<T, N>& raster, const Raster<T, N>& counts, const Box<N>& window)
+{
+  box_sums(raster, window);
+  raster /= counts;
+}
+
+/**
+ * @brief Copy an extrapolated raster over its domain grown by some margin.
+ */
+template <typename TRaster, typename TMethod>
+auto pad(const Extrapolation<TRaster, TMethod>& in, const Box<TRaster::Dimension>& margin)
+{
+  return in.copy(in.domain() + margin);
+}
+
+/**
+ * @brief Crop a padded raster back to its original shape.
+ */
+template <typename T, Index N>
+Raster<T, N> crop(const Raster<T, N>& padded, const Box<N>& margin)
+{
+  return Raster<T, N>(padded(Box<N>::from_shape(-margin.front(), padded.shape() - margin.shape() + 1)));
+}
+
+/**
+ * @brief Lookup table of the range weights of the bilateral filter.
+ *
+ * Weights are tabulated for absolute differences up to 4 sigmas, and are 0 beyond.
+ */
+class RangeWeights {
+public:
+
+  RangeWeights(double sigma, Index size = 1024) : m_scale((size - 1) / (4 * sigma)), m_values(size + 1)
+  {
+    for (Index i = 0; i < size; ++i) {
+      const auto d = i / m_scale / sigma;
+      m_values[i] = std::exp(-.5 * d * d);
+    }
+    m_values[size] = 0;
+  }
+
+  template <typename T>
+  inline double operator()(T difference) const
+  {
+    const auto index = std::abs(difference) * m_scale + .5;
+    return index < m_values.size() - 1 ? m_values[Index(index)] : 0.;
+  }
+
+private:
+
+  double m_scale;
+  std::vector<double> m_values;
+};
+
+/**
+ * @brief Throw if a sigma of the bilateral filter is negative.
+ */
+inline void check_bilateral_sigmas(double spatial_sigma, double range_sigma)
+{
+  constexpr auto max = std::numeric_limits<double>::max();
+  OutOfBoundsError::may_throw("Spatial sigma: ", spatial_sigma, {0., max});
+  OutOfBoundsError::may_throw("Range sigma: ", range_sigma, {0., max});
+}
+
+/**
+ * @brief Apply a 1D bilateral filter along each axis in turn, in place.
+ */
+template <typename T, Index N>
+void separable_bilateral(Raster<T, N>& raster, Index radius, double spatial_sigma, double range_sigma)
+{
+  std::vector<double> spatial(2 * radius + 1);
+  for (Index k = -radius; k <= radius; ++k) {
+    spatial[k + radius] = std::exp(-.5 * k * k / (spatial_sigma * spatial_sigma));
+  }
+  const RangeWeights range(range_sigma);
+  std::vector<T> line;
+  auto* data = raster.data();
+  const auto size = static_cast<Index>(raster.size());
+  Index stride = 1;
+  for (Index i = 0; i < raster.dimension(); ++i) {
+    const auto length = raster.length(i);
+    line.resize(length);
+    for (Index block = 0; block < size; block += stride * length) {
+      for (Index offset = block; offset < block + stride; ++offset) {
+        auto* ptr = data + offset;
+        for (Index j = 0; j < length; ++j) {
+          line[j] = ptr[j * stride];
+        }
+        for (Index j = 0; j < length; ++j) {
+          const auto center = line[j];
+          double sum = 0;
+          double weights = 0;
+          const auto front = std::max<Index>(j - radius, 0);
+          const auto back = std::min<Index>(j + radius, length - 1);
+          for (Index k = front; k <= back; ++k) {
+            const auto w = spatial[k - j + radius] * range(line[k] - center);
+            sum += w * line[k];
+            weights += w;
+          }
+          ptr[j * stride] = sum / weights;
+        }
+      }
+    }
+    stride *= length;
+  }
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup filtering
+ * @brief Apply a guided filter.
+ * @param in The input raster
+ * @param guide The guide raster, of same shape as the input
+ * @param window The window of the local linear models, e.g. `Box<2>::from_center(radius)`
+ * @param epsilon The regularization parameter, in squared units of the guide
+ *
+ * The output is locally modeled as a linear function of the guide,
+ * which is fitted to the input by regularized least squares in each window.
+ * Structures of the guide with a local variance much higher than `epsilon` are preserved,
+ * while flatter regions are smoothed.
+ *
+ * The filter is made of box means only, which are computed in linear time with running sums,
+ * whatever the window size.
+ * Windows are clipped to the domain.
+ * To extrapolate the input instead, see the overload which takes an `Extrapolation`.
+ *
+ * To limit cancellation in the local variances, means are computed in double precision,
+ * of the values shifted by their global means.
+ */
+template <typename T, Index N, typename THolder, typename TGuide>
+Raster<typename TypeTraits<std::decay_t<T>>::Floating, N>
+guided_filter(const Raster<T, N, THolder>& in, const TGuide& guide, const Box<N>& window, double epsilon)
+{
+  using Value = typename TypeTraits<std::decay_t<T>>::Floating;
+
+  // Accumulate in double precision, of the values shifted by their global means, to limit cancellation
+  const auto size = in.size();
+  const double shift_i = size ? std::accumulate(guide.begin(), guide.end(), 0.) / size : 0.;
+  const double shift_p = size ? std::accumulate(in.begin(), in.end(), 0.) / size : 0.;
+
+  Raster<double, N> counts(in.shape());
+  counts.fill(1);
+  Internal::box_sums(counts, window);
+
+  Raster<double, N> mean_i(in.shape());
+  Raster<double, N> mean_p(in.shape());
+  Raster<double, N> corr_ii(in.shape());
+  Raster<double, N> corr_ip(in.shape());
+  mean_i.generate(
+      [=](auto i) {
+        return double(i) - shift_i;
+      },
+      guide);
+  mean_p.generate(
+      [=](auto p) {
+        return double(p) - shift_p;
+      },
+      in);
+  corr_ii.generate(
+      [](auto i) {
+        return i * i;
+      },
+      mean_i);
+  corr_ip.generate(
+      [](auto i, auto p) {
+        return i * p;
+      },
+      mean_i,
+      mean_p);
+  Internal::box_means(mean_i, counts, window);
+  Internal::box_means(mean_p, counts, window);
+  Internal::box_means(corr_ii, counts, window);
+  Internal::box_means(corr_ip, counts, window);
+
+  // Coefficients a and b in place of corr_ip and corr_ii
+  auto& a = corr_ip;
+  auto& b = corr_ii;
+  a.generate(
+      [=](auto mi, auto mp, auto cii, auto cip) {
+        return (cip - mi * mp) / (cii - mi * mi + epsilon);
+      },
+      mean_i,
+      mean_p,
+      corr_ii,
+      corr_ip);
+  b.generate(
+      [](auto mi, auto mp, auto ai) {
+        return mp - ai * mi;
+      },
+      mean_i,
+      mean_p,
+      a);
+  Internal::box_means(a, counts, window);
+  Internal::box_means(b, counts, window);
+
+  Raster<Value, N> out(in.shape());
+  out.generate(
+      [=](auto ai, auto bi, auto g) {
+        return Value(ai * (double(g) - shift_i) + bi + shift_p);
+      },
+      a,
+      b,
+      guide);
+  return out;
+}
+
+/**
+ * @ingroup filtering
+ * @brief Apply a self-guided filter.
+ *
+ * This is an edge-preserving smoothing, where the input is its own guide.
+ */
+template <typename T, Index N, typename THolder>
+Raster<typename TypeTraits<std::decay_t<T>>::Floating, N>
+guided_filter(const Raster<T, N, THolder>& in, const Box<N>& window, double epsilon)
+{
+  return guided_filter(in, in, window, epsilon);
+}
+
+/**
+ * @ingroup filtering
+ * @brief Apply a self-guided filter to an extrapolated raster.
+ *
+ * The input is extrapolated over twice the window, which is the extent of the filter.
+ */
+template <typename TRaster, typename TMethod>
+auto guided_filter(const Extrapolation<TRaster, TMethod>& in, const Box<TRaster::Dimension>& window, double epsilon)
+{
+  const auto margin = window + window;
+  const auto padded = Internal::pad(in, margin);
+  return Internal::crop(guided_filter(padded, window, epsilon), margin);
+}
+
+/**
+ * @ingroup filtering
+ * @brief Apply a separable bilateral filter.
+ * @param in The input raster
+ * @param spatial_sigma The standard deviation of the spatial Gaussian weights
+ * @param range_sigma The standard deviation of the range Gaussian weights, in units of the input values
+ * @param radius The spatial radius, which defaults to three times the spatial sigma
+ *
+ * The bilateral filter is a weighted mean where the weights decrease with the distance to the central pixel
+ * and with the difference to the central value, such that edges higher than the range sigma are preserved.
+ *
+ * This is the separable approximation, where a 1D bilateral filter is applied along each axis in turn,
+ * such that the cost per pixel is linear instead of polynomial in the radius.
+ * Range weights are tabulated, such that no exponential is evaluated per neighbor.
+ * Windows are clipped to the domain.
+ * To extrapolate the input instead, see the overload which takes an `Extrapolation`.
+ *
+ * If either sigma is 0, only the central pixel (or pixels of equal values) have non-null weights,
+ * such that the filter is the identity.
+ *
+ * @throw OutOfBoundsError if a sigma is negative
+ */
+template <typename T, Index N, typename THolder>
+Raster<typename TypeTraits<std::decay_t<T>>::Floating, N>
+bilateral_filter(const Raster<T, N, THolder>& in, double spatial_sigma, double range_sigma, Index radius = -1)
+{
+  using Value = typename TypeTraits<std::decay_t<T>>::Floating;
+  Internal::check_bilateral_sigmas(spatial_sigma, range_sigma);
+  if (radius < 0) {
+    radius = std::ceil(3 * spatial_sigma);
+  }
+  Raster<Value, N> out(in.shape(), in);
+  if (spatial_sigma == 0 || range_sigma == 0) { // Identity, while weights would be NaNs
+    return out;
+  }
+  Internal::separable_bilateral(out, radius, spatial_sigma, range_sigma);
+  return out;
+}
+
+/**
+ * @ingroup filtering
+ * @brief Apply a separable bilateral filter to an extrapolated raster.
+ */
+template <typename TRaster, typename TMethod>
+auto bilateral_filter(
+    const Extrapolation<TRaster, TMethod>& in,
+    double spatial_sigma,
+    double range_sigma,
+    Index radius = -1)
+{
+  Internal::check_bilateral_sigmas(spatial_sigma, range_sigma);
+  if (radius < 0) {
+    radius = std::ceil(3 * spatial_sigma);
+  }
+  const auto margin = Box<TRaster::Dimension>::from_center(radius);
+  const auto padded = Internal::pad(in, margin);
+  return Internal::crop(bilateral_filter(padded, spatial_sigma, range_sigma, radius), margin);
+}
+
+} // namespace Linx
+
+#endif
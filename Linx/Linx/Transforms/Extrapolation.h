@@ -113,16 +113,63 @@ public:
 
   /**
    * @brief Get a copy of the data in a given region.
+   *
+   * For boxes, the intersection with the raster domain is copied with `Linx::copy()`,
+   * and only the remaining pixels are extrapolated.
    */
   template <typename TRegion>
   Raster<std::decay_t<Value>, Dimension> copy(TRegion&& region) const
   {
-    // FIXME optimize
-    return Raster<std::decay_t<Value>, Dimension>((*this)(LINX_FORWARD(region)));
+    if constexpr (std::is_same_v<std::decay_t<TRegion>, Box<Dimension>>) {
+      return copy_box(region);
+    } else {
+      return Raster<std::decay_t<Value>, Dimension>((*this)(LINX_FORWARD(region)));
+    }
   }
 
 private:
 
+  /**
+   * @brief Copy the inner part of a box and extrapolate the border.
+   */
+  Raster<std::decay_t<Value>, Dimension> copy_box(const Box<Dimension>& region) const
+  {
+    Raster<std::decay_t<Value>, Dimension> out(region.shape());
+    const auto inner = region & m_raster.domain();
+    const auto dim = region.dimension();
+    bool has_inner = true;
+    for (Index i = 0; i < dim; ++i) {
+      has_inner &= inner.length(i) > 0;
+    }
+    if (has_inner) {
+      Linx::copy(m_raster(inner), out(inner - region.front()));
+    }
+
+    // Extrapolate the border row-wise, skipping the inner segments
+    const auto width = region.length(0);
+    const auto skip_front = inner.front()[0] - region.front()[0];
+    const auto skip_back = inner.back()[0] - region.front()[0];
+    auto rows = region;
+    rows.project();
+    auto* it = out.data();
+    for (auto p : rows) {
+      bool crosses_inner = has_inner;
+      for (Index i = 1; i < dim; ++i) {
+        crosses_inner &= p[i] >= inner.front()[i] && p[i] <= inner.back()[i];
+      }
+      for (Index x = 0; x < width; ++x, ++p[0], ++it) {
+        if (crosses_inner && x == skip_front) {
+          x = skip_back;
+          p[0] += skip_back - skip_front;
+          it += skip_back - skip_front;
+          continue;
+        }
+        *it = m_method.at(m_raster, p);
+      }
+    }
+    return out;
+  }
+
   /**
    * @brief The input raster.
    */
@@ -10,6 +10,7 @@
 #include "Linx/Transforms/Extrapolation.h"
 #include "Linx/Transforms/mixins/Filter.h"
 
+#include <tuple>
 #include <type_traits> // decay
 
 namespace Linx {
@@ -50,6 +51,37 @@ public:
       m_op(std::forward<TFunc>(op)), m_filters(std::forward<TFilters>(filters)...)
   {}
 
+  /**
+   * @brief Bring to scope FilterMixin::apply.
+   */
+  using FilterMixin<
+      typename std::invoke_result_t<TFunc, typename TFilters::Value...>,
+      Box<std::max({TFilters::Dimension...})>,
+      FilterAgg<TFunc, TFilters...>>::apply;
+
+  /**
+   * @brief The workspace type, i.e. the outputs of the aggregated filters.
+   * @tparam M The dimension of the input, which may be higher than that of the filters
+   */
+  template <Index M = Dimension>
+  using Workspace = std::tuple<Raster<typename TFilters::Value, M>...>;
+
+  /**
+   * @brief Apply the filters into a reusable output raster, with a reusable workspace.
+   * 
+   * The outputs of the aggregated filters are written into the workspace rasters,
+   * which are reallocated only if their shape does not match.
+   * 
+   * @see `FilterSeq::apply()`
+   */
+  template <typename TIn, typename U, Index N>
+  Raster<U, N>& apply(const TIn& in, Raster<U, N>& out, Workspace<N>& workspace) const
+  {
+    Internal::reuse(out, this->output_shape(in));
+    transform_impl(in, out, workspace, std::make_index_sequence<sizeof...(TFilters)> {});
+    return out;
+  }
+
 protected:
 
   /**
@@ -76,15 +108,16 @@ protected:
   template <typename TIn, typename TOut>
   void transform_impl(const TIn& in, TOut& out) const
   {
-    transform_impl(in, out, std::make_index_sequence<sizeof...(TFilters)> {});
+    Workspace<std::decay_t<TOut>::Dimension> workspace;
+    transform_impl(in, out, workspace, std::make_index_sequence<sizeof...(TFilters)> {});
   }
 
 private:
 
-  template <typename TIn, typename TOut, std::size_t... Is>
-  void transform_impl(const TIn& in, TOut& out, std::index_sequence<Is...>) const
+  template <typename TIn, typename TOut, typename TWorkspace, std::size_t... Is>
+  void transform_impl(const TIn& in, TOut& out, TWorkspace& workspace, std::index_sequence<Is...>) const
   {
-    out.generate(m_op, std::get<Is>(m_filters) * in...);
+    out.generate(m_op, std::get<Is>(m_filters).apply(in, std::get<Is>(workspace))...);
   }
 
 private:
@@ -10,6 +10,7 @@
 #include "Linx/Transforms/Extrapolation.h"
 #include "Linx/Transforms/mixins/Filter.h"
 
+#include <tuple>
 #include <type_traits> // decay
 
 namespace Linx {
@@ -49,6 +50,23 @@ public:
       Box<std::max({TFilters::Dimension...})>,
       FilterSeq<TFilters...>>::operator*;
 
+  /**
+   * @brief Bring to scope FilterMixin::apply.
+   */
+  using FilterMixin<
+      typename std::decay_t<decltype((std::declval<TFilters>(), ...))>::Value,
+      Box<std::max({TFilters::Dimension...})>,
+      FilterSeq<TFilters...>>::apply;
+
+  /**
+   * @brief The workspace type, i.e. the intermediate outputs of the filters.
+   * @tparam M The dimension of the input, which may be higher than that of the filters
+   * 
+   * The last raster is unused, since the last filter writes directly into the output.
+   */
+  template <Index M = Dimension>
+  using Workspace = std::tuple<Raster<typename TFilters::Value, M>...>;
+
   /**
    * @brief Constructor.
    * 
@@ -96,6 +114,33 @@ public:
     return std::get<I>(m_filters);
   }
 
+  /// @group_operations
+
+  /**
+   * @brief Apply the filters into a reusable output raster, with a reusable workspace.
+   * 
+   * The intermediate outputs are written into the workspace rasters,
+   * which are reallocated only if their shape does not match,
+   * such that filtering frames of constant shape in a loop does not allocate:
+   * 
+   * \code
+   * auto filter = convolution(...) * median_filter<float>(...);
+   * decltype(filter)::Workspace<> workspace;
+   * Raster<float> out;
+   * for (const auto& frame : frames) {
+   *   filter.apply(extrapolation<Nearest>(frame), out, workspace);
+   *   ...
+   * }
+   * \endcode
+   */
+  template <typename TIn, typename U, Index N>
+  Raster<U, N>& apply(const TIn& in, Raster<U, N>& out, Workspace<N>& workspace) const
+  {
+    Internal::reuse(out, this->output_shape(in));
+    transform_impl(in, out, workspace);
+    return out;
+  }
+
 protected:
 
   /**
@@ -117,10 +162,10 @@ protected:
    * 
    * The input is cropped according to the filter window just enough so no extrapolation is required.
    */
-  template <typename T, Index N, typename THolder, typename TOut>
-  void transform_impl(const Raster<T, N, THolder>& in, TOut& out) const
+  template <typename T, Index N, typename THolder, typename TOut, typename TWorkspace>
+  void transform_impl(const Raster<T, N, THolder>& in, TOut& out, TWorkspace& workspace) const
   {
-    const auto outK = upto_kth<sizeof...(TFilters) - 2>(in);
+    const auto& outK = upto_kth<sizeof...(TFilters) - 2>(in, workspace);
     filter<sizeof...(TFilters) - 1>().transform(outK, out);
   }
 
@@ -129,41 +174,51 @@ protected:
    * 
    * The input and output must have the same size, although not necessarily the same domain.
    */
-  template <typename TRaster, typename TMethod, typename TOut>
-  void transform_impl(const Extrapolation<TRaster, TMethod>& in, TOut& out) const
+  template <typename TRaster, typename TMethod, typename TOut, typename TWorkspace>
+  void transform_impl(const Extrapolation<TRaster, TMethod>& in, TOut& out, TWorkspace& workspace) const
   {
     const auto domain0 = in.domain() + extend<TRaster::Dimension>(window_impl());
-    const auto outK = upto_kth<sizeof...(TFilters) - 2>(in(domain0));
+    const auto& outK = upto_kth<sizeof...(TFilters) - 2>(in(domain0), workspace);
     filter<sizeof...(TFilters) - 1>().transform(outK, out);
   }
 
   /**
    * @brief Filter an input patch.
    */
-  template <typename T, typename TParent, typename TRegion, typename TOut>
-  void transform_impl(const Patch<T, TParent, TRegion>& in, TOut& out) const
+  template <typename T, typename TParent, typename TRegion, typename TOut, typename TWorkspace>
+  void transform_impl(const Patch<T, TParent, TRegion>& in, TOut& out, TWorkspace& workspace) const
   {
     const auto& raw = raster(in);
     const auto& domain = in.domain();
     const auto& extrapolate = in.method();
     static constexpr Index N = sizeof...(TFilters);
     const auto domain0 = box(domain) + extend<TParent::Dimension>(window_impl());
-    auto outK = upto_kth<N - 2>(extrapolate(raw(domain0)));
+    auto& outK = upto_kth<N - 2>(extrapolate(raw(domain0)), workspace);
     const auto domainK = in.domain() + filter<N - 1>().origin();
     filter<N - 1>().transform(outK(domainK), out);
   }
 
+  /**
+   * @brief Filter an input with a temporary workspace.
+   */
+  template <typename TIn, typename TOut>
+  void transform_impl(const TIn& in, TOut& out) const
+  {
+    Workspace<std::decay_t<TOut>::Dimension> workspace;
+    transform_impl(in, out, workspace);
+  }
+
 private:
 
-  template <std::size_t K, typename TIn>
-  auto upto_kth(const TIn& in) const
+  template <std::size_t K, typename TIn, typename TWorkspace>
+  auto& upto_kth(const TIn& in, TWorkspace& workspace) const
   {
     const auto& domain = in.domain() - extend<TIn::Dimension>(Linx::box(filter<K>().window()));
     const auto patch = in(domain);
     if constexpr (K == 0) {
-      return filter<0>() * patch;
+      return filter<0>().apply(patch, std::get<0>(workspace));
     } else {
-      return filter<K>() * upto_kth<K - 1>(patch);
+      return filter<K>().apply(upto_kth<K - 1>(patch, workspace), std::get<K>(workspace));
     }
   }
 
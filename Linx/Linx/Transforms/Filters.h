@@ -12,8 +12,42 @@
 #include "Linx/Transforms/SimpleFilter.h"
 #include "Linx/Transforms/mixins/Kernel.h"
 
+#include <limits>
+#include <type_traits>
+
 namespace Linx {
 
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Compute the inner product of weights and valid values, renormalized by the sum of the valid weights.
+ *
+ * If the sum of all the weights is null, e.g. for derivative kernels, the inner product is not renormalized.
+ */
+template <typename TIt, typename TInIt, typename T>
+T normalized_inner_product(TIt begin, TIt end, TInIt in, T sum)
+{
+  T weighted {};
+  T weights {};
+  bool any_valid = false;
+  for (; begin != end; ++begin, ++in) {
+    const auto v = *in;
+    if (v == v) {
+      weighted += *begin * v;
+      weights += *begin;
+      any_valid = true;
+    }
+  }
+  if (sum == T {}) {
+    return any_valid ? weighted : std::numeric_limits<T>::quiet_NaN();
+  }
+  return weights != T {} ? weighted * (sum / weights) : std::numeric_limits<T>::quiet_NaN();
+}
+
+} // namespace Internal
+/// @endcond
+
 /**
  * @ingroup filtering
  * @brief Correlation kernel.
@@ -98,6 +132,130 @@ struct MedianFilter :
   }
 };
 
+/**
+ * @ingroup filtering
+ * @brief NaN-aware normalized correlation kernel.
+ *
+ * NaNs are ignored, and the weighted sum of the valid neighbors is renormalized by the sum of the valid weights,
+ * in the same pass.
+ * The output is scaled by the sum of all the weights, such that it equals the plain correlation
+ * wherever all neighbors are valid.
+ * If no neighbors are valid, or if the valid weights sum to zero, the output is NaN.
+ *
+ * Zero-sum kernels, e.g. derivatives, cannot be renormalized:
+ * for them, the output is the plain inner product of the weights and valid neighbors,
+ * i.e. NaNs are considered as zeros.
+ */
+template <typename T, typename TWindow>
+class NormalizedCorrelation : public KernelMixin<T, TWindow, NormalizedCorrelation<T, TWindow>> {
+public:
+
+  using KernelMixin<T, TWindow, NormalizedCorrelation>::KernelMixin;
+
+  template <typename TIn>
+  inline T operator()(const TIn& neighbors) const
+  {
+    return Internal::normalized_inner_product(this->m_values.begin(), this->m_values.end(), neighbors.begin(), m_sum);
+  }
+
+  void init_impl() // FIXME private
+  {
+    m_sum = std::accumulate(this->m_values.begin(), this->m_values.end(), T {});
+  }
+
+private:
+
+  T m_sum;
+};
+
+/**
+ * @ingroup filtering
+ * @brief NaN-aware normalized convolution kernel.
+ * @see `NormalizedCorrelation`
+ */
+template <typename T, typename TWindow>
+class NormalizedConvolution : public KernelMixin<T, TWindow, NormalizedConvolution<T, TWindow>> {
+public:
+
+  using KernelMixin<T, TWindow, NormalizedConvolution>::KernelMixin;
+
+  template <typename TIn>
+  inline T operator()(const TIn& neighbors) const
+  {
+    return Internal::normalized_inner_product(this->m_values.rbegin(), this->m_values.rend(), neighbors.begin(), m_sum);
+  }
+
+  void init_impl() // FIXME private
+  {
+    m_sum = std::accumulate(this->m_values.begin(), this->m_values.end(), T {});
+  }
+
+private:
+
+  T m_sum;
+};
+
+/**
+ * @ingroup filtering
+ * @brief NaN-aware mean filtering kernel.
+ *
+ * NaNs are ignored.
+ * If no neighbors are valid, the output is NaN.
+ */
+template <typename T, typename TWindow>
+struct NanMeanFilter : public StructuringElementMixin<T, TWindow, NanMeanFilter<T, TWindow>> {
+  using StructuringElementMixin<T, TWindow, NanMeanFilter>::StructuringElementMixin;
+  template <typename TIn>
+  T operator()(const TIn& neighbors) const
+  {
+    T sum {};
+    Index count = 0;
+    for (const auto& e : neighbors) {
+      if (e == e) {
+        sum += e;
+        ++count;
+      }
+    }
+    return count ? sum / count : std::numeric_limits<T>::quiet_NaN();
+  }
+};
+
+/**
+ * @ingroup filtering
+ * @brief NaN-aware median filtering kernel.
+ *
+ * NaNs are ignored.
+ * If no neighbors are valid, the output is NaN.
+ */
+template <typename T, typename TWindow>
+struct NanMedianFilter : public StructuringElementMixin<T, TWindow, NanMedianFilter<T, TWindow>> {
+  using StructuringElementMixin<T, TWindow, NanMedianFilter>::StructuringElementMixin;
+  template <typename TIn>
+  T operator()(const TIn& neighbors) const
+  {
+    std::vector<T> v;
+    v.reserve(neighbors.size());
+    for (const auto& e : neighbors) {
+      if (e == e) {
+        v.push_back(e);
+      }
+    }
+    const auto size = v.size();
+    if (size == 0) {
+      return std::numeric_limits<T>::quiet_NaN();
+    }
+    auto b = v.data();
+    auto e = b + size;
+    auto n = b + size / 2;
+    std::nth_element(b, n, e);
+    if (size % 2 == 1) {
+      return *n;
+    }
+    const auto upper = *n;
+    return (*std::max_element(b, n) + upper) * .5;
+  }
+};
+
 /**
  * @ingroup filtering
  * @brief Minimum filtering kernel.
@@ -277,6 +435,54 @@ auto correlation(const Raster<T, N, THolder>& values)
   return correlation(values.data(), values.domain() - (values.shape() - 1) / 2);
 }
 
+/**
+ * @ingroup filtering
+ * @brief Make a NaN-aware normalized convolution kernel from values and a window.
+ * @see `NormalizedCorrelation`
+ */
+template <typename T, Index N = 2>
+auto normalized_convolution(const T* values, Box<N> window)
+{
+  const T* end = values + window.size();
+  return SimpleFilter<NormalizedConvolution<T, Box<N>>>(LINX_MOVE(window), std::vector<T>(values, end));
+}
+
+/**
+ * @ingroup filtering
+ * @brief Make a NaN-aware normalized convolution kernel from a raster, with centered origin.
+ * 
+ * In case of even lengths, origin position is rounded down.
+ */
+template <typename T, Index N, typename THolder>
+auto normalized_convolution(const Raster<T, N, THolder>& values)
+{
+  return normalized_convolution(values.data(), values.domain() - (values.shape() - 1) / 2);
+}
+
+/**
+ * @ingroup filtering
+ * @brief Make a NaN-aware normalized correlation kernel from values and a window.
+ * @see `NormalizedCorrelation`
+ */
+template <typename T, Index N = 2>
+auto normalized_correlation(const T* values, Box<N> window)
+{
+  const T* end = values + window.size();
+  return SimpleFilter<NormalizedCorrelation<T, Box<N>>>(LINX_MOVE(window), std::vector<T>(values, end));
+}
+
+/**
+ * @ingroup filtering
+ * @brief Make a NaN-aware normalized correlation kernel from a raster, with centered origin.
+ * 
+ * In case of even lengths, origin position is rounded down.
+ */
+template <typename T, Index N, typename THolder>
+auto normalized_correlation(const Raster<T, N, THolder>& values)
+{
+  return normalized_correlation(values.data(), values.domain() - (values.shape() - 1) / 2);
+}
+
 /**
  * @ingroup filtering
  * @brief Create a filter made of identical 1D correlation kernels along given axes.
@@ -414,6 +620,49 @@ auto median_filter(TWindow&& window)
   return SimpleFilter<MedianFilter<T, TWindow>>(MedianFilter<T, TWindow>(LINX_FORWARD(window)));
 }
 
+/**
+ * @ingroup filtering
+ * @brief Make a NaN-aware mean filter with a given structuring element.
+ */
+template <typename T, typename TWindow>
+auto nan_mean_filter(TWindow&& window)
+{
+  return SimpleFilter<NanMeanFilter<T, TWindow>>(NanMeanFilter<T, TWindow>(LINX_FORWARD(window)));
+}
+
+/**
+ * @ingroup filtering
+ * @brief Make a NaN-aware median filter with a given structuring element.
+ */
+template <typename T, typename TWindow>
+auto nan_median_filter(TWindow&& window)
+{
+  return SimpleFilter<NanMedianFilter<T, TWindow>>(NanMedianFilter<T, TWindow>(LINX_FORWARD(window)));
+}
+
+/**
+ * @ingroup filtering
+ * @brief Copy a raster, with NaNs where a validity map is false.
+ *
+ * This is how bad pixel maps are given to NaN-aware filters:
+ * \code
+ * auto filtered = nan_median_filter<float>(Box<2>::from_center(2)) * extrapolation<Nearest>(invalidate(in, valid));
+ * \endcode
+ */
+template <typename T, Index N, typename THolder, typename TValidity>
+Raster<std::decay_t<T>, N> invalidate(const Raster<T, N, THolder>& in, const TValidity& validity)
+{
+  static_assert(std::is_floating_point_v<std::decay_t<T>>, "NaNs require a floating point value type");
+  Raster<std::decay_t<T>, N> out(in.shape());
+  out.generate(
+      [](auto v, auto f) {
+        return f ? v : std::numeric_limits<std::decay_t<T>>::quiet_NaN();
+      },
+      in,
+      validity);
+  return out;
+}
+
 /**
  * @ingroup filtering
  * @brief Make a minimun filter with a given structuring element.
@@ -0,0 +1,196 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_LAZYFILTERED_H
+#define _LINXTRANSFORMS_LAZYFILTERED_H
+
+#include "Linx/Data/LazyRaster.h"
+#include "Linx/Transforms/Extrapolation.h"
+
+#include <algorithm>
+#include <type_traits>
+
+namespace Linx {
+
+/**
+ * @ingroup filtering
+ * @brief A raster source filtered on demand, chunk by chunk.
+ * @tparam TSource The input raster source, e.g. a `LazyRaster` or another `LazyFiltered`,
+ * or a constant reference to it
+ * @tparam TFilter The filter type
+ * @tparam TMethod The extrapolation method
+ *
+ * Each output chunk is computed from an input chunk which is extended along the last axis
+ * by the margins of the filter window, and extrapolated beyond the input domain.
+ * Input chunks are therefore slightly larger than output chunks,
+ * but the full input is never allocated, such that filtered sources can be chained and streamed.
+ *
+ * Since input chunks span the whole input along all axes but the last one,
+ * the output is identical to the filtering of the whole extrapolated input,
+ * as long as the extrapolation method only depends on the values near the domain boundary,
+ * e.g. `Constant`, `Nearest`, or mirroring methods with chunks longer than the window.
+ * Periodic extrapolation is not supported along the last axis.
+ *
+ * The source is referenced if it is a reference type, and owned otherwise,
+ * such that temporary sources can be chained safely:
+ *
+ * \code
+ * auto scene = lazy_raster(shape, render);
+ * auto blurred = lazy_filter(convolution(psf), scene); // References scene
+ * auto denoised = lazy_filter(median_filter<float>(box), lazy_filter(convolution(psf), scene)); // Owns the blurred source
+ * Fits("blurred.fits").write_stream(blurred);
+ * \endcode
+ *
+ * @see `lazy_filter()`
+ */
+template <typename TSource, typename TFilter, typename TMethod>
+class LazyFiltered {
+public:
+
+  /**
+   * @brief The value type.
+   */
+  using Value = typename TFilter::Value;
+
+  /**
+   * @brief The dimension parameter.
+   */
+  static constexpr Index Dimension = std::decay_t<TSource>::Dimension;
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Constructor.
+   * @param filter The filter
+   * @param source The input source, which must outlive the filtered source if `TSource` is a reference
+   * @param method The extrapolation method
+   */
+  LazyFiltered(TFilter filter, TSource source, TMethod method = TMethod()) :
+      m_filter(LINX_MOVE(filter)), m_source(LINX_FORWARD(source)), m_method(LINX_MOVE(method))
+  {}
+
+  /// @group_properties
+
+  /**
+   * @brief Get the raster shape.
+   */
+  const Position<Dimension>& shape() const
+  {
+    return m_source.shape();
+  }
+
+  /**
+   * @brief Get the raster domain.
+   */
+  Box<Dimension> domain() const
+  {
+    return Box<Dimension>::from_shape(shape());
+  }
+
+  /**
+   * @brief Get the number of pixels.
+   */
+  Index size() const
+  {
+    return shape_size(shape());
+  }
+
+  /**
+   * @brief Get the filter.
+   */
+  const TFilter& filter() const
+  {
+    return m_filter;
+  }
+
+  /// @group_operations
+
+  /**
+   * @brief Filter a chunk.
+   * @param out The output chunk, whose shape matches the raster shape except along the last axis
+   * @param front The index of the first section of the chunk along the last axis
+   */
+  void generate(Raster<Value, Dimension>& out, Index front) const
+  {
+    const auto dim = out.dimension();
+    const auto last = dim - 1;
+    const auto back = front + out.length(last) - 1;
+    const auto window = extend<Dimension>(Linx::box(m_filter.window()));
+    const auto in_front = std::max<Index>(front + window.front()[last], 0);
+    const auto in_back = std::min<Index>(back + window.back()[last], shape()[last] - 1);
+    const auto in = m_source.chunk(in_front, in_back);
+
+    auto region_front = Position<Dimension>::zero(dim);
+    auto region_back = in.shape() - 1;
+    region_front[last] = front - in_front;
+    region_back[last] = back - in_front;
+    const auto extrapolated = Extrapolation<std::decay_t<decltype(in)>, TMethod>(in, TMethod(m_method));
+    m_filter.apply(extrapolated(Box<Dimension>(region_front, region_back)), out);
+  }
+
+  /**
+   * @brief Filter a chunk between given indices along the last axis.
+   */
+  Raster<Value, Dimension> chunk(Index front, Index back) const
+  {
+    auto shape = this->shape();
+    shape[shape.size() - 1] = back - front + 1;
+    Raster<Value, Dimension> out(shape);
+    generate(out, front);
+    return out;
+  }
+
+  /**
+   * @brief Filter the whole raster.
+   */
+  Raster<Value, Dimension> raster() const
+  {
+    return chunk(0, shape()[shape().size() - 1] - 1);
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief The filter.
+   */
+  TFilter m_filter;
+
+  /**
+   * @brief The input source, or a reference to it.
+   */
+  TSource m_source;
+
+  /**
+   * @brief The extrapolation method.
+   */
+  TMethod m_method;
+};
+
+/**
+ * @relatesalso LazyFiltered
+ * @brief Filter a raster source lazily.
+ * @tparam TMethod The extrapolation method
+ * @param filter The filter
+ * @param source The input source, e.g. a `LazyRaster`, which is referenced if it is an lvalue, and moved otherwise
+ * @param args The extrapolation method constructor arguments, e.g. the constant value of `Constant`
+ */
+template <typename TMethod = Nearest, typename TFilter, typename TSource, typename... TArgs>
+auto lazy_filter(TFilter filter, TSource&& source, TArgs&&... args)
+{
+  using TStored = std::conditional_t<
+      std::is_lvalue_reference_v<TSource>,
+      const std::remove_reference_t<TSource>&,
+      std::decay_t<TSource>>;
+  return LazyFiltered<TStored, TFilter, TMethod>(
+      LINX_MOVE(filter),
+      LINX_FORWARD(source),
+      TMethod(LINX_FORWARD(args)...));
+}
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,333 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_LOCALMOMENTS_H
+#define _LINXTRANSFORMS_LOCALMOMENTS_H
+
+#include "Linx/Base/TypeUtils.h"
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Raster.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Replace the values of a raster with their sums over a window, in place.
+ *
+ * Along each axis, the window sums are differences of running sums,
+ * such that the cost per pixel does not depend on the window size.
+ * The window is clipped to the domain.
+ * Values must support `+` and `-`, and `T {}` must be zero.
+ */
+template <typename T, Index N, typename THolder>
+void box_sums(Raster<T, N, THolder>& raster, const Box<N>& window)
+{
+  constexpr Index chunk = 64; // Lines are processed by chunks of contiguous lines for cache efficiency
+  std::vector<T> cumulated;
+  auto* data = raster.data();
+  const auto size = static_cast<Index>(raster.size());
+  Index stride = 1;
+  for (Index i = 0; i < window.dimension(); ++i) {
+    const auto length = raster.length(i);
+    const auto front = window.front()[i];
+    const auto back = window.back()[i];
+    const auto width = std::min(chunk, stride);
+    const auto inner_front = std::clamp<Index>(-front, 0, length);
+    const auto inner_back = std::clamp<Index>(length - back, inner_front, length);
+    cumulated.resize((length + 1) * width);
+    if (stride == 1) {
+      for (auto* ptr = data; ptr < data + size; ptr += length) {
+        cumulated[0] = T {};
+        for (Index j = 0; j < length; ++j) {
+          cumulated[j + 1] = cumulated[j] + ptr[j];
+        }
+        const auto* c = cumulated.data();
+        for (Index j = 0; j < inner_front; ++j) {
+          const auto lo = std::clamp<Index>(j + front, 0, length);
+          ptr[j] = c[std::clamp<Index>(j + back + 1, lo, length)] - c[lo];
+        }
+        for (Index j = inner_front; j < inner_back; ++j) { // No clamping: vectorizable
+          ptr[j] = c[j + back + 1] - c[j + front];
+        }
+        for (Index j = inner_back; j < length; ++j) {
+          const auto lo = std::clamp<Index>(j + front, 0, length);
+          ptr[j] = c[std::clamp<Index>(j + back + 1, lo, length)] - c[lo];
+        }
+      }
+      stride = length;
+      continue;
+    }
+    for (Index block = 0; block < size; block += stride * length) {
+      for (Index offset = block; offset < block + stride; offset += width) {
+        auto* ptr = data + offset;
+        const auto count = std::min(width, block + stride - offset);
+        std::fill(cumulated.begin(), cumulated.begin() + count, T {});
+        for (Index j = 0; j < length; ++j) {
+          const auto* in = ptr + j * stride;
+          const auto* previous = &cumulated[j * width];
+          auto* current = &cumulated[(j + 1) * width];
+          for (Index k = 0; k < count; ++k) {
+            current[k] = previous[k] + in[k];
+          }
+        }
+        for (Index j = 0; j < length; ++j) {
+          const auto lo = std::clamp<Index>(j + front, 0, length);
+          const auto hi = std::clamp<Index>(j + back + 1, lo, length);
+          const auto* lower = &cumulated[lo * width];
+          const auto* upper = &cumulated[hi * width];
+          auto* out = ptr + j * stride;
+          for (Index k = 0; k < count; ++k) {
+            out[k] = upper[k] - lower[k];
+          }
+        }
+      }
+    }
+    stride *= length;
+  }
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup filtering
+ * @brief Local moments of a raster over a sliding window.
+ * @tparam T The input value type
+ * @tparam N The dimension
+ *
+ * The sums of the first powers of the valid values in the window are computed at construction,
+ * in a single pass per axis with constant cost per pixel, whatever the window size:
+ * along each axis, the box sums are differences of running sums.
+ * The counts and sums are stored, and the maps of local statistics are computed from them on demand.
+ *
+ * NaNs are considered invalid and ignored, as are the pixels outside the domain:
+ * the window is clipped to the domain, and the `count()` map gives the number of valid pixels in each window.
+ * Statistics are NaN where the count is too low.
+ *
+ * To limit cancellation, sums are accumulated in double precision, of the values shifted by their global mean.
+ *
+ * \code
+ * LocalMoments<float> moments(image, Box<2>::from_center(5));
+ * auto background = moments.mean();
+ * auto noise = moments.stdev();
+ * \endcode
+ *
+ * @see `DataDistribution` for global statistics
+ */
+template <typename T, Index N = 2>
+class LocalMoments {
+public:
+
+  /**
+   * @copybrief TypeTraits::Floating
+   */
+  using Floating = typename TypeTraits<T>::Floating;
+
+  /**
+   * @brief The dimension parameter.
+   */
+  static constexpr Index Dimension = N;
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Constructor.
+   * @param in The input raster
+   * @param window The sliding window, e.g. `Box<2>::from_center(radius)`
+   */
+  template <typename TRaster>
+  LocalMoments(const TRaster& in, const Box<N>& window) : m_shift(0), m_sums(in.shape())
+  {
+    Index count = 0;
+    for (const auto& e : in) {
+      if (is_valid(e)) {
+        m_shift += e;
+        ++count;
+      }
+    }
+    m_shift = count ? m_shift / count : 0;
+
+    auto it = m_sums.begin();
+    for (const auto& e : in) {
+      if (is_valid(e)) {
+        const double y = double(e) - m_shift;
+        *it = {{1, y, y * y, y * y * y}};
+      } else {
+        *it = {};
+      }
+      ++it;
+    }
+
+    Internal::box_sums(m_sums, window);
+  }
+
+  /// @group_properties
+
+  /**
+   * @brief Get the shape.
+   */
+  const Position<N>& shape() const
+  {
+    return m_sums.shape();
+  }
+
+  /// @group_operations
+
+  /**
+   * @brief Get the number of valid values in the windows.
+   */
+  Raster<Index, N> count() const
+  {
+    Raster<Index, N> out(shape());
+    out.generate(
+        [](const auto& s) {
+          return Index(s[0]);
+        },
+        m_sums);
+    return out;
+  }
+
+  /**
+   * @brief Compute the local mean.
+   */
+  Raster<Floating, N> mean() const
+  {
+    return map([&](const auto& s) {
+      return s[0] > 0 ? m_shift + s[1] / s[0] : nan();
+    });
+  }
+
+  /**
+   * @brief Compute the local variance.
+   *
+   * The difference between biased and unbiased variance is that the denominator is
+   * the number of valid values in the first case, and the number of valid values minus one in the latter case.
+   */
+  Raster<Floating, N> variance(bool unbiased = true) const
+  {
+    return map([=](const auto& s) {
+      return variance(s, unbiased);
+    });
+  }
+
+  /**
+   * @brief Compute the local standard deviation.
+   */
+  Raster<Floating, N> stdev(bool unbiased = true) const
+  {
+    return map([=](const auto& s) {
+      return std::sqrt(variance(s, unbiased));
+    });
+  }
+
+  /**
+   * @brief Compute the local skewness, i.e. the standardized third central moment.
+   */
+  Raster<Floating, N> skewness() const
+  {
+    return map([=](const auto& s) {
+      const auto var = variance(s, false);
+      if (not(var > 0)) {
+        return nan();
+      }
+      const auto m = s[1] / s[0];
+      const auto mu3 = s[3] / s[0] - 3 * m * s[2] / s[0] + 2 * m * m * m;
+      return Floating(mu3 / (var * std::sqrt(var)));
+    });
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief The sums of the powers 0 to 3.
+   */
+  struct Sums : std::array<double, 4> {
+    Sums operator+(const Sums& rhs) const
+    {
+      const auto& lhs = *this;
+      return {lhs[0] + rhs[0], lhs[1] + rhs[1], lhs[2] + rhs[2], lhs[3] + rhs[3]};
+    }
+    Sums operator-(const Sums& rhs) const
+    {
+      const auto& lhs = *this;
+      return {lhs[0] - rhs[0], lhs[1] - rhs[1], lhs[2] - rhs[2], lhs[3] - rhs[3]};
+    }
+  };
+
+  /**
+   * @brief Check whether a value is valid, i.e. not NaN.
+   */
+  template <typename U>
+  static bool is_valid(const U& value)
+  {
+    return value == value;
+  }
+
+  /**
+   * @brief Get NaN.
+   */
+  static Floating nan()
+  {
+    return std::numeric_limits<Floating>::quiet_NaN();
+  }
+
+  /**
+   * @brief Compute the variance from the sums.
+   */
+  static Floating variance(const Sums& s, bool unbiased)
+  {
+    if (s[0] <= unbiased) {
+      return nan();
+    }
+    const auto m = s[1] / s[0];
+    const auto var = (s[2] - m * s[1]) / (s[0] - unbiased);
+    return var > 0 ? var : 0; // Cancellation may yield tiny negative values
+  }
+
+  /**
+   * @brief Map the sums.
+   */
+  template <typename TFunc>
+  Raster<Floating, N> map(TFunc&& func) const
+  {
+    Raster<Floating, N> out(shape());
+    out.generate(LINX_FORWARD(func), m_sums);
+    return out;
+  }
+
+  /**
+   * @brief The shift applied to the values before summing.
+   */
+  double m_shift;
+
+  /**
+   * @brief The local sums.
+   */
+  Raster<Sums, N> m_sums;
+};
+
+/**
+ * @ingroup filtering
+ * @brief Make a `LocalMoments` object.
+ */
+template <typename T, Index N, typename THolder>
+LocalMoments<std::decay_t<T>, N> local_moments(const Raster<T, N, THolder>& in, const Box<N>& window)
+{
+  return LocalMoments<std::decay_t<T>, N>(in, window);
+}
+
+} // namespace Linx
+
+#endif
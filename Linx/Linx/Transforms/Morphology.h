@@ -0,0 +1,671 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_MORPHOLOGY_H
+#define _LINXTRANSFORMS_MORPHOLOGY_H
+
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Mask.h"
+#include "Linx/Data/Raster.h"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @ingroup filtering
+ * @brief A line segment of a structuring element.
+ *
+ * The segment is made of the positions `t * step` for `t` in `[front, back]`.
+ */
+template <Index N = 2>
+struct LineSegment {
+  /**
+   * @brief The step between consecutive positions, e.g. `{1, 0}` for horizontal segments or `{1, 1}` for diagonal ones.
+   */
+  Position<N> step;
+
+  /**
+   * @brief The front index.
+   */
+  Index front;
+
+  /**
+   * @brief The back index.
+   */
+  Index back;
+};
+
+/**
+ * @ingroup filtering
+ * @brief Structuring element decomposed as a Minkowski sum of line segments.
+ *
+ * Along a line segment, running minima and maxima are computed in constant time per pixel
+ * with the van Herk/Gil-Werman algorithm, whatever the segment length.
+ * Therefore, eroding or dilating with the decomposed structuring element costs one such pass per segment,
+ * instead of one comparison per element of the structuring element.
+ *
+ * Boxes are decomposed exactly into one segment per axis, with `from_box()`.
+ * Balls are approximated by octagons in 2D, made of horizontal, vertical and diagonal segments, with `octagon()`.
+ *
+ * @see `erode()`, `dilate()`, `opening()`, `closing()`
+ */
+template <Index N = 2>
+class SegmentDecomposition {
+public:
+
+  /**
+   * @brief The dimension parameter.
+   */
+  static constexpr Index Dimension = N;
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Constructor.
+   */
+  explicit SegmentDecomposition(std::vector<LineSegment<N>> segments) : m_segments(LINX_MOVE(segments)) {}
+
+  /**
+   * @brief Decompose a box.
+   */
+  static SegmentDecomposition from_box(const Box<N>& box)
+  {
+    std::vector<LineSegment<N>> segments;
+    const auto dim = box.dimension();
+    for (Index i = 0; i < dim; ++i) {
+      if (box.length(i) > 1 || box.front()[i] != 0) {
+        auto step = Position<N>::zero(dim);
+        step[i] = 1;
+        segments.push_back({step, box.front()[i], box.back()[i]});
+      }
+    }
+    return SegmentDecomposition(LINX_MOVE(segments));
+  }
+
+  /**
+   * @brief Make a centered octagon which approximates a disk of given radius.
+   *
+   * The octagon is the Minkowski sum of horizontal and vertical segments of half-length `a`
+   * and diagonal segments of half-length `b`, with `a + 2 b = radius` and `b` close to `radius (1 - 1 / sqrt(2))`,
+   * such that the octagon has the extent of the disk along the axes and the diagonals.
+   */
+  static SegmentDecomposition octagon(Index radius)
+  {
+    static_assert(N == 2, "Octagons are only defined in 2D");
+    const Index b = std::lround(radius * (1. - 1. / std::sqrt(2.)));
+    const Index a = radius - 2 * b;
+    std::vector<LineSegment<N>> segments;
+    if (a > 0) {
+      segments.push_back({Position<N>({1, 0}), -a, a});
+      segments.push_back({Position<N>({0, 1}), -a, a});
+    }
+    if (b > 0) {
+      segments.push_back({Position<N>({1, 1}), -b, b});
+      segments.push_back({Position<N>({1, -1}), -b, b});
+    }
+    return SegmentDecomposition(LINX_MOVE(segments));
+  }
+
+  /// @group_properties
+
+  /**
+   * @brief Get the segments.
+   */
+  const std::vector<LineSegment<N>>& segments() const
+  {
+    return m_segments;
+  }
+
+  /**
+   * @brief Get the reflected structuring element, i.e. the set of opposite positions.
+   *
+   * Segments are listed in reverse order, such that dilating with the reflected element
+   * is the adjoint of eroding with the element, even near the domain boundaries.
+   */
+  SegmentDecomposition reflected() const
+  {
+    std::vector<LineSegment<N>> segments(m_segments.rbegin(), m_segments.rend());
+    for (auto& s : segments) {
+      const auto front = s.front;
+      s.front = -s.back;
+      s.back = -front;
+    }
+    return SegmentDecomposition(LINX_MOVE(segments));
+  }
+
+  /**
+   * @brief Compute the equivalent mask, i.e. the Minkowski sum of the segments.
+   */
+  Mask<N> mask() const
+  {
+    std::vector<Position<N>> positions {Position<N>::zero(m_segments.empty() ? std::abs(N) : m_segments[0].step.size())};
+    for (const auto& s : m_segments) {
+      std::vector<Position<N>> sum;
+      sum.reserve(positions.size() * (s.back - s.front + 1));
+      for (const auto& p : positions) {
+        for (auto t = s.front; t <= s.back; ++t) {
+          sum.push_back(p + s.step * t);
+        }
+      }
+      positions = LINX_MOVE(sum);
+    }
+    auto front = positions[0];
+    auto back = positions[0];
+    for (const auto& p : positions) {
+      for (std::size_t i = 0; i < p.size(); ++i) {
+        front[i] = std::min(front[i], p[i]);
+        back[i] = std::max(back[i], p[i]);
+      }
+    }
+    Mask<N> out(Box<N>(front, back), false);
+    for (const auto& p : positions) {
+      out[p] = true;
+    }
+    return out;
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief The segments.
+   */
+  std::vector<LineSegment<N>> m_segments;
+};
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Get the decomposition of a box.
+ */
+template <Index N>
+SegmentDecomposition<N> decompose(const Box<N>& box)
+{
+  return SegmentDecomposition<N>::from_box(box);
+}
+
+/**
+ * @brief Get a decomposition as is.
+ */
+template <Index N>
+const SegmentDecomposition<N>& decompose(const SegmentDecomposition<N>& se)
+{
+  return se;
+}
+
+/**
+ * @brief Minimum operation and its identity.
+ */
+template <typename T>
+struct MinOp {
+  static constexpr T identity()
+  {
+    return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+  }
+  inline T operator()(T lhs, T rhs) const
+  {
+    return rhs < lhs ? rhs : lhs;
+  }
+};
+
+/**
+ * @brief Maximum operation and its identity.
+ */
+template <typename T>
+struct MaxOp {
+  static constexpr T identity()
+  {
+    return std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity() :
+                                                  std::numeric_limits<T>::lowest();
+  }
+  inline T operator()(T lhs, T rhs) const
+  {
+    return lhs < rhs ? rhs : lhs;
+  }
+};
+
+/**
+ * @brief Workspace of the van Herk/Gil-Werman algorithm.
+ */
+template <typename T>
+struct VanHerkWorkspace {
+  std::vector<T> line; ///< The input line, padded
+  std::vector<T> prefix; ///< The block-wise prefix running operation
+  std::vector<T> suffix; ///< The block-wise suffix running operation
+};
+
+/**
+ * @brief Apply a running operation over a window `[front, back]` to a contiguous line, in place.
+ *
+ * Values out of the line are extrapolated with the nearest value of the line,
+ * such that windows which do not overlap the line, e.g. for windows which do not contain the origin, are well defined.
+ */
+template <typename TOp, typename T>
+void van_herk(T* data, Index size, Index front, Index back, VanHerkWorkspace<T>& ws)
+{
+  const TOp op;
+  const Index k = back - front + 1;
+  const Index padded = ((size + k - 1 + k - 1) / k) * k;
+  ws.line.assign(padded, TOp::identity());
+  ws.prefix.resize(padded);
+  ws.suffix.resize(padded);
+  // line[j] = data[j + front], clamped
+  for (Index j = 0; j < size + k - 1; ++j) {
+    ws.line[j] = data[std::clamp<Index>(j + front, 0, size - 1)];
+  }
+  for (Index block = 0; block < padded; block += k) {
+    const auto end = block + k;
+    ws.prefix[block] = ws.line[block];
+    for (Index j = block + 1; j < end; ++j) {
+      ws.prefix[j] = op(ws.prefix[j - 1], ws.line[j]);
+    }
+    ws.suffix[end - 1] = ws.line[end - 1];
+    for (Index j = end - 2; j >= block; --j) {
+      ws.suffix[j] = op(ws.suffix[j + 1], ws.line[j]);
+    }
+  }
+  for (Index i = 0; i < size; ++i) {
+    data[i] = op(ws.suffix[i], ws.prefix[i + k - 1]);
+  }
+}
+
+/**
+ * @brief Apply a running operation along a line segment, in place.
+ */
+template <typename TOp, typename T, Index N, typename THolder>
+void apply_segment(Raster<T, N, THolder>& raster, const LineSegment<N>& segment, VanHerkWorkspace<T>& ws)
+{
+  if (segment.front == 0 && segment.back == 0) {
+    return;
+  }
+  const auto& step = segment.step;
+  const auto domain = raster.domain();
+  Index stride = 0;
+  Index s = 1;
+  for (Index i = 0; i < raster.dimension(); ++i) {
+    stride += step[i] * s;
+    s *= raster.length(i);
+  }
+  std::vector<T> buffer;
+  for (const auto& p : domain) {
+    if (domain.contains(p - step)) { // Not a line start
+      continue;
+    }
+    buffer.clear();
+    auto* start = &raster[p];
+    auto q = p;
+    auto* ptr = start;
+    while (domain.contains(q)) {
+      buffer.push_back(*ptr);
+      q += step;
+      ptr += stride;
+    }
+    van_herk<TOp>(buffer.data(), buffer.size(), segment.front, segment.back, ws);
+    ptr = start;
+    for (const auto& v : buffer) {
+      *ptr = v;
+      ptr += stride;
+    }
+  }
+}
+
+/**
+ * @brief Apply a running operation along all the segments of a structuring element, in place.
+ */
+template <typename TOp, typename T, Index N, typename THolder>
+void apply_segments(Raster<T, N, THolder>& raster, const SegmentDecomposition<N>& se)
+{
+  VanHerkWorkspace<T> ws;
+  for (const auto& s : se.segments()) {
+    apply_segment<TOp>(raster, s, ws);
+  }
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup filtering
+ * @brief Erode a raster, i.e. compute the minimum over a structuring element.
+ * @param in The input raster
+ * @param se The structuring element, either a `Box` or a `SegmentDecomposition`
+ *
+ * The output at position `p` is the minimum of the input over the positions `p + q` for `q` in `se`.
+ * Segments are applied one after the other and the values outside the domain are replaced with the nearest value
+ * along the segment.
+ * For boxes, this is equivalent to (but much faster than) `minimum_filter<T>(box) * extrapolation<Nearest>(in)`,
+ * including for boxes which do not contain the origin.
+ * For other structuring elements, this is also equivalent away from the boundaries, i.e. where `p + se` is inside the domain.
+ */
+template <typename T, Index N, typename THolder, typename TSe>
+Raster<std::decay_t<T>, N> erode(const Raster<T, N, THolder>& in, const TSe& se)
+{
+  Raster<std::decay_t<T>, N> out(in.shape(), in);
+  Internal::apply_segments<Internal::MinOp<std::decay_t<T>>>(out, Internal::decompose(se));
+  return out;
+}
+
+/**
+ * @ingroup filtering
+ * @brief Dilate a raster, i.e. compute the maximum over the reflected structuring element.
+ *
+ * The output at position `p` is the maximum of the input over the positions `p - q` for `q` in `se`,
+ * such that dilation is the adjoint of erosion, and `dilate(erode(in, se), se)` is the opening.
+ * Boundaries are handled like in `erode()`.
+ */
+template <typename T, Index N, typename THolder, typename TSe>
+Raster<std::decay_t<T>, N> dilate(const Raster<T, N, THolder>& in, const TSe& se)
+{
+  Raster<std::decay_t<T>, N> out(in.shape(), in);
+  Internal::apply_segments<Internal::MaxOp<std::decay_t<T>>>(out, Internal::decompose(se).reflected());
+  return out;
+}
+
+/**
+ * @ingroup filtering
+ * @brief Compute the morphological opening, i.e. the dilation of the erosion.
+ *
+ * Both passes are performed in place in the output raster, such that no intermediate raster is allocated.
+ */
+template <typename T, Index N, typename THolder, typename TSe>
+Raster<std::decay_t<T>, N> opening(const Raster<T, N, THolder>& in, const TSe& se)
+{
+  const auto& decomposition = Internal::decompose(se);
+  Raster<std::decay_t<T>, N> out(in.shape(), in);
+  Internal::apply_segments<Internal::MinOp<std::decay_t<T>>>(out, decomposition);
+  Internal::apply_segments<Internal::MaxOp<std::decay_t<T>>>(out, decomposition.reflected());
+  return out;
+}
+
+/**
+ * @ingroup filtering
+ * @brief Compute the morphological closing, i.e. the erosion of the dilation.
+ * @see `opening()`
+ */
+template <typename T, Index N, typename THolder, typename TSe>
+Raster<std::decay_t<T>, N> closing(const Raster<T, N, THolder>& in, const TSe& se)
+{
+  const auto& decomposition = Internal::decompose(se);
+  Raster<std::decay_t<T>, N> out(in.shape(), in);
+  Internal::apply_segments<Internal::MaxOp<std::decay_t<T>>>(out, decomposition.reflected());
+  Internal::apply_segments<Internal::MinOp<std::decay_t<T>>>(out, decomposition);
+  return out;
+}
+
+/**
+ * @ingroup filtering
+ * @brief Compute the white top-hat, i.e. the input minus its opening.
+ *
+ * This extracts the bright structures which are smaller than the structuring element,
+ * e.g. stars over a smooth background.
+ */
+template <typename T, Index N, typename THolder, typename TSe>
+Raster<std::decay_t<T>, N> white_tophat(const Raster<T, N, THolder>& in, const TSe& se)
+{
+  auto out = opening(in, se);
+  out.generate(
+      [](auto i, auto o) {
+        return i - o;
+      },
+      in,
+      out);
+  return out;
+}
+
+/**
+ * @ingroup filtering
+ * @brief Compute the black top-hat, i.e. the closing minus the input.
+ *
+ * This extracts the dark structures which are smaller than the structuring element.
+ */
+template <typename T, Index N, typename THolder, typename TSe>
+Raster<std::decay_t<T>, N> black_tophat(const Raster<T, N, THolder>& in, const TSe& se)
+{
+  auto out = closing(in, se);
+  out -= in;
+  return out;
+}
+
+/**
+ * @ingroup filtering
+ * @brief Compute the morphological gradient, i.e. the dilation minus the erosion.
+ */
+template <typename T, Index N, typename THolder, typename TSe>
+Raster<std::decay_t<T>, N> morphological_gradient(const Raster<T, N, THolder>& in, const TSe& se)
+{
+  const auto& decomposition = Internal::decompose(se);
+  auto out = dilate(in, decomposition);
+  Raster<std::decay_t<T>, N> eroded(in.shape(), in);
+  Internal::apply_segments<Internal::MinOp<std::decay_t<T>>>(eroded, decomposition);
+  out -= eroded;
+  return out;
+}
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Get the greatest value which is lower than a given value.
+ */
+template <typename T>
+T previous(T value)
+{
+  if constexpr (std::is_floating_point_v<T>) {
+    return std::nextafter(value, -std::numeric_limits<T>::infinity());
+  } else {
+    return value == std::numeric_limits<T>::lowest() ? value : T(value - 1);
+  }
+}
+
+/**
+ * @brief Reconstruct a marker under or over some limit, in place, with Vincent's hybrid algorithm.
+ * @tparam TLess `std::less` for reconstruction by dilation, `std::greater` for reconstruction by erosion
+ *
+ * A forward and a backward raster scans propagate the values as far as possible along the scan directions,
+ * and the pixels which could still propagate their value are enqueued.
+ * The queue is then processed until stability, such that each pixel is touched only a few times.
+ */
+template <typename TLess, typename T, Index N, typename THolder, typename TLimit>
+void reconstruct(Raster<T, N, THolder>& out, const TLimit& limit, const Mask<N>& neighbors)
+{
+  const TLess less;
+  const auto extremum = [&](T lhs, T rhs) {
+    return less(lhs, rhs) ? rhs : lhs;
+  };
+  const auto clamp = [&](T value, T bound) {
+    return less(bound, value) ? bound : value;
+  };
+
+  const auto domain = out.domain();
+  const auto inner = domain - neighbors.box();
+  std::vector<Position<N>> backward;
+  std::vector<Position<N>> forward;
+  std::vector<Index> backward_offsets;
+  std::vector<Index> forward_offsets;
+  for (const auto& q : neighbors) {
+    Index offset = 0;
+    Index stride = 1;
+    for (Index i = 0; i < domain.dimension(); ++i) {
+      offset += q[i] * stride;
+      stride *= domain.length(i);
+    }
+    if (offset < 0) {
+      backward.push_back(q);
+      backward_offsets.push_back(offset);
+    } else if (offset > 0) {
+      forward.push_back(q);
+      forward_offsets.push_back(offset);
+    }
+  }
+
+  auto* data = out.data();
+  const auto* bounds = limit.data();
+  const auto scan = [&](const Position<N>& p, Index i, const auto& qs, const auto& offsets) {
+    auto value = data[i];
+    const bool is_inner = inner.contains(p);
+    for (std::size_t k = 0; k < qs.size(); ++k) {
+      if (is_inner || domain.contains(p + qs[k])) {
+        value = extremum(value, data[i + offsets[k]]);
+      }
+    }
+    data[i] = clamp(value, bounds[i]);
+  };
+
+  // Forward scan
+  Index i = 0;
+  for (const auto& p : domain) {
+    scan(p, i, backward, backward_offsets);
+    ++i;
+  }
+
+  // Backward scan
+  std::deque<Position<N>> queue;
+  auto p = domain.back();
+  for (i = domain.size() - 1; i >= 0; --i) {
+    scan(p, i, forward, forward_offsets);
+    const bool is_inner = inner.contains(p);
+    for (std::size_t k = 0; k < forward.size(); ++k) {
+      if (is_inner || domain.contains(p + forward[k])) {
+        const auto j = i + forward_offsets[k];
+        if (less(data[j], data[i]) && less(data[j], bounds[j])) {
+          queue.push_back(p);
+          break;
+        }
+      }
+    }
+    for (Index d = 0; d < domain.dimension(); ++d) { // Previous position
+      if (--p[d] >= domain.front()[d]) {
+        break;
+      }
+      p[d] = domain.back()[d];
+    }
+  }
+
+  // Propagation
+  while (not queue.empty()) {
+    const auto p = queue.front();
+    queue.pop_front();
+    const auto value = out[p];
+    const bool is_inner = inner.contains(p);
+    for (const auto& q : neighbors) {
+      const auto n = p + q;
+      if (is_inner || domain.contains(n)) {
+        auto& current = out[n];
+        const auto bound = limit[n];
+        if (less(current, value) && current != bound) {
+          current = clamp(value, bound);
+          queue.push_back(n);
+        }
+      }
+    }
+  }
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup filtering
+ * @brief Compute the morphological reconstruction by dilation of a marker under a limit.
+ * @param marker The marker raster
+ * @param limit The limit raster, of same shape as the marker
+ * @param neighbors The connectivity, e.g. `Mask<2>::ball<1>(1)` for 4-connectivity or `Mask<2>::from_center(1)` for 8-connectivity
+ *
+ * The reconstruction is the limit of the iterated geodesic dilations of the marker under the limit,
+ * i.e. `min(dilate(marker, neighbors), limit)` repeated until stability.
+ * It is computed exactly in near-linear time with Vincent's hybrid algorithm.
+ * The marker is first clamped to the limit, and the connectivity must be symmetric.
+ *
+ * For binary rasters, this selects the connected components of the limit which intersect the marker.
+ */
+template <typename T, Index N, typename THolder, typename TLimit>
+Raster<std::decay_t<T>, N> reconstruct_by_dilation(
+    const Raster<T, N, THolder>& marker,
+    const TLimit& limit,
+    const Mask<N>& neighbors = Mask<N>::template ball<1>(1))
+{
+  Raster<std::decay_t<T>, N> out(marker.shape(), marker);
+  Internal::reconstruct<std::less<std::decay_t<T>>>(out, limit, neighbors);
+  return out;
+}
+
+/**
+ * @ingroup filtering
+ * @brief Compute the morphological reconstruction by erosion of a marker over a limit.
+ * @see `reconstruct_by_dilation()`
+ */
+template <typename T, Index N, typename THolder, typename TLimit>
+Raster<std::decay_t<T>, N> reconstruct_by_erosion(
+    const Raster<T, N, THolder>& marker,
+    const TLimit& limit,
+    const Mask<N>& neighbors = Mask<N>::template ball<1>(1))
+{
+  Raster<std::decay_t<T>, N> out(marker.shape(), marker);
+  Internal::reconstruct<std::greater<std::decay_t<T>>>(out, limit, neighbors);
+  return out;
+}
+
+/**
+ * @ingroup filtering
+ * @brief Fill the holes of a raster, i.e. the regional minima which are not connected to the domain boundary.
+ *
+ * This is the reconstruction by erosion of the input from its boundary values.
+ * For binary rasters, this fills the background regions which are enclosed by the foreground.
+ */
+template <typename T, Index N, typename THolder>
+Raster<std::decay_t<T>, N>
+fill_holes(const Raster<T, N, THolder>& in, const Mask<N>& neighbors = Mask<N>::template ball<1>(1))
+{
+  using Value = std::decay_t<T>;
+  Raster<Value, N> out(in.shape(), in);
+  const auto inner = in.domain() - Box<N>::from_center(1);
+  for (const auto& p : inner) {
+    out[p] = Internal::MinOp<Value>::identity();
+  }
+  Internal::reconstruct<std::greater<Value>>(out, in, neighbors);
+  return out;
+}
+
+/**
+ * @ingroup filtering
+ * @brief Detect the regional maxima of a raster.
+ *
+ * A regional maximum is a connected plateau whose neighbors are all strictly lower.
+ * Regional maxima are the pixels where the input is higher than the reconstruction by dilation
+ * of the input lowered by the smallest representable amount.
+ */
+template <typename T, Index N, typename THolder>
+Raster<bool, N>
+regional_maxima(const Raster<T, N, THolder>& in, const Mask<N>& neighbors = Mask<N>::template ball<1>(1))
+{
+  using Value = std::decay_t<T>;
+  Raster<Value, N> reconstructed(in.shape());
+  reconstructed.generate(
+      [](auto v) {
+        return Internal::previous(v);
+      },
+      in);
+  Internal::reconstruct<std::less<Value>>(reconstructed, in, neighbors);
+  Raster<bool, N> out(in.shape());
+  out.generate(
+      [](auto v, auto r) {
+        return r < v;
+      },
+      in,
+      reconstructed);
+  return out;
+}
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,180 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_NONLOCALMEANS_H
+#define _LINXTRANSFORMS_NONLOCALMEANS_H
+
+#include "Linx/Base/TypeUtils.h"
+#include "Linx/Data/Decomposition.h"
+#include "Linx/Data/Raster.h"
+#include "Linx/Transforms/LocalMoments.h"
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Get the position of the nearest pixel in a box.
+ */
+template <Index N>
+Position<N> nearest(Position<N> position, const Box<N>& box)
+{
+  for (Index i = 0; i < box.dimension(); ++i) {
+    position[i] = std::clamp(position[i], box.front()[i], box.back()[i]);
+  }
+  return position;
+}
+
+/**
+ * @brief Apply a function to each line of a box along axis 0 and the same line in a shifted copy of a raster.
+ *
+ * The function is called as `func(index, in, shifted)` for each pixel,
+ * where `index` runs through the box in row-major ordering,
+ * `in` is the input value and `shifted` the input value at the position shifted by `offset`,
+ * extrapolated with the nearest-neighbor method.
+ */
+template <typename T, Index N, typename THolder, typename TFunc>
+void for_each_shifted(const Raster<T, N, THolder>& in, const Box<N>& box, const Position<N>& offset, TFunc&& func)
+{
+  const auto domain = in.domain();
+  const auto x_front = box.front()[0];
+  const auto x_back = box.back()[0];
+  const auto x_max = domain.back()[0];
+  const auto dx = offset[0];
+  auto rows_back = box.back();
+  rows_back[0] = x_front;
+  Index index = 0;
+  for (auto row : Box<N>(box.front(), rows_back)) {
+    const auto* center = &in[row];
+    auto shifted_row = nearest(row + offset, domain);
+    shifted_row[0] = 0;
+    const auto* shifted = &in[shifted_row];
+    for (Index x = x_front; x <= x_back; ++x, ++center, ++index) {
+      func(index, *center, shifted[std::clamp<Index>(x + dx, 0, x_max)]);
+    }
+  }
+}
+
+/**
+ * @brief Denoise a part of a raster with the non-local means, given the halo of the part.
+ *
+ * The part must be contiguous in the halo, which is the case for slabs.
+ */
+template <typename TOut, typename T, Index N, typename THolder>
+void non_local_means_part(
+    const Raster<T, N, THolder>& in,
+    const Box<N>& part,
+    const Box<N>& halo,
+    const Box<N>& patch,
+    const Box<N>& search,
+    double h,
+    double sigma,
+    Raster<TOut, N>& out)
+{
+  const double inv_h2 = 1. / (h * h);
+  const double bias = 2. * sigma * sigma;
+
+  // Running sums over long lines followed by differences cancel out small distances in single precision
+  Raster<double, N> inv_counts(halo.shape());
+  inv_counts.fill(1);
+  Internal::box_sums(inv_counts, patch);
+  inv_counts.apply([=](auto c) {
+    return inv_h2 / c;
+  });
+
+  Raster<double, N> distances(halo.shape());
+  Raster<TOut, N> numerator(part.shape());
+  Raster<TOut, N> denominator(part.shape());
+  numerator.fill(0);
+  denominator.fill(0);
+  auto* dist = distances.data();
+  auto* num = numerator.data();
+  auto* den = denominator.data();
+  const Index part_offset = distances.index(part.front() - halo.front());
+  const auto* inv_count = inv_counts.data() + part_offset;
+  const auto* part_dist = dist + part_offset;
+  const auto scaled_bias = bias * inv_h2;
+
+  for (const auto& d : search) {
+    for_each_shifted(in, halo, d, [&](Index i, TOut v, TOut shifted) {
+      const auto diff = double(v) - shifted;
+      dist[i] = diff * diff;
+    });
+    Internal::box_sums(distances, patch);
+    for_each_shifted(in, part, d, [&](Index i, TOut, TOut shifted) {
+      const TOut w = std::exp(-std::max(part_dist[i] * inv_count[i] - scaled_bias, 0.));
+      num[i] += w * shifted;
+      den[i] += w;
+    });
+  }
+
+  const auto* num_it = num;
+  const auto* den_it = den;
+  for (auto it = &out[part.front()], end = &out[part.back()] + 1; it != end; ++it, ++num_it, ++den_it) {
+    *it = *num_it / *den_it;
+  }
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup filtering
+ * @brief Denoise a raster with the non-local means.
+ * @param in The input raster
+ * @param patch The patch window, e.g. `Box<2>::from_center(3)` for 7x7 patches
+ * @param search The search window, e.g. `Box<2>::from_center(10)`
+ * @param h The filtering parameter, in units of the input values
+ * @param sigma The noise standard deviation, which is subtracted from the patch distances
+ *
+ * Each output pixel is a weighted mean of the input pixels in the search window,
+ * where the weights decrease with the mean squared distance between the patches centered on both pixels,
+ * as `exp(-max(distance - 2 sigma^2, 0) / h^2)`.
+ * Out-of-domain pixels are extrapolated with the nearest-neighbor method,
+ * and patches are clipped to the domain.
+ *
+ * Instead of comparing patches pixel by pixel, the squared differences between the input and its shifted copy
+ * are computed once per search offset, and summed over the patches with running sums (Darbon et al.),
+ * such that the cost is proportional to the search window size but independent from the patch size.
+ * To limit cancellation in the running sums, patch distances are accumulated in double precision.
+ *
+ * The domain is split into slabs which are processed in parallel if OpenMP is enabled.
+ */
+template <typename T, Index N, typename THolder>
+Raster<typename TypeTraits<std::decay_t<T>>::Floating, N> non_local_means(
+    const Raster<T, N, THolder>& in,
+    const Box<N>& patch,
+    const Box<N>& search,
+    double h,
+    double sigma = 0)
+{
+  using Value = typename TypeTraits<std::decay_t<T>>::Floating;
+  Raster<Value, N> out(in.shape());
+  const auto domain = in.domain();
+  const auto last = domain.dimension() - 1;
+  constexpr Index thickness = 32; // Slabs are thin enough for the working rasters to fit in cache
+  Index count = (domain.length(last) + thickness - 1) / thickness;
+#ifdef _OPENMP
+  count = std::max<Index>(count, omp_get_max_threads() * 4);
+#endif
+  count = std::min(count, domain.length(last));
+  const SlabDecomposition<N> slabs(domain, patch, count);
+#pragma omp parallel for schedule(dynamic)
+  for (Index i = 0; i < slabs.size(); ++i) {
+    Internal::non_local_means_part(in, slabs.part(i), slabs.halo(i), patch, search, h, sigma, out);
+  }
+  return out;
+}
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,330 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_RADIALPROFILE_H
+#define _LINXTRANSFORMS_RADIALPROFILE_H
+
+#include "Linx/Base/TypeUtils.h"
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Raster.h"
+#include "Linx/Data/Vector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace Linx {
+
+/**
+ * @ingroup filtering
+ * @brief Radial profiles of a set of stamps.
+ * @tparam T The output value type
+ *
+ * Each raster is indexed as `[{bin, stamp}]`.
+ */
+template <typename T>
+struct RadialStatistics {
+  /**
+   * @brief The sums of the valid values.
+   */
+  Raster<double, 2> sum;
+
+  /**
+   * @brief The numbers of valid values.
+   */
+  Raster<Index, 2> count;
+
+  /**
+   * @brief The medians of the valid values.
+   */
+  Raster<T, 2> median;
+
+  /**
+   * @brief Compute the means of the valid values.
+   *
+   * Means are NaN where the count is null.
+   */
+  Raster<T, 2> mean() const
+  {
+    Raster<T, 2> out(sum.shape());
+    std::transform(sum.begin(), sum.end(), count.begin(), out.begin(), [](auto s, auto c) {
+      return c > 0 ? T(s / c) : std::numeric_limits<T>::quiet_NaN();
+    });
+    return out;
+  }
+};
+
+/**
+ * @ingroup filtering
+ * @brief Radial binning engine, which computes azimuthal statistics of stamps around a fixed center.
+ * @tparam T The input value type
+ * @tparam N The dimension
+ *
+ * The ring index of each pixel of the stamp shape is computed once at construction,
+ * where ring `b` gathers the pixels whose distance to the center lies in `[b * width, (b + 1) * width)`.
+ * Pixels beyond the last ring are ignored.
+ *
+ * The statistics of a stamp are then computed in a single pass over its values, without distance computation:
+ * each valid value is accumulated into the sum of its ring and written into a ring-contiguous workspace,
+ * from which the medians are selected.
+ * NaNs are considered invalid and ignored.
+ * Stamps of a set are processed in parallel if OpenMP is enabled, each thread owning its workspace.
+ *
+ * \code
+ * RadialProfile<float> engine({31, 31}, 1., 15);
+ * std::vector<Raster<float>> stamps = ...;
+ * auto profiles = engine(stamps);
+ * auto ee = profiles.sum; // Per-ring encircled energy
+ * auto psf = profiles.median;
+ * \endcode
+ */
+template <typename T, Index N = 2>
+class RadialProfile {
+public:
+
+  /**
+   * @brief The value type.
+   */
+  using Value = T;
+
+  /**
+   * @brief The output type.
+   */
+  using Floating = typename TypeTraits<T>::Floating;
+
+  /**
+   * @brief The dimension parameter.
+   */
+  static constexpr Index Dimension = N;
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Constructor.
+   * @param shape The stamp shape
+   * @param center The center, relative to the stamp front
+   * @param width The ring width
+   * @param bin_count The number of rings, or 0 to cover the whole stamp
+   */
+  RadialProfile(const Position<N>& shape, const Vector<double, N>& center, double width = 1, Index bin_count = 0) :
+      m_shape(shape), m_width(width), m_bins(shape_size(shape)), m_offsets()
+  {
+    const Index dim = shape.size();
+    double max_radius = 0;
+    auto it = m_bins.begin();
+    for (const auto& p : Box<N>::from_shape(shape)) {
+      double r2 = 0;
+      for (Index i = 0; i < dim; ++i) {
+        const auto d = p[i] - center[i];
+        r2 += d * d;
+      }
+      const auto r = std::sqrt(r2);
+      max_radius = std::max(max_radius, r);
+      *it = static_cast<Index>(r / m_width);
+      ++it;
+    }
+    if (bin_count <= 0) {
+      bin_count = static_cast<Index>(max_radius / m_width) + 1;
+    }
+    m_offsets.assign(bin_count + 1, 0);
+    for (auto& b : m_bins) {
+      if (b >= bin_count) {
+        b = -1;
+      } else {
+        ++m_offsets[b + 1];
+      }
+    }
+    for (Index b = 0; b < bin_count; ++b) {
+      m_offsets[b + 1] += m_offsets[b];
+    }
+  }
+
+  /**
+   * @brief Constructor with the center at the middle of the stamp, i.e. at `(shape - 1) / 2`.
+   */
+  explicit RadialProfile(const Position<N>& shape, double width = 1, Index bin_count = 0) :
+      RadialProfile(shape, center_of(shape), width, bin_count)
+  {}
+
+  /// @group_properties
+
+  /**
+   * @brief Get the stamp shape.
+   */
+  const Position<N>& shape() const
+  {
+    return m_shape;
+  }
+
+  /**
+   * @brief Get the ring width.
+   */
+  double width() const
+  {
+    return m_width;
+  }
+
+  /**
+   * @brief Get the number of rings.
+   */
+  Index bin_count() const
+  {
+    return m_offsets.size() - 1;
+  }
+
+  /**
+   * @brief Get the ring index of each pixel, or -1 for pixels beyond the last ring.
+   */
+  const std::vector<Index>& bins() const
+  {
+    return m_bins;
+  }
+
+  /**
+   * @brief Get the number of pixels in a ring.
+   */
+  Index area(Index bin) const
+  {
+    return m_offsets[bin + 1] - m_offsets[bin];
+  }
+
+  /// @group_operations
+
+  /**
+   * @brief Compute the statistics of a single stamp.
+   * @param stamp The stamp, e.g. a raster or a box patch, whose shape is `shape()`
+   * @param sums The output sums, of size `bin_count()`
+   * @param counts The output numbers of valid values, of size `bin_count()`
+   * @param medians The output medians, of size `bin_count()`
+   * @param workspace A buffer, resized as needed, which can be reused across calls
+   *
+   * @throw SizeError if the stamp size differs from that of `shape()`
+   */
+  template <typename TIn>
+  void apply(const TIn& stamp, double* sums, Index* counts, Floating* medians, std::vector<T>& workspace) const
+  {
+    SizeError::may_throw(stamp.size(), m_bins.size());
+    const auto bin_count = this->bin_count();
+    workspace.resize(m_offsets.back());
+    std::copy(m_offsets.begin(), m_offsets.end() - 1, counts); // Write cursors
+    std::fill(sums, sums + bin_count, 0.);
+    auto bin = m_bins.begin();
+    for (const auto& v : stamp) {
+      const auto b = *bin;
+      ++bin;
+      if (b < 0 || not(v == v)) {
+        continue;
+      }
+      sums[b] += v;
+      workspace[counts[b]] = v;
+      ++counts[b];
+    }
+    for (Index b = 0; b < bin_count; ++b) {
+      auto* begin = workspace.data() + m_offsets[b];
+      auto* end = workspace.data() + counts[b];
+      counts[b] -= m_offsets[b];
+      medians[b] = median(begin, end);
+    }
+  }
+
+  /**
+   * @brief Compute the statistics of a set of stamps.
+   * @param stamps A random-access range of stamps, e.g. rasters or box patches, whose shape is `shape()`
+   *
+   * @throw SizeError if the size of some stamp differs from that of `shape()`
+   */
+  template <typename TStamps>
+  RadialStatistics<Floating> operator()(const TStamps& stamps) const
+  {
+    const auto bin_count = this->bin_count();
+    const auto stamp_count = static_cast<Index>(std::distance(std::begin(stamps), std::end(stamps)));
+    const Position<2> shape {bin_count, stamp_count};
+    for (const auto& stamp : stamps) { // Checked beforehand because exceptions cannot escape the parallel region
+      SizeError::may_throw(stamp.size(), m_bins.size());
+    }
+    RadialStatistics<Floating> out {Raster<double, 2>(shape), Raster<Index, 2>(shape), Raster<Floating, 2>(shape)};
+    const auto begin = std::begin(stamps);
+
+#pragma omp parallel
+    {
+      std::vector<T> workspace;
+#pragma omp for schedule(dynamic)
+      for (Index s = 0; s < stamp_count; ++s) {
+        const auto offset = s * bin_count;
+        apply(
+            *(begin + s),
+            out.sum.data() + offset,
+            out.count.data() + offset,
+            out.median.data() + offset,
+            workspace);
+      }
+    }
+    return out;
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief Get the middle of a shape.
+   */
+  static Vector<double, N> center_of(const Position<N>& shape)
+  {
+    const Index dim = shape.size();
+    Vector<double, N> out(dim);
+    for (Index i = 0; i < dim; ++i) {
+      out[i] = (shape[i] - 1) * .5;
+    }
+    return out;
+  }
+
+  /**
+   * @brief Compute the median of a range, in place.
+   */
+  static Floating median(T* begin, T* end)
+  {
+    const auto size = end - begin;
+    if (size == 0) {
+      return std::numeric_limits<Floating>::quiet_NaN();
+    }
+    auto* n = begin + size / 2;
+    std::nth_element(begin, n, end);
+    if (size % 2 == 1) {
+      return *n;
+    }
+    const auto lower = *std::max_element(begin, n);
+    return (Floating(lower) + Floating(*n)) * .5;
+  }
+
+  /**
+   * @brief The stamp shape.
+   */
+  Position<N> m_shape;
+
+  /**
+   * @brief The ring width.
+   */
+  double m_width;
+
+  /**
+   * @brief The ring index of each pixel.
+   */
+  std::vector<Index> m_bins;
+
+  /**
+   * @brief The index of the first pixel of each ring in the workspace, and the workspace size.
+   */
+  std::vector<Index> m_offsets;
+};
+
+} // namespace Linx
+
+#endif
@@ -211,18 +211,68 @@ private:
     // FIXME accept any region
     auto patch = in.parent()(extend<TIn::Dimension>(window_impl()));
     auto out_it = out.begin();
-    for (const auto& p : in.domain()) { // FIXME loop over out for a simpler sentinel?
-      if constexpr (Internal::KernelShiftsWindow<TKernel>::value) { // FIXME ugly
+    if constexpr (Internal::KernelShiftsWindow<TKernel>::value) { // FIXME ugly
+      for (const auto& p : in.domain()) {
         *out_it = m_kernel(in, patch, p);
-      } else {
+        ++out_it;
+      }
+    } else {
+      // Translate the window once per row, and slide it along the row
+      const auto& domain = in.domain();
+      const auto width = domain.length(0);
+      const auto step = row_step(domain);
+      for (const auto& p : row_fronts(domain)) {
         patch >>= p;
-        *out_it = m_kernel(patch);
+        for (Index x = 0; x < width; ++x, ++out_it) {
+          *out_it = m_kernel(patch);
+          patch.slide(step);
+        }
+        patch.slide(-width * step);
         patch <<= p;
       }
-      ++out_it;
     }
   }
 
+  /**
+   * @brief Get the step along axis 0 of a box, i.e. 1.
+   */
+  template <Index N>
+  static Index row_step(const Box<N>&)
+  {
+    return 1;
+  }
+
+  /**
+   * @brief Get the step along axis 0 of a grid.
+   */
+  template <Index N>
+  static Index row_step(const Grid<N>& domain)
+  {
+    return domain.step()[0];
+  }
+
+  /**
+   * @brief Get the region of the row fronts of a box.
+   */
+  template <Index N>
+  static Box<N> row_fronts(const Box<N>& domain)
+  {
+    auto back = domain.back();
+    back[0] = domain.front()[0];
+    return {domain.front(), back};
+  }
+
+  /**
+   * @brief Get the region of the row fronts of a grid.
+   */
+  template <Index N>
+  static Grid<N> row_fronts(const Grid<N>& domain)
+  {
+    auto back = domain.back();
+    back[0] = domain.front()[0];
+    return {{domain.front(), back}, domain.step()};
+  }
+
 private:
 
   /**
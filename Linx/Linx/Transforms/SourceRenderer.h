@@ -0,0 +1,269 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_SOURCERENDERER_H
+#define _LINXTRANSFORMS_SOURCERENDERER_H
+
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Raster.h"
+#include "Linx/Transforms/Extrapolation.h"
+#include "Linx/Transforms/Interpolation.h"
+
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace Linx {
+
+/**
+ * @ingroup resampling
+ * @brief Renderer of point sources, e.g. stars, into a frame.
+ * @tparam T The value type
+ *
+ * Sources are given as lists of positions and fluxes, and are rendered additively with a common PSF,
+ * which is either a sampled raster or an analytic function.
+ *
+ * The PSF is truncated to a window, and sampled once at construction for each sub-pixel phase,
+ * i.e. each fraction `k / oversampling` of a pixel along each axis, into a bank of normalized kernels.
+ * Sources are then placed at the nearest phase, and rendering a source simply consists in adding
+ * its flux times the kernel of its phase, over the intersection of the window with the frame.
+ * No function is evaluated nor interpolated per source.
+ *
+ * The frame is split into tiles, and sources are binned into the tiles which their window overlaps.
+ * Tiles are then rendered in parallel if OpenMP is enabled,
+ * each thread accumulating directly into its own tiles, such that no lock nor frame-size buffer is needed.
+ *
+ * Pixel centers are at integer coordinates.
+ *
+ * \code
+ * SourceRenderer<float> renderer(psf, 8);
+ * Raster<float> frame(shape);
+ * frame.fill(background);
+ * renderer.render(frame, positions, fluxes);
+ * \endcode
+ */
+template <typename T>
+class SourceRenderer {
+public:
+
+  /**
+   * @brief The value type.
+   */
+  using Value = T;
+
+  /**
+   * @brief The default tile side.
+   */
+  static constexpr Index TileSide = 256;
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Constructor from a sampled PSF.
+   * @param psf The PSF, centered at `psf.shape() / 2`
+   * @param oversampling The number of sub-pixel phases along each axis
+   *
+   * Shifted kernels are computed by linear interpolation of the PSF,
+   * such that the window is one pixel larger than the PSF along each axis.
+   */
+  explicit SourceRenderer(const Raster<T>& psf, Index oversampling = 4) :
+      m_oversampling(oversampling), m_window(-(psf.shape() / 2), psf.shape() - psf.shape() / 2), m_kernels()
+  {
+    const auto center = psf.shape() / 2;
+    const auto extrapolated = extrapolation(psf, T(0));
+    const auto interpolated = interpolation<Linear>(extrapolated);
+    sample([&](double x, double y) {
+      return interpolated(Vector<double, 2>({x + center[0], y + center[1]}));
+    });
+  }
+
+  /**
+   * @brief Constructor from an analytic PSF.
+   * @param radius The radius of the truncation window
+   * @param psf The PSF function, called as `psf(dx, dy)` with the offsets from the source position
+   * @param oversampling The number of sub-pixel phases along each axis
+   *
+   * The function is evaluated at the pixel centers, i.e. it is not integrated over the pixels.
+   */
+  template <typename TFunc>
+  SourceRenderer(Index radius, TFunc&& psf, Index oversampling = 4) :
+      m_oversampling(oversampling), m_window(Position<2>::one() * -radius, Position<2>::one() * (radius + 1)),
+      m_kernels()
+  {
+    sample(LINX_FORWARD(psf));
+  }
+
+  /// @group_properties
+
+  /**
+   * @brief Get the number of sub-pixel phases along each axis.
+   */
+  Index oversampling() const
+  {
+    return m_oversampling;
+  }
+
+  /**
+   * @brief Get the truncation window, relative to the pixel which contains the source.
+   */
+  const Box<2>& window() const
+  {
+    return m_window;
+  }
+
+  /**
+   * @brief Get the kernel of given sub-pixel phases.
+   * @param x The phase index along the first axis, in `[0, oversampling)`
+   * @param y The phase index along the second axis, in `[0, oversampling)`
+   *
+   * The kernel is the PSF shifted by `(x, y) / oversampling`, sampled over the window, and normalized to unit sum.
+   */
+  const Raster<T>& kernel(Index x, Index y) const
+  {
+    return m_kernels[y * m_oversampling + x];
+  }
+
+  /// @group_operations
+
+  /**
+   * @brief Render sources into a frame.
+   * @param frame The frame, into which the sources are added
+   * @param positions The source positions, e.g. a sequence of `Vector<double, 2>`
+   * @param fluxes The source fluxes
+   * @param tile_shape The shape of the tiles which are rendered in parallel
+   *
+   * Sources whose flux is null or NaN, or whose window does not overlap the frame, are skipped.
+   */
+  template <typename THolder, typename TPositions, typename TFluxes>
+  void render(
+      Raster<T, 2, THolder>& frame,
+      const TPositions& positions,
+      const TFluxes& fluxes,
+      Position<2> tile_shape = Position<2>::one() * TileSide) const
+  {
+    const auto domain = frame.domain();
+    Position<2> grid_shape;
+    for (Index i = 0; i < 2; ++i) {
+      tile_shape[i] = std::max<Index>(std::min(tile_shape[i], frame.length(i)), 1);
+      grid_shape[i] = (frame.length(i) + tile_shape[i] - 1) / tile_shape[i];
+    }
+
+    // Place the sources and bin them into the tiles
+    const Index count = std::distance(std::begin(positions), std::end(positions));
+    std::vector<Stamp> stamps;
+    stamps.reserve(count);
+    std::vector<std::vector<Index>> bins(shape_size(grid_shape));
+    auto flux_it = std::begin(fluxes);
+    for (const auto& position : positions) {
+      const T flux = *flux_it;
+      ++flux_it;
+      if (flux == 0 || not(flux == flux)) {
+        continue;
+      }
+      Stamp stamp;
+      stamp.flux = flux;
+      for (Index i = 0; i < 2; ++i) {
+        const auto n = static_cast<Index>(std::lround(position[i] * m_oversampling));
+        stamp.pixel[i] = n >= 0 ? n / m_oversampling : -((-n + m_oversampling - 1) / m_oversampling);
+        stamp.phase[i] = n - stamp.pixel[i] * m_oversampling;
+      }
+      const auto box = (m_window + stamp.pixel) & domain;
+      if (box.length(0) <= 0 || box.length(1) <= 0) {
+        continue;
+      }
+      const auto index = static_cast<Index>(stamps.size());
+      stamps.push_back(stamp);
+      for (Index ty = box.front()[1] / tile_shape[1]; ty <= box.back()[1] / tile_shape[1]; ++ty) {
+        for (Index tx = box.front()[0] / tile_shape[0]; tx <= box.back()[0] / tile_shape[0]; ++tx) {
+          bins[ty * grid_shape[0] + tx].push_back(index);
+        }
+      }
+    }
+
+    // Render the tiles
+    const auto tile_count = static_cast<Index>(bins.size());
+#pragma omp parallel for schedule(dynamic)
+    for (Index t = 0; t < tile_count; ++t) {
+      const Position<2> tile_front {t % grid_shape[0] * tile_shape[0], t / grid_shape[0] * tile_shape[1]};
+      const auto tile = Box<2>::from_shape(tile_front, tile_shape) & domain;
+      for (auto s : bins[t]) {
+        const auto& stamp = stamps[s];
+        const auto& k = kernel(stamp.phase[0], stamp.phase[1]);
+        const auto box = (m_window + stamp.pixel) & tile;
+        const auto offset = stamp.pixel + m_window.front();
+        const auto width = box.length(0);
+        for (Index y = box.front()[1]; y <= box.back()[1]; ++y) {
+          auto* out = &frame[{box.front()[0], y}];
+          const auto* in = &k[{box.front()[0] - offset[0], y - offset[1]}];
+          for (Index x = 0; x < width; ++x) {
+            out[x] += stamp.flux * in[x];
+          }
+        }
+      }
+    }
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief A source placed on the kernel grid.
+   */
+  struct Stamp {
+    Position<2> pixel; ///< The pixel which contains the source
+    Position<2> phase; ///< The sub-pixel phase indices
+    T flux; ///< The flux
+  };
+
+  /**
+   * @brief Sample the kernels of all the phases.
+   */
+  template <typename TFunc>
+  void sample(TFunc&& psf)
+  {
+    m_kernels.reserve(m_oversampling * m_oversampling);
+    for (Index py = 0; py < m_oversampling; ++py) {
+      for (Index px = 0; px < m_oversampling; ++px) {
+        const auto dx = double(px) / m_oversampling;
+        const auto dy = double(py) / m_oversampling;
+        Raster<T> kernel(m_window.shape());
+        auto it = kernel.begin();
+        for (const auto& p : m_window) {
+          *it = psf(p[0] - dx, p[1] - dy);
+          ++it;
+        }
+        const auto sum = std::accumulate(kernel.begin(), kernel.end(), T(0));
+        if (sum != 0) {
+          kernel /= sum;
+        }
+        m_kernels.push_back(LINX_MOVE(kernel));
+      }
+    }
+  }
+
+  /**
+   * @brief The number of sub-pixel phases along each axis.
+   */
+  Index m_oversampling;
+
+  /**
+   * @brief The truncation window.
+   */
+  Box<2> m_window;
+
+  /**
+   * @brief The kernels, indexed as `[y * oversampling + x]`.
+   */
+  std::vector<Raster<T>> m_kernels;
+};
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,149 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_STARLET_H
+#define _LINXTRANSFORMS_STARLET_H
+
+#include "Linx/Base/TypeUtils.h"
+#include "Linx/Data/Raster.h"
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <vector>
+
+namespace Linx {
+
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Get the index of the mirror element of a possibly out-of-bounds index, without edge repetition.
+ */
+inline Index mirror(Index i, Index length)
+{
+  if (length == 1) {
+    return 0;
+  }
+  const auto period = 2 * (length - 1);
+  i %= period;
+  if (i < 0) {
+    i += period;
+  }
+  return i < length ? i : period - i;
+}
+
+/**
+ * @brief Convolve a raster in place with the separable B3-spline kernel, dilated by a given step.
+ *
+ * The 1D kernel is `{1, 4, 6, 4, 1} / 16`, with `step - 1` holes between the coefficients.
+ * Boundaries are mirrored.
+ * Lines are processed by chunks of contiguous lines, in parallel if OpenMP is enabled.
+ */
+template <typename T, Index N, typename THolder>
+void b3_spline_smooth(Raster<T, N, THolder>& raster, Index step)
+{
+  constexpr std::array<double, 5> weights {1. / 16., 4. / 16., 6. / 16., 4. / 16., 1. / 16.};
+  constexpr Index chunk = 64;
+  auto* data = raster.data();
+  const auto size = static_cast<Index>(raster.size());
+  Index stride = 1;
+  for (Index a = 0; a < raster.dimension(); ++a) {
+    const auto length = raster.length(a);
+    const auto width = std::min(chunk, stride);
+    const auto chunks_per_block = (stride + width - 1) / width;
+    const auto task_count = size / (stride * length) * chunks_per_block;
+#pragma omp parallel
+    {
+      std::vector<T> buffer(length * width);
+#pragma omp for
+      for (Index t = 0; t < task_count; ++t) {
+        const auto block = t / chunks_per_block * stride * length;
+        const auto first = t % chunks_per_block * width;
+        const auto count = std::min(width, stride - first);
+        auto* ptr = data + block + first;
+        for (Index j = 0; j < length; ++j) {
+          std::copy_n(ptr + j * stride, count, &buffer[j * width]);
+        }
+        for (Index j = 0; j < length; ++j) {
+          std::array<const T*, 5> taps;
+          for (Index k = 0; k < 5; ++k) {
+            taps[k] = &buffer[mirror(j + (k - 2) * step, length) * width];
+          }
+          auto* out = ptr + j * stride;
+          for (Index c = 0; c < count; ++c) {
+            out[c] = weights[0] * taps[0][c] + weights[1] * taps[1][c] + weights[2] * taps[2][c] +
+                weights[3] * taps[3][c] + weights[4] * taps[4][c];
+          }
+        }
+      }
+    }
+    stride *= length;
+  }
+}
+
+} // namespace Internal
+/// @endcond
+
+/**
+ * @ingroup filtering
+ * @brief Compute the starlet transform, i.e. the isotropic undecimated wavelet transform.
+ * @param in The input raster
+ * @param scale_count The number of wavelet scales
+ * @return A raster of dimension `N + 1`, whose sections along the last axis are
+ * the wavelet scales from finest to coarsest, followed by the coarse (smoothed) raster
+ *
+ * Smoothed rasters are computed with the à trous algorithm:
+ * the raster at scale `j + 1` is obtained by convolving the raster at scale `j`
+ * with the separable B3-spline kernel dilated by `2^j`, and the wavelet coefficients are the differences.
+ * Boundaries are mirrored.
+ *
+ * The smoothing is performed in place in the output, along each axis in turn,
+ * such that no raster is allocated besides the output,
+ * and it is parallelized over lines if OpenMP is enabled.
+ *
+ * The input is recovered by summing the sections, see `inverse_starlet()`.
+ */
+template <typename T, Index N, typename THolder>
+Raster<typename TypeTraits<std::decay_t<T>>::Floating, N + 1> starlet(const Raster<T, N, THolder>& in, Index scale_count)
+{
+  using Value = typename TypeTraits<std::decay_t<T>>::Floating;
+  const auto shape = extend<N + 1>(in.shape(), Position<N + 1>::one() * (scale_count + 1));
+  Raster<Value, N + 1> out(shape);
+  std::copy(in.begin(), in.end(), out.begin());
+  Index step = 1;
+  for (Index j = 0; j < scale_count; ++j) {
+    auto current = out.section(j);
+    auto next = out.section(j + 1);
+    std::copy(current.begin(), current.end(), next.begin());
+    Internal::b3_spline_smooth(next, step);
+    current -= next;
+    step *= 2;
+  }
+  return out;
+}
+
+/**
+ * @ingroup filtering
+ * @brief Reconstruct a raster from its starlet transform.
+ *
+ * This is the sum of the wavelet scales and coarse raster, i.e. of the sections of the transform.
+ * Scales can be thresholded or weighted beforehand, e.g. for denoising.
+ */
+template <typename T, Index N, typename THolder>
+Raster<std::decay_t<T>, N - 1> inverse_starlet(const Raster<T, N, THolder>& scales)
+{
+  const auto count = scales.length(N - 1);
+  const auto first = scales.section(0);
+  Raster<std::decay_t<T>, N - 1> out(first.shape(), first);
+  for (Index j = 1; j < count; ++j) {
+    const auto section = scales.section(j);
+    std::transform(out.begin(), out.end(), section.begin(), out.begin(), std::plus<std::decay_t<T>>());
+  }
+  return out;
+}
+
+} // namespace Linx
+
+#endif
@@ -7,6 +7,8 @@
 
 #include "Linx/Data/Raster.h"
 
+#include <cmath>
+
 namespace Linx {
 
 /**
@@ -63,6 +65,8 @@ struct Nearest {
 
   /**
    * @brief Return the value at the nearest integer position.
+   *
+   * Half-integers are rounded up, including negative ones, consistently with the separable translation.
    */
   template <typename T, typename TRaster>
   inline T at(TRaster& raster, const Vector<double, TRaster::Dimension>& position) const
@@ -70,7 +74,7 @@ struct Nearest {
     Position<TRaster::Dimension> integral(position.size());
     integral.generate(
         [](auto e) {
-          return e + .5; // FIXME std::round?
+          return std::floor(e + .5);
         },
         position);
     return raster[integral];
@@ -98,6 +102,32 @@ struct Periodic {
   }
 };
 
+/**
+ * @ingroup resampling
+ * @brief Reflective, a.k.a. half-sample symmetric, boundary conditions.
+ *
+ * Values are mirrored about the domain edges, which are repeated, e.g. `c b a | a b c | c b a`.
+ * This is the `'reflect'` mode of `scipy.ndimage`.
+ */
+struct Reflect {
+  /**
+   * @brief Return the value at the mirrored position.
+   */
+  template <typename TRaster>
+  inline const typename TRaster::value_type& at(TRaster& raster, Position<TRaster::Dimension> position) const
+  {
+    position.apply(
+        [](auto p, auto s) {
+          const auto period = 2 * s;
+          auto q = p % period;
+          q = q < 0 ? q + period : q; // Positive modulo
+          return q < s ? q : period - 1 - q;
+        },
+        raster.shape());
+    return raster[position];
+  }
+};
+
 /**
  * @ingroup resampling
  * @brief Linear interpolation.
@@ -8,11 +8,29 @@
 #include "Linx/Data/BorderedBox.h"
 #include "Linx/Data/Box.h"
 #include "Linx/Data/Grid.h"
+#include "Linx/Data/Ordering.h"
 #include "Linx/Data/Raster.h"
 #include "Linx/Transforms/Extrapolation.h"
 
 namespace Linx {
 
+/// @cond
+namespace Internal {
+
+/**
+ * @brief Reallocate a raster if its shape does not match a given shape.
+ */
+template <typename T, Index N>
+void reuse(Raster<T, N>& raster, const Position<N>& shape)
+{
+  if (raster.shape() != shape) {
+    raster = Raster<T, N>(shape);
+  }
+}
+
+} // namespace Internal
+/// @endcond
+
 /**
  * @ingroup filtering
  * @brief Spatial filtering mixin.
@@ -55,12 +73,74 @@ public:
 
   /**
    * @brief Apply the filter into a given output.
+   * 
+   * If instrumentation is enabled, the traffic is estimated as
+   * the window size times the input value size for each output element read,
+   * and the output value size for each output element written.
    */
   template <typename TIn, typename TOut>
   inline void transform(const TIn& in, TOut& out) const
   {
     // FIXME make applicable to Sequence<Position>?
     LINX_CRTP_CONST_DERIVED.transform_impl(in, out);
+    if constexpr (Instrumentation::enabled()) {
+      const std::size_t size = std::distance(out.begin(), out.end());
+      instrument_traffic(
+          size * window().size() * sizeof(typename TIn::Value),
+          size * sizeof(std::decay_t<decltype(*out.begin())>));
+    }
+  }
+
+  /**
+   * @brief Get the output shape of the filter applied to a raster, i.e. the input shape cropped by the window.
+   */
+  template <typename U, Index N, typename UHolder>
+  Position<N> output_shape(const Raster<U, N, UHolder>& in) const
+  {
+    const auto w = box(window());
+    return in.shape() - extend<N>(w.shape() - 1);
+  }
+
+  /**
+   * @brief Get the output shape of the filter applied to an extrapolated raster, i.e. the input shape.
+   */
+  template <typename URaster, typename UMethod>
+  Position<URaster::Dimension> output_shape(const Extrapolation<URaster, UMethod>& in) const
+  {
+    return in.shape();
+  }
+
+  /**
+   * @brief Get the output shape of the filter applied to a box-, line- or grid-based patch.
+   */
+  template <typename U, typename UParent, typename URegion>
+  Position<URegion::Dimension> output_shape(const Patch<U, UParent, URegion>& in) const
+  {
+    return in.domain().shape();
+  }
+
+  /**
+   * @brief Apply the filter into a reusable output raster.
+   * @param in The input raster, extrapolated raster or patch
+   * @param out The output raster, which is reallocated only if its shape does not match `output_shape(in)`
+   * 
+   * This is the allocation-free counterpart of `operator*()`,
+   * e.g. to filter a stream of frames of same shape:
+   * 
+   * \code
+   * Raster<float> out;
+   * for (const auto& frame : frames) {
+   *   filter.apply(extrapolation(frame), out); // Allocates at first iteration only
+   *   ...
+   * }
+   * \endcode
+   */
+  template <typename TIn, typename U, Index N>
+  Raster<U, N>& apply(const TIn& in, Raster<U, N>& out) const
+  {
+    Internal::reuse(out, output_shape(in));
+    transform(in, out);
+    return out;
   }
 
   /**
@@ -69,9 +149,7 @@ public:
   template <typename U, Index N, typename UHolder>
   Raster<Value, N> operator*(const Raster<U, N, UHolder>& in) const
   {
-    const auto& w = box(window());
-    const auto shape = in.shape() - extend<N>(w.shape() - 1);
-    Raster<Value, N> out(shape);
+    Raster<Value, N> out(output_shape(in));
     transform(in, out);
     return out;
   }
@@ -82,7 +160,7 @@ public:
   template <typename URaster, typename UMethod>
   Raster<Value, URaster::Dimension> operator*(const Extrapolation<URaster, UMethod>& in) const
   {
-    Raster<Value, URaster::Dimension> out(in.shape());
+    Raster<Value, URaster::Dimension> out(output_shape(in));
     transform(in, out);
     return out;
   }
@@ -94,7 +172,7 @@ public:
   Raster<Value, URegion::Dimension> operator*(const Patch<U, UParent, URegion>& in) const
   {
     // URegion::Dimension is not defined for Sequence
-    Raster<Value, URegion::Dimension> out(in.domain().shape()); // Box or Grid
+    Raster<Value, URegion::Dimension> out(output_shape(in)); // Box or Grid
     // FIXME support arbitrary patches
     transform(in, out);
     return out;
@@ -114,15 +192,18 @@ public:
 
   /**
    * @brief Apply the filter to a sequence of pixels.
+   * 
+   * The pixels are visited in Morton ordering for cache efficiency,
+   * and the output is in the order of the input sequence.
+   * To filter the same pixels repeatedly, sort the sequence once with `sorted<MortonOrder>()`:
+   * sorted sequences are visited in place, without sorting.
    */
   template <typename U, typename UParent, typename UHolder>
   Sequence<Value> operator*(const Patch<U, UParent, Sequence<Position<UParent::Dimension>, UHolder>>& in) const
   {
-    Sequence<Value> out(in.size());
-    std::transform(in.domain().begin(), in.domain().end(), out.begin(), [&](const auto& p) {
+    return ordered_map<MortonOrder>(in.domain(), [&](const auto& p) {
       return (*this) * in.parent()(p);
     });
-    return out;
   }
 };
 
@@ -0,0 +1,75 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef LINX_INSTRUMENTATION
+#define LINX_INSTRUMENTATION
+#endif
+
+#include "Linx/Base/AlignedBuffer.h"
+#include "Linx/Base/Holders.h"
+#include "Linx/Base/Instrumentation.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Instrumentation_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(std_holder_test)
+{
+  using Holder = StdHolder<std::vector<float>>;
+  auto& instrumentation = Instrumentation::instance();
+  instrumentation.reset();
+  {
+    Holder a(10);
+    Holder b(a);
+    Holder c(std::move(b));
+    const auto stats = instrumentation.holder<Holder>();
+    BOOST_TEST(stats.allocations == 2);
+    BOOST_TEST(stats.allocated_bytes == 2 * 10 * sizeof(float));
+    BOOST_TEST(stats.live_bytes == 2 * 10 * sizeof(float));
+  }
+  const auto stats = instrumentation.holder<Holder>();
+  BOOST_TEST(stats.deallocations == 2);
+  BOOST_TEST(stats.live_bytes == 0);
+  BOOST_TEST(stats.peak_bytes == 2 * 10 * sizeof(float));
+}
+
+BOOST_AUTO_TEST_CASE(aligned_buffer_test)
+{
+  using Holder = AlignedBuffer<double>;
+  auto& instrumentation = Instrumentation::instance();
+  instrumentation.reset();
+  {
+    Holder a(8);
+    std::free(a.release());
+  }
+  {
+    Holder a(8);
+    Holder b(std::move(a));
+  }
+  const auto stats = instrumentation.holder<Holder>();
+  BOOST_TEST(stats.allocations == 2);
+  BOOST_TEST(stats.deallocations == 1); // Released memory is not tracked anymore
+  BOOST_TEST(stats.peak_bytes == 2 * 8 * sizeof(double));
+}
+
+BOOST_AUTO_TEST_CASE(traffic_test)
+{
+  auto& instrumentation = Instrumentation::instance();
+  instrumentation.reset();
+  instrument_traffic(3, 4);
+  instrument_traffic(5, 6);
+  const auto stats = instrumentation.total();
+  BOOST_TEST(stats.read_bytes == 8);
+  BOOST_TEST(stats.written_bytes == 10);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -124,6 +124,43 @@ BOOST_AUTO_TEST_CASE(reproducible_poisson_test)
   BOOST_TEST(sequence_a[2] == sequence_b[2]);
 }
 
+BOOST_AUTO_TEST_CASE(sparse_impulse_test)
+{
+  const std::size_t size = 1000000;
+  const double probability = 1.e-3;
+  std::vector<int> data(size, 0);
+  auto noise = ImpulseNoise<int>::salt_and_pepper(probability / 2, probability / 2, 1, -1, 0);
+  const auto indices = noise.sparse_apply(data);
+  const auto count = static_cast<double>(indices.size());
+  BOOST_TEST(std::abs(count - probability * size) < 5 * std::sqrt(probability * size));
+  BOOST_TEST(std::is_sorted(indices.begin(), indices.end()));
+  std::size_t salt = 0;
+  std::size_t affected = 0;
+  for (std::size_t i = 0; i < size; ++i) {
+    if (data[i] != 0) {
+      ++affected;
+      salt += data[i] == 1;
+    }
+  }
+  BOOST_TEST(affected == indices.size());
+  BOOST_TEST(std::abs(salt - count / 2) < 5 * std::sqrt(count / 4));
+  for (auto i : indices) {
+    BOOST_TEST((data[i] == 1 || data[i] == -1));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(sparse_impulse_extreme_probabilities_test)
+{
+  std::vector<int> data(100, 0);
+  ImpulseNoise<int> never(1, 0, 0);
+  BOOST_TEST(never.sparse_apply(data).empty());
+  ImpulseNoise<int> always(1, 1, 0);
+  BOOST_TEST(always.sparse_apply(data).size() == data.size());
+  BOOST_TEST(std::all_of(data.begin(), data.end(), [](auto e) {
+    return e == 1;
+  }));
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
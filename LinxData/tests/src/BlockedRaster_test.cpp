@@ -0,0 +1,74 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/BlockedRaster.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(BlockedRaster_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(padding_test)
+{
+  const BlockedRaster<int, 3, 2> raster({5, 4, 9});
+  BOOST_TEST(raster.shape() == (Position<3> {5, 4, 9}));
+  BOOST_TEST(raster.size() == 5 * 4 * 9);
+  BOOST_TEST(raster.blocks() == (Position<3> {2, 1, 9}));
+  BOOST_TEST(raster.contains(Position<3> {4, 3, 8}));
+  BOOST_TEST(not raster.contains(Position<3> {5, 3, 8}));
+}
+
+BOOST_AUTO_TEST_CASE(block_layout_test)
+{
+  const BlockedRaster<int, 2, 2> raster({8, 8});
+  BOOST_TEST(raster.index({0, 0}) == 0);
+  BOOST_TEST(raster.index({1, 0}) == 1);
+  BOOST_TEST(raster.index({0, 1}) == 4);
+  BOOST_TEST(raster.index({3, 3}) == 15);
+  BOOST_TEST(raster.index({4, 0}) == 16);
+  BOOST_TEST(raster.index({0, 4}) == 32);
+  BOOST_TEST(raster.index({7, 7}) == 63);
+}
+
+BOOST_AUTO_TEST_CASE(unblocked_axes_test)
+{
+  const BlockedRaster<int, 3, 2> raster({8, 8, 3});
+  BOOST_TEST(raster.blocked_dimension() == 2);
+  BOOST_TEST(raster.index({0, 0, 1}) == 64);
+  BOOST_TEST(raster.index({4, 0, 1}) == 80);
+  BOOST_TEST(raster.index({7, 7, 2}) == 191);
+}
+
+BOOST_AUTO_TEST_CASE(raster_round_trip_test)
+{
+  const auto in = Raster<int, 3>({7, 5, 3}).range();
+  const auto blocked_in = blocked<1>(in);
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(blocked_in[p] == in[p]);
+  }
+  const auto out = rasterize(blocked_in);
+  BOOST_TEST(out == in);
+}
+
+BOOST_AUTO_TEST_CASE(patch_test)
+{
+  auto raster = BlockedRaster<int>({100, 80});
+  raster.fill(0);
+  const Box<2> box {{60, 50}, {70, 70}};
+  for (auto& e : raster(box)) {
+    e = 1;
+  }
+  for (const auto& p : raster.domain()) {
+    BOOST_TEST(raster[p] == box.contains(p));
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
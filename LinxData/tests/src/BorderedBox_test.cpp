@@ -77,6 +77,39 @@ BOOST_AUTO_TEST_CASE(box_ordering_test)
   BOOST_TEST(out == expected);
 }
 
+BOOST_AUTO_TEST_CASE(off_origin_margin_test)
+{
+  const auto box = Box<2>::from_shape({0, 0}, {10, 6});
+  const Box<2> margin {{2, -3}, {4, -1}}; // Does not contain the origin
+  const Internal::BorderedBox<2> bordered(box, margin);
+
+  std::vector<Box<2>> expected {
+      {{0, 0}, {9, 2}}, // top
+      {{0, 3}, {5, 5}}, // inner
+      {{6, 3}, {9, 5}} // right
+  };
+  std::vector<Box<2>> out;
+  bordered.apply_inner_border(
+      [&](const auto& b) {
+        out.push_back(b);
+      },
+      [&](const auto& b) {
+        out.push_back(b);
+      });
+  BOOST_TEST(out == expected);
+
+  const Internal::BorderedBox<2> large(box, Box<2> {{-1, -4}, {1, 4}}); // Larger than the box
+  out.clear();
+  large.apply_inner_border(
+      [&](const auto& b) {
+        out.push_back(b);
+      },
+      [&](const auto& b) {
+        out.push_back(b);
+      });
+  BOOST_TEST(out == std::vector<Box<2>> {box});
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,77 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/BufferInfo.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(BufferInfo_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(format_test)
+{
+  BOOST_TEST(buffer_format<float>() == "f");
+  BOOST_TEST(buffer_format<const double>() == "d");
+  BOOST_TEST(buffer_format<std::int16_t>() == "h");
+  BOOST_TEST(buffer_format<std::uint64_t>() == "Q");
+  BOOST_TEST(buffer_format<std::complex<float>>() == "Zf");
+  BOOST_TEST(is_buffer_compatible<std::int64_t>("l", 8));
+  BOOST_TEST(is_buffer_compatible<std::int64_t>("<q", 8));
+  BOOST_TEST(not is_buffer_compatible<std::int64_t>("Q", 8));
+  BOOST_TEST(not is_buffer_compatible<std::int32_t>("l", 8));
+  BOOST_TEST(not is_buffer_compatible<float>("i", 4));
+  BOOST_CHECK_THROW(is_buffer_compatible<float>(">f", 4), BufferError);
+}
+
+BOOST_AUTO_TEST_CASE(raster_to_buffer_to_raster_test)
+{
+  Raster<float, 3> raster({4, 3, 2});
+  raster.range();
+  BOOST_TEST(not buffer_info(raster).readonly);
+  const auto& const_raster = raster;
+  const auto info = buffer_info(const_raster);
+  BOOST_TEST(info.data == raster.data());
+  BOOST_TEST(info.format == "f");
+  BOOST_TEST(info.shape == std::vector<Index>({2, 3, 4}));
+  BOOST_TEST(info.strides == std::vector<Index>({48, 16, 4}));
+  BOOST_TEST(info.readonly);
+  BOOST_TEST(info.is_contiguous());
+
+  const auto view = ptr_raster<const float, 3>(info);
+  BOOST_TEST(view.data() == raster.data());
+  BOOST_TEST(view.shape() == raster.shape());
+  BOOST_CHECK_THROW((ptr_raster<float, 3>(info)), BufferError);
+
+  const auto dynamic = ptr_raster<const float>(info);
+  BOOST_TEST(dynamic.dimension() == 3);
+  BOOST_TEST((dynamic[{3, 2, 1}] == raster[{3, 2, 1}]));
+}
+
+BOOST_AUTO_TEST_CASE(mutable_buffer_test)
+{
+  std::vector<double> data(6, 0);
+  BufferInfo info;
+  info.data = data.data();
+  info.itemsize = sizeof(double);
+  info.format = "d";
+  info.shape = {2, 3};
+  info.strides = {24, 8};
+  auto view = ptr_raster<double, 2>(info);
+  BOOST_TEST(view.shape() == Position<2>({3, 2}));
+  view[{2, 1}] = 1;
+  BOOST_TEST(data[5] == 1);
+  BOOST_CHECK_THROW((ptr_raster<float, 2>(info)), BufferError);
+  BOOST_CHECK_THROW((ptr_raster<double, 3>(info)), BufferError);
+  info.strides = {8, 16}; // Fortran order
+  BOOST_CHECK_THROW((ptr_raster<double, 2>(info)), BufferError);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
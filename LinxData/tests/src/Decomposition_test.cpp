@@ -0,0 +1,64 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/Decomposition.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Decomposition_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(parts_cover_domain_test)
+{
+  const Box<3> domain({1, 2, 3}, {10, 20, 30});
+  const Box<3> margin({-1, -1, -2}, {1, 1, 2});
+  SlabDecomposition<3> decomposition(domain, margin, 5);
+  BOOST_TEST(decomposition.size() == 5);
+  Index front = domain.front()[2];
+  for (Index i = 0; i < decomposition.size(); ++i) {
+    const auto& part = decomposition.part(i);
+    BOOST_TEST(part.front()[0] == domain.front()[0]);
+    BOOST_TEST(part.back()[1] == domain.back()[1]);
+    BOOST_TEST(part.front()[2] == front);
+    BOOST_TEST(std::abs(part.length(2) - domain.length(2) / 5) <= 1);
+    front = part.back()[2] + 1;
+    const auto& halo = decomposition.halo(i);
+    BOOST_TEST(part <= halo);
+    BOOST_TEST(halo <= domain);
+    BOOST_TEST(halo.front()[2] == std::max(part.front()[2] - 2, domain.front()[2]));
+    BOOST_TEST(halo.back()[2] == std::min(part.back()[2] + 2, domain.back()[2]));
+  }
+  BOOST_TEST(front == domain.back()[2] + 1);
+}
+
+BOOST_AUTO_TEST_CASE(overlaps_fill_halos_test)
+{
+  const auto domain = Box<2>::from_shape({8, 10});
+  const Box<2> margin({-1, -3}, {1, 3});
+  SlabDecomposition<2> decomposition(domain, margin, 4); // Parts are thinner than the margin
+  for (Index to = 0; to < decomposition.size(); ++to) {
+    Index received = 0;
+    for (Index from = 0; from < decomposition.size(); ++from) {
+      const auto overlap = decomposition.overlap(from, to);
+      if (from == to) {
+        BOOST_TEST(decomposition.is_empty(overlap));
+      }
+      if (not decomposition.is_empty(overlap)) {
+        BOOST_TEST(overlap <= decomposition.part(from));
+        BOOST_TEST(overlap <= decomposition.halo(to));
+        received += overlap.size();
+      }
+    }
+    BOOST_TEST(received + decomposition.part(to).size() == decomposition.halo(to).size());
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,60 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/LazyRaster.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(LazyRaster_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(raster_test)
+{
+  const auto lazy = lazy_raster(Position<3> {4, 3, 5}, [](const auto& p) {
+    return p[0] + 10 * p[1] + 100 * p[2];
+  });
+  BOOST_TEST(lazy.size() == 60);
+  const auto raster = lazy.raster();
+  BOOST_TEST(raster.shape() == lazy.shape());
+  for (const auto& p : raster.domain()) {
+    BOOST_TEST(raster[p] == lazy[p]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(chunk_test)
+{
+  const auto lazy = lazy_raster(Position<2> {6, 8}, [](const auto& p) {
+    return double(p[0] * p[1]);
+  });
+  const auto chunk = lazy.chunk(2, 4);
+  BOOST_TEST(chunk.shape() == (Position<2> {6, 3}));
+  for (const auto& p : chunk.domain()) {
+    BOOST_TEST(chunk[p] == p[0] * (p[1] + 2));
+  }
+
+  Raster<double> buffer(chunk.shape());
+  lazy.generate(buffer, 2);
+  BOOST_TEST(buffer == chunk);
+}
+
+BOOST_AUTO_TEST_CASE(one_dimension_test)
+{
+  const auto lazy = lazy_raster(Position<1> {10}, [](const auto& p) {
+    return p[0];
+  });
+  const auto chunk = lazy.chunk(3, 6);
+  BOOST_TEST(chunk.size() == 4);
+  for (Index i = 0; i < 4; ++i) {
+    BOOST_TEST(chunk[i] == i + 3);
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
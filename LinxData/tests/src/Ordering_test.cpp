@@ -0,0 +1,116 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/Ordering.h"
+#include "Linx/Data/Raster.h"
+
+#include <boost/test/unit_test.hpp>
+#include <list>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Ordering_test)
+
+//-----------------------------------------------------------------------------
+
+Sequence<Position<2>> shuffled_positions(const Box<2>& box)
+{
+  Sequence<Position<2>> out(box.size());
+  std::copy(box.begin(), box.end(), out.begin());
+  for (std::size_t i = 0; i < out.size(); ++i) { // Deterministic shuffle
+    std::swap(out[i], out[(i * 7919) % out.size()]);
+  }
+  return out;
+}
+
+BOOST_AUTO_TEST_CASE(bounding_box_test)
+{
+  const Sequence<Position<2>> positions {{3, 1}, {-1, 4}, {2, 2}};
+  BOOST_TEST(bounding_box(positions) == (Box<2> {{-1, 1}, {3, 4}}));
+}
+
+BOOST_AUTO_TEST_CASE(row_major_order_test)
+{
+  const Box<2> box {{1, 2}, {6, 4}};
+  const auto positions = shuffled_positions(box);
+  const auto out = sorted<RowMajorOrder>(positions);
+  BOOST_TEST(out.size() == box.size());
+  BOOST_TEST(std::equal(out.begin(), out.end(), box.begin()));
+}
+
+BOOST_AUTO_TEST_CASE(morton_order_test)
+{
+  const auto positions = shuffled_positions(Box<2>::from_shape({4, 4}));
+  const auto out = sorted<MortonOrder>(positions);
+  const Sequence<Position<2>> expected {{0, 0}, {1, 0}, {0, 1}, {1, 1}, {2, 0}, {3, 0}, {2, 1}, {3, 1},
+                                        {0, 2}, {1, 2}, {0, 3}, {1, 3}, {2, 2}, {3, 2}, {2, 3}, {3, 3}};
+  BOOST_TEST(out == expected);
+}
+
+BOOST_AUTO_TEST_CASE(hilbert_order_is_continuous_test)
+{
+  const auto positions = shuffled_positions(Box<2>::from_shape({8, 8}));
+  const auto out = sorted<HilbertOrder>(positions);
+  BOOST_TEST(out[0] == (Position<2>::zero()));
+  for (std::size_t i = 1; i < out.size(); ++i) {
+    const auto d = out[i] - out[i - 1];
+    BOOST_TEST(std::abs(d[0]) + std::abs(d[1]) == 1);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(ordered_map_scatters_back_test)
+{
+  const auto raster = Raster<int>({10, 8}).range();
+  const auto positions = shuffled_positions(raster.domain());
+  std::vector<Position<2>> visits;
+  const auto out = ordered_map<MortonOrder>(positions, [&](const auto& p) {
+    visits.push_back(p);
+    return raster[p];
+  });
+  BOOST_TEST(visits.size() == positions.size());
+  for (std::size_t i = 0; i < positions.size(); ++i) {
+    BOOST_TEST(out[i] == raster[positions[i]]);
+  }
+  const auto expected = sorted<MortonOrder>(positions);
+  BOOST_TEST(std::equal(visits.begin(), visits.end(), expected.begin()));
+}
+
+BOOST_AUTO_TEST_CASE(ordered_map_list_test)
+{
+  const auto raster = Raster<int>({10, 8}).range();
+  const auto positions = shuffled_positions(raster.domain());
+  const std::list<Position<2>> list(positions.begin(), positions.end());
+  const auto func = [&](const auto& p) {
+    return raster[p];
+  };
+  const auto out = ordered_map<MortonOrder>(list, func);
+  const auto expected = ordered_map<MortonOrder>(positions, func);
+  BOOST_TEST(std::equal(out.begin(), out.end(), expected.begin(), expected.end()));
+  const auto list_sorted = sorted<MortonOrder>(list);
+  const auto vector_sorted = sorted<MortonOrder>(positions);
+  BOOST_TEST(std::equal(list_sorted.begin(), list_sorted.end(), vector_sorted.begin(), vector_sorted.end()));
+}
+
+BOOST_AUTO_TEST_CASE(ordered_map_sorted_test)
+{
+  const auto raster = Raster<int>({10, 8}).range();
+  const auto positions = sorted<MortonOrder>(shuffled_positions(raster.domain()));
+  BOOST_TEST(is_ordered<MortonOrder>(positions));
+  BOOST_TEST(not is_ordered<RowMajorOrder>(positions));
+  std::vector<Position<2>> visits;
+  const auto out = ordered_map<MortonOrder>(positions, [&](const auto& p) {
+    visits.push_back(p);
+    return raster[p];
+  });
+  BOOST_TEST(std::equal(visits.begin(), visits.end(), positions.begin(), positions.end())); // Visited in place
+  for (std::size_t i = 0; i < positions.size(); ++i) {
+    BOOST_TEST(out[i] == raster[positions[i]]);
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
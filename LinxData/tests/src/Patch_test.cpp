@@ -2,6 +2,8 @@
 // This file is part of Linx <github.com/kabasset/Linx>
 // SPDX-License-Identifier: Apache-2.0
 
+#include "Linx/Data/Grid.h"
+#include "Linx/Data/Mask.h"
 #include "Linx/Data/Raster.h"
 
 #include <boost/test/unit_test.hpp>
@@ -55,6 +57,32 @@ BOOST_AUTO_TEST_CASE(contiguity_test)
   }
 }
 
+template <typename TPatch>
+void check_slide(TPatch patch)
+{
+  auto translated = patch;
+  translated >>= {1, 2};
+  patch >>= {0, 2};
+  patch.slide();
+  BOOST_TEST(patch == translated);
+  BOOST_TEST(box(patch.domain()) == box(translated.domain()));
+  BOOST_TEST(std::vector<int>(patch.begin(), patch.end()) == std::vector<int>(translated.begin(), translated.end()));
+  patch.slide(3).slide(-4);
+  patch <<= {0, 2};
+  translated <<= {1, 2};
+  BOOST_TEST(patch == translated);
+  BOOST_TEST(std::vector<int>(patch.begin(), patch.end()) == std::vector<int>(translated.begin(), translated.end()));
+}
+
+BOOST_AUTO_TEST_CASE(slide_test)
+{
+  Raster<int> raster({8, 8});
+  raster.range();
+  check_slide(raster(Box<2>({1, 1}, {3, 2})));
+  check_slide(raster(Grid<2>({{1, 1}, {5, 2}}, {2, 1})));
+  check_slide(raster(Mask<2>::ball<1>(1, {3, 3})));
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
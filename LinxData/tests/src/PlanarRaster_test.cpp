@@ -0,0 +1,124 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/PlanarRaster.h"
+#include "Linx/Transforms/Filters.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(PlanarRaster_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(layout_test)
+{
+  PlanarRaster<int, 3> raster({4, 3});
+  BOOST_TEST(raster.shape() == Position<2>({4, 3}));
+  BOOST_TEST(raster.size() == 12);
+  BOOST_TEST(raster.planes().shape() == Position<3>({4, 3, 3}));
+  raster[{1, 2}] = {1, 2, 3};
+  BOOST_TEST((raster.plane(0)[{1, 2}] == 1));
+  BOOST_TEST((raster.plane(1)[{1, 2}] == 2));
+  BOOST_TEST((raster.plane(2)[{1, 2}] == 3));
+  raster[{1, 2}][1] = 4;
+  const auto& const_raster = raster;
+  const std::array<int, 3> pixel = const_raster[{1, 2}];
+  BOOST_TEST(pixel[0] == 1);
+  BOOST_TEST(pixel[1] == 4);
+  BOOST_TEST(pixel[2] == 3);
+}
+
+BOOST_AUTO_TEST_CASE(variable_dimension_test)
+{
+  PlanarRaster<int, 3, -1> raster({4, 3});
+  BOOST_TEST(raster.dimension() == 2);
+  BOOST_TEST(raster.shape() == Position<-1>({4, 3}));
+  BOOST_TEST(raster.planes().shape() == Position<-1>({4, 3, 3}));
+  raster[{1, 2}] = {1, 2, 3};
+  BOOST_TEST((raster.plane(2)[{1, 2}] == 3));
+  const auto interleaved_raster = interleaved(raster);
+  BOOST_TEST((interleaved_raster[{1, 2}][1] == 2));
+}
+
+BOOST_AUTO_TEST_CASE(interleave_test)
+{
+  Raster<std::array<int, 2>> interleaved_in({3, 2});
+  for (std::size_t i = 0; i < interleaved_in.size(); ++i) {
+    interleaved_in.data()[i] = {int(i), -int(i)};
+  }
+  const auto raster = planar<2>(interleaved_in);
+  BOOST_TEST(raster.shape() == interleaved_in.shape());
+  for (const auto& p : raster.domain()) {
+    BOOST_TEST(raster.plane(0)[p] == interleaved_in[p][0]);
+    BOOST_TEST(raster.plane(1)[p] == interleaved_in[p][1]);
+  }
+  const auto interleaved_out = interleaved(raster);
+  BOOST_TEST(interleaved_out == interleaved_in);
+}
+
+struct Rgb {
+  unsigned char r, g, b;
+};
+
+BOOST_AUTO_TEST_CASE(struct_conversion_test)
+{
+  Raster<Rgb> rgb({2, 2});
+  rgb.fill(Rgb {10, 20, 30});
+  const auto raster = planar(rgb, [](const Rgb& v) {
+    return std::array<unsigned char, 3> {v.r, v.g, v.b};
+  });
+  BOOST_TEST((std::is_same<decltype(raster), const PlanarRaster<unsigned char, 3>>::value));
+  BOOST_TEST((raster.plane(2)[{1, 1}] == 30));
+  const auto sums = interleaved(raster, [](const auto& v) {
+    return v[0] + v[1] + v[2];
+  });
+  for (const auto& v : sums) {
+    BOOST_TEST(v == 60);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(generate_test)
+{
+  PlanarRaster<float, 3> rgb({5, 4});
+  rgb.fill({1, 2, 3});
+  PlanarRaster<float, 2> out(rgb.shape());
+  out.generate(
+      [](const auto& v) {
+        return std::array<float, 2> {v[0] + v[1], v[2] * 2};
+      },
+      rgb);
+  for (const auto& p : out.domain()) {
+    BOOST_TEST(out[p][0] == 3);
+    BOOST_TEST(out[p][1] == 6);
+  }
+  out.apply([](const auto& v) {
+    return std::array<float, 2> {v[1], v[0]};
+  });
+  BOOST_TEST((out[{4, 3}][0] == 6));
+  BOOST_TEST((out[{4, 3}][1] == 3));
+  out.planes() *= 2;
+  BOOST_TEST((out[{0, 0}][0] == 12));
+}
+
+BOOST_AUTO_TEST_CASE(planewise_filter_test)
+{
+  PlanarRaster<float, 2> raster({6, 5});
+  raster.plane(0).fill(1);
+  raster.plane(1).range();
+  const auto filter = mean_filter<float>(Box<2>({-1, -1}, {1, 1}));
+  const auto out = planewise(filter, raster);
+  BOOST_TEST(out.shape() == Position<2>({4, 3}));
+  for (Index c = 0; c < 2; ++c) {
+    const auto expected = filter * raster.plane(c);
+    BOOST_TEST(out.plane(c) == expected);
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
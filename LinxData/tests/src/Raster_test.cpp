@@ -284,6 +284,66 @@ BOOST_AUTO_TEST_CASE(raster_apply_generate_test)
   }
 }
 
+BOOST_AUTO_TEST_CASE(raster_sparse_impulse_test)
+{
+  auto raster = Raster<int, 3>({30, 40, 50}).fill(0);
+  ImpulseNoise<int> noise(1, 0.01, 0);
+  const auto positions = sparse_apply(raster, noise);
+  BOOST_TEST(positions.size() > 0);
+  for (const auto& p : positions) {
+    BOOST_TEST(raster[p] == 1);
+  }
+  BOOST_TEST(std::count(raster.begin(), raster.end(), 1) == static_cast<std::ptrdiff_t>(positions.size()));
+}
+
+BOOST_AUTO_TEST_CASE(raster_copy_test)
+{
+  Raster<int, 3> raster({6, 5, 4});
+  raster.range();
+  const Box<3> box {{1, 0, 1}, {4, 4, 2}};
+
+  // Crop
+  Raster<int, 3> crop(box.shape());
+  copy(raster(box), crop);
+  for (const auto& p : box) {
+    BOOST_TEST(crop[p - box.front()] == raster[p]);
+  }
+  BOOST_TEST((Raster<int, 3>(raster(box)) == crop));
+
+  // Stamp into a patch whose rows are merged, with conversion
+  Raster<double, 3> stamped({4, 5, 3});
+  stamped.fill(-1);
+  const Box<3> stamp {{0, 0, 1}, {3, 4, 2}};
+  copy(crop, stamped(stamp));
+  for (const auto& p : stamped.domain()) {
+    BOOST_TEST(stamped[p] == (stamp.contains(p) ? crop[p - stamp.front()] : -1));
+  }
+
+  // Same sizes, different shapes
+  Raster<int, 1> flat({static_cast<Index>(crop.size())});
+  copy(raster(box), flat);
+  BOOST_TEST(std::equal(flat.begin(), flat.end(), crop.begin()));
+  BOOST_CHECK_THROW(copy(raster(box), raster), SizeError);
+}
+
+BOOST_AUTO_TEST_CASE(raster_parallel_copy_fill_test)
+{
+  Raster<float> raster({1024, 600});
+  raster.range();
+  const Box<2> box {{1, 2}, {1000, 599}};
+  Raster<float> crop(raster(box));
+  BOOST_TEST(crop.shape() == box.shape());
+  for (const auto& p : box) {
+    BOOST_TEST(crop[p - box.front()] == raster[p]);
+  }
+  raster(box).fill(-1);
+  for (const auto& p : raster.domain()) {
+    BOOST_TEST(raster[p] == (box.contains(p) ? -1 : raster.index(p)));
+  }
+  raster.fill(2);
+  BOOST_TEST(std::count(raster.begin(), raster.end(), 2) == static_cast<std::ptrdiff_t>(raster.size()));
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
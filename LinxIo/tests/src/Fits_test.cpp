@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "Linx/Base/TypeUtils.h"
+#include "Linx/Data/LazyRaster.h"
 #include "Linx/Io.h"
 
 #include <boost/test/unit_test.hpp>
@@ -79,6 +80,42 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(auto_append_read_test, T, SupportedFitsTypes)
   BOOST_TEST(out == in);
 }
 
+BOOST_AUTO_TEST_CASE(region_write_read_test)
+{
+  TemporaryPath path("region.fits");
+  Fits io(path);
+  const Position<2> shape {16, 12};
+  const auto hdu = io.create<float>(shape);
+  BOOST_TEST(hdu == 0);
+  BOOST_TEST(io.read_shape<2>() == shape);
+  const Box<2> region({2, 3}, {9, 7});
+  Raster<float> in(region.shape());
+  in.range();
+  io.write_region(in, region.front());
+  const auto out = io.read_region<Raster<float>>(region);
+  BOOST_TEST(out == in);
+  const auto whole = io.read<Raster<float>>();
+  for (const auto& p : whole.domain()) {
+    BOOST_TEST(whole[p] == (region.contains(p) ? in[p - region.front()] : 0));
+  }
+  const Box<2> inner({1, 1}, {3, 2});
+  io.write_region(in(inner), {12, 9}); // Non-contiguous
+  const auto patch = io.read_region<Raster<float>>(inner + Position<2> {11, 8});
+  BOOST_TEST(patch == Raster<float>(in(inner)));
+}
+
+BOOST_AUTO_TEST_CASE(write_stream_test)
+{
+  TemporaryPath path("stream.fits");
+  Fits io(path);
+  const auto source = lazy_raster(Position<3> {5, 4, 7}, [](const auto& p) {
+    return float(p[0] + 10 * p[1] + 100 * p[2]);
+  });
+  io.write_stream(source, 3); // Last chunk is shorter
+  const auto out = io.read<Raster<float, 3>>();
+  BOOST_TEST(out == source.raster());
+}
+
 BOOST_AUTO_TEST_CASE(auto_read_wrong_format_test)
 {
   TemporaryPath path("dummy.txt"); // FIXME .fits
@@ -0,0 +1,145 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXRUN_PYTHONAPI_H
+#define _LINXRUN_PYTHONAPI_H
+
+/**
+ * @file
+ * @brief C interface of Linx for foreign function interfaces, e.g. Python's `ctypes`.
+ *
+ * Arrays are passed as `LinxBuffer` descriptors, which mirror the Python buffer protocol,
+ * such that NumPy arrays are shared without copy in both directions:
+ * - Python to C++: inputs are viewed as `PtrRaster`s of constant values,
+ *   and outputs are allocated by the caller and written in place;
+ * - C++ to Python: `LinxRaster`s are rasters owned by Linx, e.g. read from a FITS file,
+ *   whose memory is described as a `LinxBuffer` which NumPy arrays can view.
+ *
+ * Buffers must be C-contiguous.
+ * Supported value types are `float32` (`"f"`), `float64` (`"d"`) and `complex128` (`"Zd"`),
+ * depending on the function, and supported dimensions are 1 to 3.
+ *
+ * Functions return 0 on success, and a non-zero value on error, in which case `linx_last_error()` returns the message.
+ * They do not call back into Python, such that the caller can release the GIL, which `ctypes.CDLL` does.
+ *
+ * Boundary conditions are given by name, as in `scipy.ndimage`:
+ * `"reflect"`, `"constant"` (with value `cval`), `"nearest"` or `"wrap"`.
+ * Kernel origins are also placed like in `scipy.ndimage`, i.e. at index `shape / 2`.
+ *
+ * See the `LinxRun.linx` Python module for the bindings.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Description of a strided memory buffer.
+ */
+typedef struct {
+  void* data; ///< Pointer to the first element
+  long itemsize; ///< Element size in bytes
+  const char* format; ///< Element format, e.g. "f"
+  long ndim; ///< Number of dimensions
+  const long* shape; ///< Lengths, in C order
+  const long* strides; ///< Strides in bytes, in C order
+  int readonly; ///< Read-only flag
+} LinxBuffer;
+
+/**
+ * @brief Opaque raster owned by Linx.
+ */
+typedef struct LinxRaster LinxRaster;
+
+/**
+ * @brief Get the message of the last error in the calling thread.
+ */
+const char* linx_last_error();
+
+/**
+ * @brief Allocate a raster.
+ * @param format The value format, e.g. "f"
+ * @param ndim The number of dimensions
+ * @param shape The lengths, in C order
+ * @param out The new raster, to be freed with `linx_raster_free()`
+ */
+int linx_raster_new(const char* format, long ndim, const long* shape, LinxRaster** out);
+
+/**
+ * @brief Free a raster.
+ */
+void linx_raster_free(LinxRaster* raster);
+
+/**
+ * @brief Describe the memory of a raster.
+ *
+ * The descriptor and the memory are valid until the raster is freed.
+ */
+int linx_raster_buffer(LinxRaster* raster, LinxBuffer* out);
+
+/**
+ * @brief Read a FITS image into a new raster.
+ * @param path The file path
+ * @param hdu The (0-based) HDU index
+ * @param format The value format of the raster, "f" or "d"
+ * @param out The new raster, to be freed with `linx_raster_free()`
+ */
+int linx_fits_read(const char* path, long hdu, const char* format, LinxRaster** out);
+
+/**
+ * @brief Write an array as a FITS image.
+ * @param mode 'x' to create a new file, 'w' to create or overwrite, 'a' to append an HDU
+ */
+int linx_fits_write(const char* path, const LinxBuffer* in, char mode);
+
+/**
+ * @brief Compute the complex DFT of a `complex128` array.
+ * @param inverse If non-zero, compute the normalized inverse DFT instead
+ *
+ * The output has the same shape as the input, and may be the input.
+ */
+int linx_dft(const LinxBuffer* in, LinxBuffer* out, int inverse);
+
+/**
+ * @brief Compute the DFT of a `float64` array.
+ *
+ * The output is `complex128`, and its last axis has length `n / 2 + 1`, where `n` is that of the input.
+ */
+int linx_real_dft(const LinxBuffer* in, LinxBuffer* out);
+
+/**
+ * @brief Compute the normalized inverse DFT of a Hermitian-symmetric array into a `float64` array.
+ *
+ * The logical shape is that of the output, whose last axis has length `n` such that `n / 2 + 1` is that of the input.
+ */
+int linx_inverse_real_dft(const LinxBuffer* in, LinxBuffer* out);
+
+/**
+ * @brief Correlate an array with a kernel.
+ */
+int linx_correlate(const LinxBuffer* in, const LinxBuffer* kernel, LinxBuffer* out, const char* mode, double cval);
+
+/**
+ * @brief Convolve an array with a kernel.
+ */
+int linx_convolve(const LinxBuffer* in, const LinxBuffer* kernel, LinxBuffer* out, const char* mode, double cval);
+
+/**
+ * @brief Apply a rank filter over a box.
+ * @param filter The filter name: "mean", "median", "minimum" or "maximum"
+ * @param radius The box radius along each axis, in C order
+ */
+int linx_box_filter(
+    const LinxBuffer* in,
+    const char* filter,
+    const long* radius,
+    LinxBuffer* out,
+    const char* mode,
+    double cval);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
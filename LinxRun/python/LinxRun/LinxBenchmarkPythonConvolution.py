@@ -1,6 +1,5 @@
 import argparse
 import numpy as np
-from scipy import ndimage
 import time
 
 
@@ -9,6 +8,7 @@ def defineSpecificProgramOptions():
     parser.add_argument('--image', type=int, default=2048)
     parser.add_argument('--kernel', type=int, default=5)
     parser.add_argument('--extrapolation', default='nearest')
+    parser.add_argument('--backend', default='scipy', choices=['scipy', 'linx'])
     return parser
 
 
@@ -17,6 +17,10 @@ def mainMethod(args):
     image_diameter = args.image
     kernel_diameter = args.kernel
     extrapolation = args.extrapolation
+    if args.backend == 'linx':
+        from LinxRun import linx as ndimage
+    else:
+        from scipy import ndimage
     image_shape = (image_diameter, image_diameter)
     kernel_shape = (kernel_diameter, kernel_diameter)
 
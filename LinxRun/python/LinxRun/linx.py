@@ -0,0 +1,283 @@
+"""Zero-copy bindings of Linx filters, DFTs and FITS I/O for NumPy arrays.
+
+Arrays are shared with the LinxRun library through the C interface declared in `LinxRun/PythonApi.h`:
+inputs are read in place and outputs are written in place, without serialization.
+Conversely, rasters allocated by Linx, e.g. read from a FITS file, are exposed as `Raster` objects,
+which NumPy views without copy.
+The GIL is released during the computations, such that several threads can filter in parallel.
+
+Filters mimic `scipy.ndimage`, including the default 'reflect' mode, such that they can be used as drop-in replacements:
+
+    from LinxRun import linx
+    linx.correlate(image, kernel, output=image)
+
+DFTs mimic `numpy.fft`, with the same normalization.
+"""
+
+import ctypes
+import ctypes.util
+import numpy as np
+
+
+class _Buffer(ctypes.Structure):
+    _fields_ = [
+        ('data', ctypes.c_void_p),
+        ('itemsize', ctypes.c_long),
+        ('format', ctypes.c_char_p),
+        ('ndim', ctypes.c_long),
+        ('shape', ctypes.POINTER(ctypes.c_long)),
+        ('strides', ctypes.POINTER(ctypes.c_long)),
+        ('readonly', ctypes.c_int),
+    ]
+
+
+def _load():
+    path = ctypes.util.find_library('LinxRun') or 'libLinxRun.so'
+    lib = ctypes.CDLL(path)  # Unlike PyDLL, CDLL releases the GIL during calls
+    buffer_p = ctypes.POINTER(_Buffer)
+    lib.linx_last_error.restype = ctypes.c_char_p
+    lib.linx_last_error.argtypes = []
+    for name in ('linx_correlate', 'linx_convolve'):
+        func = getattr(lib, name)
+        func.restype = ctypes.c_int
+        func.argtypes = [buffer_p, buffer_p, buffer_p, ctypes.c_char_p, ctypes.c_double]
+    lib.linx_box_filter.restype = ctypes.c_int
+    lib.linx_box_filter.argtypes = [
+        buffer_p, ctypes.c_char_p, ctypes.POINTER(ctypes.c_long), buffer_p, ctypes.c_char_p, ctypes.c_double
+    ]
+    raster_p = ctypes.c_void_p
+    lib.linx_raster_new.restype = ctypes.c_int
+    lib.linx_raster_new.argtypes = [ctypes.c_char_p, ctypes.c_long, ctypes.POINTER(ctypes.c_long), ctypes.POINTER(raster_p)]
+    lib.linx_raster_free.restype = None
+    lib.linx_raster_free.argtypes = [raster_p]
+    lib.linx_raster_buffer.restype = ctypes.c_int
+    lib.linx_raster_buffer.argtypes = [raster_p, buffer_p]
+    lib.linx_fits_read.restype = ctypes.c_int
+    lib.linx_fits_read.argtypes = [ctypes.c_char_p, ctypes.c_long, ctypes.c_char_p, ctypes.POINTER(raster_p)]
+    lib.linx_fits_write.restype = ctypes.c_int
+    lib.linx_fits_write.argtypes = [ctypes.c_char_p, buffer_p, ctypes.c_char]
+    lib.linx_dft.restype = ctypes.c_int
+    lib.linx_dft.argtypes = [buffer_p, buffer_p, ctypes.c_int]
+    for name in ('linx_real_dft', 'linx_inverse_real_dft'):
+        func = getattr(lib, name)
+        func.restype = ctypes.c_int
+        func.argtypes = [buffer_p, buffer_p]
+    return lib
+
+
+_lib = None
+
+
+def _library():
+    global _lib
+    if _lib is None:
+        _lib = _load()
+    return _lib
+
+
+def _buffer(array, writable=False):
+    """Describe a NumPy array without copy.
+
+    The returned tuple keeps the shape and strides arrays alive.
+    """
+    if not array.flags.c_contiguous:
+        raise ValueError('Array must be C-contiguous')
+    if writable and not array.flags.writeable:
+        raise ValueError('Output array is read-only')
+    shape = (ctypes.c_long * array.ndim)(*array.shape)
+    strides = (ctypes.c_long * array.ndim)(*array.strides)
+    fmt = memoryview(array).format.encode()  # E.g. 'Zd' for complex128
+    buffer = _Buffer(array.ctypes.data, array.itemsize, fmt, array.ndim, shape, strides, int(not writable))
+    return buffer, shape, strides, fmt
+
+
+def _check(status):
+    if status != 0:
+        raise RuntimeError(_library().linx_last_error().decode())
+
+
+def _prepare(input, output):
+    input = np.ascontiguousarray(input)
+    if input.dtype not in (np.float32, np.float64):
+        input = input.astype(np.float64)
+    if output is None:
+        output = np.empty_like(input)
+    elif output.shape != input.shape or output.dtype != input.dtype:
+        raise ValueError('Output must have the same shape and dtype as input')
+    return input, output
+
+
+def _kernel_filter(name, input, weights, output, mode, cval):
+    input, output = _prepare(input, output)
+    weights = np.ascontiguousarray(weights, dtype=input.dtype)
+    if weights.ndim != input.ndim:
+        raise ValueError('Weights and input must have the same dimension')
+    in_buffer = _buffer(input)
+    weights_buffer = _buffer(weights)
+    out_buffer = _buffer(output, writable=True)
+    func = getattr(_library(), name)
+    _check(func(in_buffer[0], weights_buffer[0], out_buffer[0], mode.encode(), cval))
+    return output
+
+
+def correlate(input, weights, output=None, mode='reflect', cval=0.0):
+    """Correlate an array with a kernel, like `scipy.ndimage.correlate`.
+
+    Supported modes are 'reflect', 'constant', 'nearest' and 'wrap', with the same meanings as in SciPy.
+    If `output` is `None`, it is allocated; otherwise, it is written in place and may be `input` or overlap it.
+    """
+    return _kernel_filter('linx_correlate', input, weights, output, mode, cval)
+
+
+def convolve(input, weights, output=None, mode='reflect', cval=0.0):
+    """Convolve an array with a kernel, like `scipy.ndimage.convolve`.
+
+    See `correlate()`.
+    """
+    return _kernel_filter('linx_convolve', input, weights, output, mode, cval)
+
+
+def _box_filter(name, input, size, output, mode, cval):
+    input, output = _prepare(input, output)
+    size = np.broadcast_to(np.asarray(size, dtype=np.int64), (input.ndim, ))
+    if np.any(size % 2 == 0):
+        raise ValueError('Sizes must be odd')
+    radius = (ctypes.c_long * input.ndim)(*(size // 2))
+    in_buffer = _buffer(input)
+    out_buffer = _buffer(output, writable=True)
+    _check(_library().linx_box_filter(in_buffer[0], name.encode(), radius, out_buffer[0], mode.encode(), cval))
+    return output
+
+
+def uniform_filter(input, size=3, output=None, mode='reflect', cval=0.0):
+    """Apply a mean filter over an odd-sized box, like `scipy.ndimage.uniform_filter`."""
+    return _box_filter('mean', input, size, output, mode, cval)
+
+
+def median_filter(input, size=3, output=None, mode='reflect', cval=0.0):
+    """Apply a median filter over an odd-sized box, like `scipy.ndimage.median_filter`."""
+    return _box_filter('median', input, size, output, mode, cval)
+
+
+def minimum_filter(input, size=3, output=None, mode='reflect', cval=0.0):
+    """Apply a minimum filter over an odd-sized box, like `scipy.ndimage.minimum_filter`."""
+    return _box_filter('minimum', input, size, output, mode, cval)
+
+
+def maximum_filter(input, size=3, output=None, mode='reflect', cval=0.0):
+    """Apply a maximum filter over an odd-sized box, like `scipy.ndimage.maximum_filter`."""
+    return _box_filter('maximum', input, size, output, mode, cval)
+
+
+class Raster:
+    """Raster allocated and owned by Linx.
+
+    NumPy arrays can view it without copy through the array interface, e.g. with `numpy.asarray()`;
+    the views keep it alive.
+    """
+
+    def __init__(self, handle):
+        self._handle = ctypes.c_void_p(handle)
+        buffer = _Buffer()
+        _check(_library().linx_raster_buffer(self._handle, ctypes.byref(buffer)))
+        self.shape = tuple(buffer.shape[i] for i in range(buffer.ndim))
+        self.dtype = np.dtype(_dtypes[buffer.format.decode()])
+        self.__array_interface__ = {
+            'shape': self.shape,
+            'typestr': self.dtype.str,
+            'data': (buffer.data, False),
+            'strides': tuple(buffer.strides[i] for i in range(buffer.ndim)),
+            'version': 3,
+        }
+
+    @classmethod
+    def empty(cls, shape, dtype=np.float64):
+        """Allocate an uninitialized raster."""
+        shape = tuple(shape)
+        handle = ctypes.c_void_p()
+        fmt = _formats[np.dtype(dtype)].encode()
+        _check(_library().linx_raster_new(fmt, len(shape), (ctypes.c_long * len(shape))(*shape), ctypes.byref(handle)))
+        return cls(handle.value)
+
+    def __del__(self):
+        if self._handle and _lib is not None:
+            _lib.linx_raster_free(self._handle)
+            self._handle = None
+
+
+_formats = {np.dtype(np.float32): 'f', np.dtype(np.float64): 'd', np.dtype(np.complex128): 'Zd'}
+_dtypes = {v: k for k, v in _formats.items()}
+
+
+def read_fits(path, hdu=0, dtype=np.float64):
+    """Read an image HDU into a NumPy array, which views a `Raster` without copy.
+
+    `hdu` is the 0-based HDU index.
+    """
+    handle = ctypes.c_void_p()
+    fmt = _formats[np.dtype(dtype)].encode()
+    _check(_library().linx_fits_read(str(path).encode(), hdu, fmt, ctypes.byref(handle)))
+    return np.asarray(Raster(handle.value))
+
+
+def write_fits(path, array, mode='x'):
+    """Write an array as an image HDU.
+
+    `mode` is 'x' to create a new file, 'w' to overwrite a file, or 'a' to append an HDU.
+    """
+    array = np.ascontiguousarray(array)
+    if array.dtype not in (np.float32, np.float64):
+        array = array.astype(np.float64)
+    in_buffer = _buffer(array)
+    _check(_library().linx_fits_write(str(path).encode(), in_buffer[0], mode.encode()))
+
+
+def _dft(name, input, output, in_dtype, out_shape, out_dtype, *args):
+    input = np.ascontiguousarray(input, dtype=in_dtype)
+    if output is None:
+        output = np.asarray(Raster.empty(out_shape, out_dtype))
+    elif output.shape != tuple(out_shape) or output.dtype != out_dtype:
+        raise ValueError(f'Output must be of shape {tuple(out_shape)} and dtype {np.dtype(out_dtype)}')
+    in_buffer = _buffer(input)
+    out_buffer = _buffer(output, writable=True)
+    _check(getattr(_library(), name)(in_buffer[0], out_buffer[0], *args))
+    return output
+
+
+def fftn(a, output=None):
+    """Compute the complex DFT of all the axes, like `numpy.fft.fftn`.
+
+    If `output` is `None`, it is allocated as a `Raster`; otherwise, it is written in place and may overlap `a`.
+    """
+    a = np.asarray(a)
+    return _dft('linx_dft', a, output, np.complex128, a.shape, np.complex128, 0)
+
+
+def ifftn(a, output=None):
+    """Compute the normalized inverse complex DFT of all the axes, like `numpy.fft.ifftn`.
+
+    See `fftn()`.
+    """
+    a = np.asarray(a)
+    return _dft('linx_dft', a, output, np.complex128, a.shape, np.complex128, 1)
+
+
+def rfftn(a, output=None):
+    """Compute the real DFT of all the axes, like `numpy.fft.rfftn`.
+
+    The last axis of the output is of length `n // 2 + 1`.
+    """
+    a = np.asarray(a)
+    shape = a.shape[:-1] + (a.shape[-1] // 2 + 1, )
+    return _dft('linx_real_dft', a, output, np.float64, shape, np.complex128)
+
+
+def irfftn(a, s=None, output=None):
+    """Compute the normalized inverse real DFT of all the axes, like `numpy.fft.irfftn`.
+
+    `s` is the output shape, which defaults to an even length along the last axis.
+    """
+    a = np.asarray(a)
+    if s is None:
+        s = a.shape[:-1] + (2 * (a.shape[-1] - 1), )
+    return _dft('linx_inverse_real_dft', a, output, np.complex128, tuple(s), np.float64)
@@ -0,0 +1,435 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "LinxRun/PythonApi.h"
+
+#include "Linx/Data/BufferInfo.h"
+#include "Linx/Io/Fits.h"
+#include "Linx/Transforms/Extrapolation.h"
+#include "Linx/Transforms/Filters.h"
+#include "LinxTransforms/Dft.h"
+
+#include <algorithm>
+#include <complex>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Raster owned by Linx, with the description of its memory.
+ */
+struct LinxRaster {
+  virtual ~LinxRaster() = default;
+  Linx::BufferInfo info;
+  std::vector<long> shape;
+  std::vector<long> strides;
+};
+
+namespace Linx {
+namespace Internal {
+
+thread_local std::string last_error;
+
+/**
+ * @brief Concrete `LinxRaster`.
+ */
+template <typename T, Index N>
+struct OwnedRaster : LinxRaster {
+  explicit OwnedRaster(Raster<T, N> data) : raster(LINX_MOVE(data))
+  {
+    info = buffer_info(raster);
+    shape.assign(info.shape.begin(), info.shape.end());
+    strides.assign(info.strides.begin(), info.strides.end());
+  }
+  Raster<T, N> raster;
+};
+
+BufferInfo buffer_info(const LinxBuffer* buffer)
+{
+  BufferError::may_throw(buffer, "Null buffer descriptor");
+  BufferInfo out;
+  out.data = buffer->data;
+  out.itemsize = buffer->itemsize;
+  out.format = buffer->format ? buffer->format : "";
+  out.shape.assign(buffer->shape, buffer->shape + buffer->ndim);
+  out.strides.assign(buffer->strides, buffer->strides + buffer->ndim);
+  out.readonly = buffer->readonly;
+  return out;
+}
+
+/**
+ * @brief Call `func(in, out)` with `in` and `out` viewed as `PtrRaster<const T, N>` and `PtrRaster<T, N>`.
+ */
+template <typename T, Index N, typename TFunc>
+void visit_as(const BufferInfo& in, const BufferInfo& out, TFunc&& func)
+{
+  const auto in_raster = ptr_raster<const T, N>(in);
+  auto out_raster = ptr_raster<T, N>(out);
+  BufferError::may_throw(in_raster.shape() == out_raster.shape(), "Input and output shapes differ");
+  func(in_raster, out_raster);
+}
+
+/**
+ * @brief Call `func(std::integral_constant<Index, N>())` for `N = dim`.
+ */
+template <typename TFunc>
+void visit_dimension(Index dim, TFunc&& func)
+{
+  switch (dim) {
+    case 1:
+      return func(std::integral_constant<Index, 1>());
+    case 2:
+      return func(std::integral_constant<Index, 2>());
+    case 3:
+      return func(std::integral_constant<Index, 3>());
+  }
+  throw BufferError("Unsupported dimension: " + std::to_string(dim));
+}
+
+/**
+ * @brief Call `func(T())` for the real type `T` which matches a format.
+ */
+template <typename TFunc>
+void visit_real_format(const std::string& format, Index itemsize, TFunc&& func)
+{
+  if (is_buffer_compatible<float>(format, itemsize)) {
+    return func(float());
+  }
+  if (is_buffer_compatible<double>(format, itemsize)) {
+    return func(double());
+  }
+  throw BufferError("Unsupported format: " + format);
+}
+
+/**
+ * @brief Dispatch on the value type and dimension.
+ */
+template <typename TFunc>
+void visit(const LinxBuffer* in, LinxBuffer* out, TFunc&& func)
+{
+  const auto in_info = buffer_info(in);
+  const auto out_info = buffer_info(out);
+  const auto dim = in_info.ndim();
+  if (is_buffer_compatible<float>(in_info.format, in_info.itemsize)) {
+    switch (dim) {
+      case 1:
+        return visit_as<float, 1>(in_info, out_info, func);
+      case 2:
+        return visit_as<float, 2>(in_info, out_info, func);
+      case 3:
+        return visit_as<float, 3>(in_info, out_info, func);
+    }
+  } else if (is_buffer_compatible<double>(in_info.format, in_info.itemsize)) {
+    switch (dim) {
+      case 1:
+        return visit_as<double, 1>(in_info, out_info, func);
+      case 2:
+        return visit_as<double, 2>(in_info, out_info, func);
+      case 3:
+        return visit_as<double, 3>(in_info, out_info, func);
+    }
+  } else {
+    throw BufferError("Unsupported format: " + in_info.format);
+  }
+  throw BufferError("Unsupported dimension: " + std::to_string(dim));
+}
+
+/**
+ * @brief Check whether the memory of two contiguous rasters overlaps, e.g. for NumPy views of the same array.
+ */
+template <typename T, Index N>
+bool overlaps(const PtrRaster<const T, N>& in, const PtrRaster<T, N>& out)
+{
+  const auto in_begin = reinterpret_cast<std::uintptr_t>(in.data());
+  const auto in_end = reinterpret_cast<std::uintptr_t>(in.data() + in.size());
+  const auto out_begin = reinterpret_cast<std::uintptr_t>(out.data());
+  const auto out_end = reinterpret_cast<std::uintptr_t>(out.data() + out.size());
+  return in_begin < out_end && out_begin < in_end;
+}
+
+/**
+ * @brief Apply a filter with named boundary conditions.
+ *
+ * If the input and output share memory, even partially, the filter is applied into a temporary raster.
+ */
+template <typename TFilter, typename T, Index N>
+void filter_into(const TFilter& filter, const PtrRaster<const T, N>& in, PtrRaster<T, N>& out, const char* mode, double cval)
+{
+  if (overlaps(in, out)) {
+    Raster<T, N> tmp(out.shape());
+    auto tmp_view = PtrRaster<T, N>(tmp.shape(), tmp.data());
+    filter_into(filter, in, tmp_view, mode, cval);
+    std::copy(tmp.begin(), tmp.end(), out.begin());
+    return;
+  }
+  const std::string name = mode ? mode : "";
+  if (name == "reflect") {
+    filter.transform(extrapolation<Reflect>(in), out);
+  } else if (name == "constant") {
+    filter.transform(extrapolation<Constant<T>>(in, T(cval)), out);
+  } else if (name == "nearest") {
+    filter.transform(extrapolation<Nearest>(in), out);
+  } else if (name == "wrap") {
+    filter.transform(extrapolation<Periodic>(in), out);
+  } else {
+    throw Exception("Unsupported mode: " + name);
+  }
+}
+
+/**
+ * @brief Get the kernel window, with origin placed like in `scipy.ndimage`.
+ *
+ * In both correlation and convolution, the origin is at index `shape / 2` of the kernel values,
+ * which are reversed in the case of convolution.
+ */
+template <Index N>
+Box<N> kernel_window(const Position<N>& shape, bool reversed)
+{
+  const auto origin = reversed ? shape - 1 - shape / 2 : shape / 2;
+  return Box<N>::from_shape(shape) - origin;
+}
+
+template <typename TFunc>
+int guard(TFunc&& func)
+{
+  try {
+    func();
+    return 0;
+  } catch (std::exception& e) {
+    last_error = e.what();
+  } catch (...) {
+    last_error = "Unknown error";
+  }
+  return 1;
+}
+
+template <bool Convolve>
+int kernel_filter(const LinxBuffer* in, const LinxBuffer* kernel, LinxBuffer* out, const char* mode, double cval)
+{
+  return guard([&]() {
+    const auto kernel_info = buffer_info(kernel);
+    visit(in, out, [&](const auto& i, auto& o) {
+      using T = typename std::decay_t<decltype(o)>::Value;
+      constexpr auto N = std::decay_t<decltype(o)>::Dimension;
+      const auto values = ptr_raster<const T, N>(kernel_info);
+      const auto window = kernel_window(values.shape(), Convolve);
+      if constexpr (Convolve) {
+        filter_into(convolution(values.data(), window), i, o, mode, cval);
+      } else {
+        filter_into(correlation(values.data(), window), i, o, mode, cval);
+      }
+    });
+  });
+}
+
+/**
+ * @brief Get a plan of given logical shape, which is created once per thread and reused.
+ *
+ * Planning with `FFTW_MEASURE` costs much more than a transform, such that plans are cached by shape,
+ * in each thread to allow concurrent transforms.
+ * The cache is cleared when it gets larger than a few plans.
+ */
+template <typename TPlan>
+TPlan& cached_plan(const Position<TPlan::Dimension>& shape)
+{
+  thread_local std::map<std::vector<Index>, std::unique_ptr<TPlan>> plans;
+  std::vector<Index> key(shape.begin(), shape.end());
+  auto it = plans.find(key);
+  if (it == plans.end()) {
+    if (plans.size() >= 8) {
+      plans.clear();
+    }
+    it = plans.emplace(std::move(key), std::make_unique<TPlan>(shape)).first;
+  }
+  return *it->second;
+}
+
+/**
+ * @brief Compute a DFT from a buffer into a buffer.
+ * @param logical_shape The logical shape of the transform, in C order
+ *
+ * The input is copied into the buffer of a cached plan and the result is copied out of it,
+ * such that the input and output buffers may overlap, even partially and with different value types.
+ */
+template <typename TPlan>
+void dft_into(const LinxBuffer* in, LinxBuffer* out, bool normalize, bool logical_is_input)
+{
+  using TIn = typename TPlan::InValue;
+  using TOut = typename TPlan::OutValue;
+  constexpr auto N = TPlan::Dimension;
+  const auto in_raster = ptr_raster<const TIn, N>(buffer_info(in));
+  auto out_raster = ptr_raster<TOut, N>(buffer_info(out));
+  const auto shape = logical_is_input ? in_raster.shape() : out_raster.shape();
+  BufferError::may_throw(
+      TPlan::Transform::in_shape(shape) == in_raster.shape() &&
+          TPlan::Transform::out_shape(shape) == out_raster.shape(),
+      "Incompatible input and output shapes");
+  auto& plan = cached_plan<TPlan>(shape);
+  std::copy_n(in_raster.data(), in_raster.size(), plan.in().data());
+  plan.transform();
+  if (normalize) {
+    plan.normalize();
+  }
+  std::copy_n(plan.out().data(), out_raster.size(), out_raster.data());
+}
+
+} // namespace Internal
+} // namespace Linx
+
+extern "C" {
+
+const char* linx_last_error()
+{
+  return Linx::Internal::last_error.c_str();
+}
+
+int linx_raster_new(const char* format, long ndim, const long* shape, LinxRaster** out)
+{
+  using namespace Linx;
+  return Internal::guard([&]() {
+    const std::string name = format ? format : "";
+    const auto make = [&](auto value) {
+      using T = decltype(value);
+      Internal::visit_dimension(ndim, [&](auto n) {
+        constexpr auto N = decltype(n)::value;
+        Position<N> s;
+        std::reverse_copy(shape, shape + N, s.begin());
+        *out = new Internal::OwnedRaster<T, N>(Raster<T, N>(s));
+      });
+    };
+    if (name == "Zd") {
+      make(std::complex<double>());
+    } else {
+      Internal::visit_real_format(name, name == "f" ? 4 : 8, make);
+    }
+  });
+}
+
+void linx_raster_free(LinxRaster* raster)
+{
+  delete raster;
+}
+
+int linx_raster_buffer(LinxRaster* raster, LinxBuffer* out)
+{
+  using namespace Linx;
+  return Internal::guard([&]() {
+    BufferError::may_throw(raster && out, "Null raster or buffer descriptor");
+    const auto& info = raster->info;
+    *out = {info.data, info.itemsize, info.format.c_str(), info.ndim(), raster->shape.data(), raster->strides.data(), 0};
+  });
+}
+
+int linx_fits_read(const char* path, long hdu, const char* format, LinxRaster** out)
+{
+  using namespace Linx;
+  return Internal::guard([&]() {
+    const std::string name = format ? format : "";
+    Fits fits(path);
+    const auto dim = fits.read_shape<-1>(hdu).size();
+    Internal::visit_real_format(name, name == "f" ? 4 : 8, [&](auto value) {
+      using T = decltype(value);
+      Internal::visit_dimension(dim, [&](auto n) {
+        constexpr auto N = decltype(n)::value;
+        *out = new Internal::OwnedRaster<T, N>(fits.read<Raster<T, N>>(hdu));
+      });
+    });
+  });
+}
+
+int linx_fits_write(const char* path, const LinxBuffer* in, char mode)
+{
+  using namespace Linx;
+  return Internal::guard([&]() {
+    const auto info = Internal::buffer_info(in);
+    Internal::visit_real_format(info.format, info.itemsize, [&](auto value) {
+      using T = decltype(value);
+      Internal::visit_dimension(info.ndim(), [&](auto n) {
+        constexpr auto N = decltype(n)::value;
+        Fits(path).write(ptr_raster<const T, N>(info), mode);
+      });
+    });
+  });
+}
+
+int linx_dft(const LinxBuffer* in, LinxBuffer* out, int inverse)
+{
+  using namespace Linx;
+  return Internal::guard([&]() {
+    Internal::visit_dimension(Internal::buffer_info(in).ndim(), [&](auto n) {
+      constexpr auto N = decltype(n)::value;
+      if (inverse) {
+        Internal::dft_into<typename ComplexDft<N>::Inverse>(in, out, true, true);
+      } else {
+        Internal::dft_into<ComplexDft<N>>(in, out, false, true);
+      }
+    });
+  });
+}
+
+int linx_real_dft(const LinxBuffer* in, LinxBuffer* out)
+{
+  using namespace Linx;
+  return Internal::guard([&]() {
+    Internal::visit_dimension(Internal::buffer_info(in).ndim(), [&](auto n) {
+      Internal::dft_into<RealDft<decltype(n)::value>>(in, out, false, true);
+    });
+  });
+}
+
+int linx_inverse_real_dft(const LinxBuffer* in, LinxBuffer* out)
+{
+  using namespace Linx;
+  return Internal::guard([&]() {
+    Internal::visit_dimension(Internal::buffer_info(in).ndim(), [&](auto n) {
+      Internal::dft_into<typename RealDft<decltype(n)::value>::Inverse>(in, out, true, false);
+    });
+  });
+}
+
+int linx_correlate(const LinxBuffer* in, const LinxBuffer* kernel, LinxBuffer* out, const char* mode, double cval)
+{
+  return Linx::Internal::kernel_filter<false>(in, kernel, out, mode, cval);
+}
+
+int linx_convolve(const LinxBuffer* in, const LinxBuffer* kernel, LinxBuffer* out, const char* mode, double cval)
+{
+  return Linx::Internal::kernel_filter<true>(in, kernel, out, mode, cval);
+}
+
+int linx_box_filter(
+    const LinxBuffer* in,
+    const char* filter,
+    const long* radius,
+    LinxBuffer* out,
+    const char* mode,
+    double cval)
+{
+  using namespace Linx;
+  return Internal::guard([&]() {
+    const std::string name = filter ? filter : "";
+    Internal::visit(in, out, [&](const auto& i, auto& o) {
+      using T = typename std::decay_t<decltype(o)>::Value;
+      constexpr auto N = std::decay_t<decltype(o)>::Dimension;
+      Position<N> r;
+      std::reverse_copy(radius, radius + N, r.begin());
+      const auto window = Box<N>(-r, r);
+      if (name == "mean") {
+        Internal::filter_into(mean_filter<T>(window), i, o, mode, cval);
+      } else if (name == "median") {
+        Internal::filter_into(median_filter<T>(window), i, o, mode, cval);
+      } else if (name == "minimum") {
+        Internal::filter_into(minimum_filter<T>(window), i, o, mode, cval);
+      } else if (name == "maximum") {
+        Internal::filter_into(maximum_filter<T>(window), i, o, mode, cval);
+      } else {
+        throw Exception("Unsupported filter: " + name);
+      }
+    });
+  });
+}
+}
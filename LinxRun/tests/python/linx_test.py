@@ -0,0 +1,104 @@
+# @copyright 2022-2024, Antoine Basset (CNES)
+# This file is part of Linx <github.com/kabasset/Linx>
+# SPDX-License-Identifier: Apache-2.0
+
+import numpy as np
+import pytest
+
+from LinxRun import linx
+
+
+@pytest.fixture
+def image():
+    return np.random.default_rng(0).random((7, 9))
+
+
+@pytest.mark.parametrize('mode', ['reflect', 'constant', 'nearest', 'wrap'])
+@pytest.mark.parametrize('name', ['correlate', 'convolve'])
+def test_kernel_filters_match_scipy(image, name, mode):
+    ndimage = pytest.importorskip('scipy.ndimage')
+    weights = np.arange(9, dtype=np.float64).reshape(3, 3)
+    expected = getattr(ndimage, name)(image, weights, mode=mode, cval=1.5)
+    result = getattr(linx, name)(image, weights, mode=mode, cval=1.5)
+    np.testing.assert_allclose(result, expected)
+
+
+@pytest.mark.parametrize('name', ['uniform_filter', 'median_filter', 'minimum_filter', 'maximum_filter'])
+def test_box_filters_match_scipy_with_default_mode(image, name):
+    ndimage = pytest.importorskip('scipy.ndimage')
+    expected = getattr(ndimage, name)(image, size=3)
+    result = getattr(linx, name)(image, size=3)
+    np.testing.assert_allclose(result, expected)
+
+
+def test_reflect_is_default(image):
+    weights = np.ones((1, 3))
+    result = linx.correlate(image, weights)
+    padded = np.pad(image, ((0, 0), (1, 1)), mode='symmetric')
+    expected = padded[:, :-2] + padded[:, 1:-1] + padded[:, 2:]
+    np.testing.assert_allclose(result, expected)
+
+
+def test_in_place_filter(image):
+    expected = linx.minimum_filter(image, size=3)
+    result = linx.minimum_filter(image, size=3, output=image)
+    assert result is image
+    np.testing.assert_array_equal(image, expected)
+
+
+def test_overlapping_output():
+    data = np.random.default_rng(1).random((8, 9))
+    expected = linx.uniform_filter(data[:-1].copy(), size=3)
+    linx.uniform_filter(data[:-1], size=3, output=data[1:])
+    np.testing.assert_allclose(data[1:], expected)
+
+
+def test_raster_is_viewed_without_copy():
+    raster = linx.Raster.empty((3, 4), np.float32)
+    array = np.asarray(raster)
+    assert array.shape == (3, 4)
+    assert array.dtype == np.float32
+    array[...] = 1
+    assert np.asarray(raster).sum() == 12
+    assert array.__array_interface__['data'][0] == raster.__array_interface__['data'][0]
+
+
+def test_dfts_match_numpy(image):
+    np.testing.assert_allclose(linx.fftn(image), np.fft.fftn(image))
+    np.testing.assert_allclose(linx.rfftn(image), np.fft.rfftn(image))
+    spectrum = np.fft.fftn(image)
+    np.testing.assert_allclose(linx.ifftn(spectrum), np.fft.ifftn(spectrum))
+    half = np.fft.rfftn(image)
+    np.testing.assert_allclose(linx.irfftn(half, s=image.shape), image)
+
+
+def test_in_place_dft(image):
+    data = image.astype(np.complex128)
+    expected = np.fft.fftn(data)
+    result = linx.fftn(data, output=data)
+    assert result is data
+    np.testing.assert_allclose(data, expected)
+
+
+def test_overlapping_dft_output():
+    data = np.random.default_rng(2).random((8, 9)).astype(np.complex128)
+    expected = np.fft.fftn(data[:-1])
+    linx.fftn(data[:-1], output=data[1:])
+    np.testing.assert_allclose(data[1:], expected)
+    memory = np.zeros(64, dtype=np.complex128)
+    real = memory.view(np.float64)[:7 * 8].reshape(7, 8)
+    real[...] = np.random.default_rng(3).random((7, 8))
+    expected = np.fft.rfftn(real)
+    output = memory[1:1 + 7 * 5].reshape(7, 5)  # Overlaps the real input
+    linx.rfftn(real, output=output)
+    np.testing.assert_allclose(output, expected)
+
+
+def test_fits_round_trip(image, tmp_path):
+    path = tmp_path / 'image.fits'
+    linx.write_fits(path, image)
+    linx.write_fits(path, image.astype(np.float32) * 2, mode='a')
+    np.testing.assert_array_equal(linx.read_fits(path), image)
+    np.testing.assert_array_equal(linx.read_fits(path, 1, np.float32), image.astype(np.float32) * 2)
+    with pytest.raises(RuntimeError):
+        linx.write_fits(path, image)
@@ -0,0 +1,88 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Run/DistributedRaster.h"
+#include "Linx/Transforms/Filters.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+struct MpiFixture {
+  MpiFixture()
+  {
+    MPI_Init(nullptr, nullptr);
+  }
+  ~MpiFixture()
+  {
+    MPI_Finalize();
+  }
+};
+
+BOOST_TEST_GLOBAL_FIXTURE(MpiFixture);
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(DistributedRaster_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(scatter_gather_test)
+{
+  Raster<int> in({7, 11});
+  in.range();
+  const auto distributed = DistributedRaster<int>::scatter(in, Box<2>({-1, -1}, {1, 1}));
+  for (const auto& p : distributed.halo()) {
+    BOOST_TEST(distributed[p] == in[p]);
+  }
+  const auto out = distributed.gather();
+  if (distributed.rank() == 0) {
+    BOOST_TEST(out == in);
+  } else {
+    BOOST_TEST(out.size() == 0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(exchange_test)
+{
+  const Box<2> margin({-1, -2}, {1, 2});
+  DistributedRaster<long> raster({5, 9}, margin);
+  raster.local().fill(-1);
+  const auto part = raster.part();
+  for (const auto& p : part) {
+    raster[p] = p[0] + 10 * p[1];
+  }
+  raster.exchange();
+  for (const auto& p : raster.halo()) {
+    BOOST_TEST(raster[p] == p[0] + 10 * p[1]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(filter_test)
+{
+  Raster<float> in({13, 17});
+  in.range();
+  in.apply([](auto v) {
+    return std::sin(v);
+  });
+  const auto filter = mean_filter<float>(Box<2>({-1, -2}, {1, 2}));
+  const auto expected = filter * extrapolation(in, 1.F);
+  auto distributed = DistributedRaster<float>::scatter(in, Box<2>({-2, -2}, {2, 2}));
+  distributed.apply([](auto v) {
+    return v * 2;
+  });
+  distributed.apply([](auto v) {
+    return v / 2;
+  });
+  const auto filtered = distributed.filter<Constant<float>>(filter, 1.F);
+  const auto out = filtered.gather();
+  if (filtered.rank() == 0) {
+    BOOST_TEST(out == expected);
+  }
+  BOOST_CHECK_THROW(distributed.filter(mean_filter<float>(Box<2>({-3, 0}, {0, 0}))), Exception);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,148 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/BufferInfo.h"
+#include "Linx/Transforms/Extrapolation.h"
+#include "Linx/Transforms/Filters.h"
+#include "LinxRun/PythonApi.h"
+
+#include <boost/test/unit_test.hpp>
+#include <complex>
+#include <numeric>
+
+using namespace Linx;
+
+struct BufferFixture {
+  template <typename T, Index N>
+  BufferFixture(Raster<T, N>& raster) :
+      info(buffer_info(raster)), shape(info.shape.begin(), info.shape.end()),
+      strides(info.strides.begin(), info.strides.end()),
+      buffer {info.data, info.itemsize, info.format.c_str(), info.ndim(), shape.data(), strides.data(), 0}
+  {}
+  BufferInfo info;
+  std::vector<long> shape;
+  std::vector<long> strides;
+  LinxBuffer buffer;
+};
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(PythonApi_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(correlate_test)
+{
+  Raster<float> in({5, 4});
+  in.range();
+  Raster<float> kernel({3, 2});
+  kernel.range();
+  Raster<float> out(in.shape());
+  BufferFixture in_buffer(in);
+  BufferFixture kernel_buffer(kernel);
+  BufferFixture out_buffer(out);
+  const auto status = linx_correlate(&in_buffer.buffer, &kernel_buffer.buffer, &out_buffer.buffer, "nearest", 0);
+  BOOST_TEST(status == 0);
+  const auto expected = correlation(kernel, Position<2>({1, 1})) * extrapolation<Nearest>(in);
+  BOOST_TEST(out == expected);
+}
+
+BOOST_AUTO_TEST_CASE(in_place_box_filter_test)
+{
+  Raster<double, 3> in({4, 3, 2});
+  in.range();
+  const auto expected = mean_filter<double>(Box<3>({-1, 0, 0}, {1, 0, 0})) * extrapolation(in, 0.);
+  BufferFixture buffer(in);
+  const long radius[] = {0, 0, 1};
+  const auto status = linx_box_filter(&buffer.buffer, "mean", radius, &buffer.buffer, "constant", 0);
+  BOOST_TEST(status == 0);
+  BOOST_TEST(in == expected);
+}
+
+BOOST_AUTO_TEST_CASE(overlapping_box_filter_test)
+{
+  Raster<double> data({4, 5});
+  data.range();
+  Raster<double> in({4, 4}, data.begin());
+  const auto expected = mean_filter<double>(Box<2>({-1, -1}, {1, 1})) * extrapolation<Nearest>(in);
+  BufferFixture in_buffer(data);
+  in_buffer.shape[0] = 4; // First 4 rows, buffer order
+  BufferFixture out_buffer(data);
+  out_buffer.shape[0] = 4; // Last 4 rows
+  out_buffer.buffer.data = data.data() + 4;
+  const long radius[] = {1, 1};
+  const auto status = linx_box_filter(&in_buffer.buffer, "mean", radius, &out_buffer.buffer, "nearest", 0);
+  BOOST_TEST(status == 0);
+  const Raster<double> out({4, 4}, data.begin() + 4);
+  BOOST_TEST(out == expected);
+}
+
+BOOST_AUTO_TEST_CASE(error_test)
+{
+  Raster<float> in({5, 4});
+  Raster<double> out(in.shape());
+  BufferFixture in_buffer(in);
+  BufferFixture out_buffer(out);
+  const long radius[] = {1, 1};
+  BOOST_TEST(linx_box_filter(&in_buffer.buffer, "mean", radius, &out_buffer.buffer, "nearest", 0) != 0);
+  BOOST_TEST(std::string(linx_last_error()).find("Buffer error") == 0);
+  BOOST_TEST(linx_box_filter(&in_buffer.buffer, "mean", radius, &in_buffer.buffer, "mirror", 0) != 0);
+  BOOST_TEST(std::string(linx_last_error()).find("mirror") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(reflect_correlate_test)
+{
+  Raster<double> in({5, 4});
+  in.range();
+  Raster<double> kernel({3, 3});
+  kernel.range();
+  Raster<double> out(in.shape());
+  BufferFixture in_buffer(in);
+  BufferFixture kernel_buffer(kernel);
+  BufferFixture out_buffer(out);
+  const auto status = linx_correlate(&in_buffer.buffer, &kernel_buffer.buffer, &out_buffer.buffer, "reflect", 0);
+  BOOST_TEST(status == 0);
+  const auto expected = correlation(kernel, Position<2>({1, 1})) * extrapolation<Reflect>(in);
+  BOOST_TEST(out == expected);
+}
+
+BOOST_AUTO_TEST_CASE(raster_buffer_test)
+{
+  const long shape[] = {2, 3, 4};
+  LinxRaster* raster = nullptr;
+  BOOST_TEST(linx_raster_new("f", 3, shape, &raster) == 0);
+  LinxBuffer buffer;
+  BOOST_TEST(linx_raster_buffer(raster, &buffer) == 0);
+  BOOST_TEST(buffer.ndim == 3);
+  BOOST_TEST(std::string(buffer.format) == "f");
+  for (long i = 0; i < 3; ++i) {
+    BOOST_TEST(buffer.shape[i] == shape[i]);
+  }
+  BOOST_TEST(buffer.strides[0] == 3 * 4 * 4);
+  BOOST_TEST(buffer.strides[2] == 4);
+  linx_raster_free(raster);
+  BOOST_TEST(linx_raster_new("i", 3, shape, &raster) != 0);
+}
+
+BOOST_AUTO_TEST_CASE(real_dft_round_trip_test)
+{
+  Raster<double> in({6, 4});
+  in.range();
+  Raster<std::complex<double>> freq({4, 4});
+  Raster<double> out(in.shape());
+  BufferFixture in_buffer(in);
+  BufferFixture freq_buffer(freq);
+  BufferFixture out_buffer(out);
+  BOOST_TEST(linx_real_dft(&in_buffer.buffer, &freq_buffer.buffer) == 0);
+  BOOST_TEST(std::abs(freq[0] - std::accumulate(in.begin(), in.end(), 0.)) < 1e-9);
+  BOOST_TEST(linx_inverse_real_dft(&freq_buffer.buffer, &out_buffer.buffer) == 0);
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    BOOST_TEST(std::abs(out[i] - in[i]) < 1e-9);
+  }
+  BOOST_TEST(linx_real_dft(&in_buffer.buffer, &in_buffer.buffer) != 0);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
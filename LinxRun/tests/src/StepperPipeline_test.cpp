@@ -2,6 +2,7 @@
 // This file is part of Linx <github.com/kabasset/Linx>
 // SPDX-License-Identifier: Apache-2.0
 
+#include "Linx/Base/Holders.h"
 #include "Linx/Run/StepperPipeline.h"
 
 #include <boost/test/unit_test.hpp>
@@ -24,6 +25,10 @@ struct Step2 : PipelineStep<long(Step1a, Step1b)> {
   Value value = 0;
 };
 
+struct Nested : PipelineStep<long()> { // Triggers Step1b during its evaluation
+  Value value = 0;
+};
+
 class Dag : public StepperPipeline<Dag> {
 public:
 
@@ -62,6 +67,7 @@ private:
   Step1a m_1a;
   Step1b m_1b;
   Step2 m_2;
+  Nested m_nested;
 };
 
 template <>
@@ -81,6 +87,7 @@ void Dag::evaluate_impl<Step1a>()
 template <>
 void Dag::evaluate_impl<Step1b>()
 {
+  StdHolder<std::vector<int>> buffer(1000); // For memory_test
   ++m_value;
   m_1b.value = m_value;
 }
@@ -92,6 +99,15 @@ void Dag::evaluate_impl<Step2>()
   m_2.value = m_value;
 }
 
+template <>
+void Dag::evaluate_impl<Nested>()
+{
+  {
+    StdHolder<std::vector<int>> buffer(2000); // For nested_memory_test
+  }
+  m_nested.value = get<Step1b>();
+}
+
 template <>
 Step0::Value Dag::get_impl<Step0>()
 {
@@ -116,6 +132,12 @@ Step2::Value Dag::get_impl<Step2>()
   return m_2.value;
 }
 
+template <>
+Nested::Value Dag::get_impl<Nested>()
+{
+  return m_nested.value;
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE(StepperPipeline_test)
@@ -185,6 +207,37 @@ BOOST_AUTO_TEST_CASE(all_in_one_test)
   BOOST_TEST(dag.milliseconds<Step2>() > 0);
 }
 
+BOOST_AUTO_TEST_CASE(memory_test)
+{
+  Dag dag;
+  dag.get<Step2>();
+  const auto stats = dag.memory<Step1b>();
+  if (Instrumentation::enabled()) {
+    BOOST_TEST(stats.allocations == 1);
+    BOOST_TEST(stats.deallocations == 1);
+    BOOST_TEST(stats.peak_bytes >= 1000 * sizeof(int));
+  } else {
+    BOOST_TEST(stats.allocations == 0);
+  }
+  BOOST_TEST(dag.memory<Step0>().allocations == 0);
+}
+
+BOOST_AUTO_TEST_CASE(nested_memory_test)
+{
+  Dag dag;
+  BOOST_TEST(dag.get<Nested>() == 2);
+  const auto stats = dag.memory<Nested>();
+  const auto nested_stats = dag.memory<Step1b>();
+  if (Instrumentation::enabled()) {
+    BOOST_TEST(stats.allocations == 2);
+    BOOST_TEST(stats.peak_bytes >= 2000 * sizeof(int));
+    BOOST_TEST(nested_stats.peak_bytes >= 1000 * sizeof(int));
+    BOOST_TEST(nested_stats.peak_bytes < 2000 * sizeof(int));
+  } else {
+    BOOST_TEST(stats.allocations == 0);
+  }
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,327 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef _LINXTRANSFORMS_DECONVOLUTION_H
+#define _LINXTRANSFORMS_DECONVOLUTION_H
+
+#include "Linx/Data/Raster.h"
+#include "LinxTransforms/Dft.h"
+
+#include <algorithm>
+#include <complex>
+#include <functional>
+
+namespace Linx {
+
+/**
+ * @ingroup dft
+ * @brief FFT-based iterative deconvolution engine.
+ * @tparam N The dimension
+ *
+ * The engine restores an image blurred by a known PSF with Richardson-Lucy or Landweber iterations,
+ * each of which requires a convolution by the PSF and a correlation by the PSF (i.e. a convolution by its adjoint).
+ * Both are computed in Fourier space, with a single pair of plans:
+ * the PSF spectrum is computed once at construction,
+ * the adjoint spectrum being its complex conjugate,
+ * and all the buffers and work rasters are allocated once, such that iterations are performed in place.
+ * The spectrum is prescaled such that the inverse transforms need no normalization.
+ *
+ * The engine can be reused for several images of the same shape and PSF with `reset()`,
+ * such that planning and PSF transform are amortized.
+ *
+ * Convolutions are circular: if the image has no periodic boundaries,
+ * it should be padded beforehand, e.g. with `Extrapolation::copy()`.
+ *
+ * \code
+ * Deconvolution<2> deconvolution(psf, image);
+ * deconvolution.richardson_lucy(50, true);
+ * const auto& restored = deconvolution.estimate();
+ * \endcode
+ */
+template <Index N = 2>
+class Deconvolution {
+public:
+
+  /**
+   * @brief The dimension parameter.
+   */
+  static constexpr Index Dimension = N;
+
+  /// @{
+  /// @group_construction
+
+  /**
+   * @brief Constructor.
+   * @param psf The PSF, centered at `psf.shape() / 2`, whose sum is normalized to 1
+   * @param shape The image shape
+   *
+   * The PSF must not be larger than the image.
+   */
+  template <typename TPsf>
+  Deconvolution(const TPsf& psf, const Position<N>& shape) :
+      m_dft(shape), m_idft(m_dft.inverse()), m_spectrum(m_dft.out_shape()), m_data(shape), m_estimate(shape),
+      m_previous(), m_gradient(), m_alpha(0)
+  {
+    auto& in = m_dft.in();
+    in.fill(0);
+    double sum = 0;
+    for (const auto& e : psf) {
+      sum += e;
+    }
+    const Index dim = shape.size();
+    for (const auto& p : psf.domain()) {
+      auto q = p;
+      for (Index i = 0; i < dim; ++i) {
+        q[i] = (p[i] - psf.length(i) / 2) % shape[i];
+        if (q[i] < 0) {
+          q[i] += shape[i];
+        }
+      }
+      in[q] += psf[p] / sum;
+    }
+    m_dft.transform();
+    const auto factor = 1. / m_dft.normalization_factor();
+    std::transform(m_dft.out().begin(), m_dft.out().end(), m_spectrum.begin(), [=](const auto& c) {
+      return c * factor;
+    });
+    m_data.fill(0);
+    m_estimate.fill(0);
+  }
+
+  /**
+   * @brief Constructor with initial image.
+   * @see `reset()`
+   */
+  template <typename TPsf, typename TRaster>
+  Deconvolution(const TPsf& psf, const TRaster& data) : Deconvolution(psf, data.shape())
+  {
+    reset(data);
+  }
+
+  /// @group_properties
+
+  /**
+   * @brief Get the image shape.
+   */
+  const Position<N>& shape() const
+  {
+    return m_data.shape();
+  }
+
+  /**
+   * @brief Get the PSF spectrum, i.e. the optical transfer function, scaled by the inverse of the image size.
+   */
+  const ComplexDftBuffer<N>& spectrum() const
+  {
+    return m_spectrum;
+  }
+
+  /**
+   * @brief Get the current estimate.
+   */
+  const Raster<double, N>& estimate() const
+  {
+    return m_estimate;
+  }
+
+  /// @group_modifiers
+
+  /**
+   * @brief Set the image to be deconvolved and reset the estimate.
+   * @param data The blurred image, of same shape as the engine
+   *
+   * The estimate is initialized as a flat image with the same total flux as the data.
+   */
+  template <typename TRaster>
+  void reset(const TRaster& data)
+  {
+    if (data.shape() != shape()) {
+      throw SizeError(data.size(), m_data.size());
+    }
+    std::copy(data.begin(), data.end(), m_data.begin());
+    double sum = 0;
+    for (const auto& e : m_data) {
+      sum += e;
+    }
+    m_estimate.fill(std::max(sum / m_data.size(), 0.));
+    m_previous = Raster<double, N>();
+    m_gradient = Raster<double, N>();
+    m_alpha = 0;
+  }
+
+  /**
+   * @brief Run Richardson-Lucy iterations.
+   * @param iterations The number of iterations
+   * @param accelerate Whether to apply the Biggs-Andrews vector extrapolation
+   *
+   * Each iteration multiplies the estimate by the correlation of the PSF with the ratio
+   * between the data and the convolution of the estimate by the PSF.
+   * This is the maximum-likelihood estimator for Poisson noise, which preserves positivity and total flux.
+   * The data should therefore be non-negative.
+   *
+   * With acceleration, the estimate is first extrapolated along the direction of the previous update,
+   * by a factor which is deduced from the correlation of the last two updates,
+   * which typically divides the number of iterations by a few.
+   * This requires two more rasters.
+   *
+   * Iterations can be resumed by calling the method again.
+   */
+  void richardson_lucy(Index iterations, bool accelerate = false)
+  {
+    if (accelerate && m_previous.size() == 0) {
+      m_previous = m_estimate;
+      m_gradient = Raster<double, N>(shape());
+      m_gradient.fill(0);
+    } else if (not accelerate) {
+      m_previous = Raster<double, N>();
+      m_gradient = Raster<double, N>();
+      m_alpha = 0;
+    }
+    auto& buffer = m_dft.in();
+    for (Index k = 0; k < iterations; ++k) {
+
+      // Extrapolate the estimate
+      if (accelerate) {
+        const auto alpha = m_alpha;
+        auto* prev = m_previous.data();
+        for (auto& e : m_estimate) {
+          const auto x = e;
+          e = std::max(x + alpha * (x - *prev), 0.);
+          *prev = x;
+          ++prev;
+        }
+      }
+
+      // Ratio between data and convolved estimate
+      std::copy(m_estimate.begin(), m_estimate.end(), buffer.begin());
+      convolve(false);
+      buffer.generate(
+          [](auto blurred, auto d) {
+            return blurred > 0 ? d / blurred : 0.;
+          },
+          buffer,
+          m_data);
+
+      // Multiplicative update
+      convolve(true);
+      if (accelerate) {
+        double num = 0;
+        double den = 0;
+        const auto* ratio = buffer.data();
+        auto* g = m_gradient.data();
+        for (auto it = m_estimate.begin(); it != m_estimate.end(); ++it, ++ratio, ++g) {
+          const auto y = *it;
+          *it *= *ratio;
+          const auto update = *it - y;
+          num += update * *g;
+          den += *g * *g;
+          *g = update;
+        }
+        m_alpha = den > 0 ? std::clamp(num / den, 0., 1.) : 0.;
+      } else {
+        m_estimate.generate(std::multiplies<double>(), m_estimate, buffer);
+      }
+    }
+  }
+
+  /**
+   * @brief Run Landweber iterations.
+   * @param iterations The number of iterations
+   * @param step The gradient step, which must lie in `(0, 2)` for convergence
+   * @param positive Whether to project the estimate onto non-negative values at each iteration
+   *
+   * Each iteration adds to the estimate the correlation of the PSF with the residual,
+   * i.e. performs a gradient descent step on the least squares data fidelity.
+   * Since the PSF sums to 1, the step is relative to the maximum step.
+   */
+  void landweber(Index iterations, double step = 1, bool positive = true)
+  {
+    auto& buffer = m_dft.in();
+    for (Index k = 0; k < iterations; ++k) {
+      std::copy(m_estimate.begin(), m_estimate.end(), buffer.begin());
+      convolve(false);
+      buffer.generate(
+          [](auto blurred, auto d) {
+            return d - blurred;
+          },
+          buffer,
+          m_data);
+      convolve(true);
+      m_estimate.generate(
+          [=](auto x, auto residual) {
+            const auto y = x + step * residual;
+            return positive ? std::max(y, 0.) : y;
+          },
+          m_estimate,
+          buffer);
+    }
+  }
+
+  /// @}
+
+private:
+
+  /**
+   * @brief Convolve or correlate the input buffer with the PSF, in place.
+   */
+  void convolve(bool adjoint)
+  {
+    m_dft.transform();
+    auto& out = m_dft.out();
+    if (adjoint) {
+      std::transform(out.begin(), out.end(), m_spectrum.begin(), out.begin(), [](const auto& c, const auto& s) {
+        return c * std::conj(s);
+      });
+    } else {
+      std::transform(out.begin(), out.end(), m_spectrum.begin(), out.begin(), [](const auto& c, const auto& s) {
+        return c * s;
+      });
+    }
+    m_idft.transform();
+  }
+
+  /**
+   * @brief The direct plan, whose input buffer is the work raster.
+   */
+  RealDft<N> m_dft;
+
+  /**
+   * @brief The inverse plan, with shared buffers.
+   */
+  typename RealDft<N>::Inverse m_idft;
+
+  /**
+   * @brief The scaled PSF spectrum.
+   */
+  ComplexDftBuffer<N> m_spectrum;
+
+  /**
+   * @brief The blurred image.
+   */
+  Raster<double, N> m_data;
+
+  /**
+   * @brief The current estimate.
+   */
+  Raster<double, N> m_estimate;
+
+  /**
+   * @brief The previous estimate, for acceleration.
+   */
+  Raster<double, N> m_previous;
+
+  /**
+   * @brief The previous update, for acceleration.
+   */
+  Raster<double, N> m_gradient;
+
+  /**
+   * @brief The extrapolation factor, for acceleration.
+   */
+  double m_alpha;
+};
+
+} // namespace Linx
+
+#endif
@@ -8,6 +8,7 @@
 #include <complex>
 #include <fftw3.h>
 #include <memory>
+#include <mutex>
 
 namespace Linx {
 
@@ -29,6 +30,8 @@ using FftwPlanPtr = std::unique_ptr<fftw_plan>;
  * 
  * This is a Meyer's singleton.
  * The destructor, which is executed once (at the end of the program), calls `fftw_cleanup()`.
+ * As the FFTW planner is not thread-safe, plan creations and destructions are serialized with a mutex,
+ * while plans can be executed concurrently.
  */
 class FftwAllocator {
 private:
@@ -58,6 +61,15 @@ private:
     return allocator;
   }
 
+  /**
+   * @brief Get the planner mutex.
+   */
+  static std::mutex& planner_mutex()
+  {
+    static std::mutex mutex;
+    return mutex;
+  }
+
 public:
 
   /**
@@ -79,6 +91,7 @@ public:
   static Internal::FftwPlanPtr create_plan(TIn& in, TOut& out)
   {
     instantiate();
+    std::lock_guard<std::mutex> lock(planner_mutex());
     return TTransform::allocate_fftw_plan(in, out);
   }
 
@@ -88,6 +101,7 @@ public:
   static void destroy_plan(Internal::FftwPlanPtr& plan)
   {
     if (plan) {
+      std::lock_guard<std::mutex> lock(planner_mutex());
       fftw_destroy_plan(*plan);
     }
   }
@@ -2,4 +2,5 @@
 // This file is part of Linx <github.com/kabasset/Linx>
 // SPDX-License-Identifier: GPL-3.0-or-later
 
+#include "LinxTransforms/Deconvolution.h"
 #include "LinxTransforms/Dft.h"
@@ -2,7 +2,9 @@
 // This file is part of Linx <github.com/kabasset/Linx>
 // SPDX-License-Identifier: Apache-2.0
 
+#include "Linx/Data/BlockedRaster.h"
 #include "Linx/Transforms/Affinity.h"
+#include "Linx/Transforms/Extrapolation.h"
 
 #include <boost/test/unit_test.hpp>
 
@@ -93,6 +95,50 @@ BOOST_AUTO_TEST_CASE(rotation_float_90z_test)
   BOOST_TEST(out == expected, boost::test_tools::tolerance(1.e-6) << boost::test_tools::per_element());
 }
 
+template <typename TMethod>
+void test_separable_translation(const Vector<double, 3>& vector)
+{
+  auto in = Raster<double, 3>({7, 6, 5}).generate([i = 0]() mutable {
+    ++i;
+    return (i * 37) % 11;
+  });
+  const auto extrapolator = extrapolation<Nearest>(in);
+  const auto interpolator = interpolation<TMethod>(extrapolator);
+  const auto translation = Affinity<3>::translation(vector);
+  BOOST_TEST(translation.is_translation());
+  const auto out = translate<TMethod>(extrapolator, vector);
+  BOOST_TEST(out.shape() == in.shape());
+  for (const auto& p : out.domain()) {
+    BOOST_TEST(out[p] == interpolator(Vector<double, 3>(p) - vector), boost::test_tools::tolerance(1.e-9));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(separable_translation_test)
+{
+  const Vector<double, 3> subpixel {0.3, -1.75, 2.5};
+  const Vector<double, 3> integral {1, -2, 0};
+  test_separable_translation<Linear>(subpixel);
+  test_separable_translation<Cubic>(subpixel);
+  test_separable_translation<Linear>(integral);
+  test_separable_translation<Cubic>(integral);
+  test_separable_translation<Nearest>(integral);
+  BOOST_TEST(not Affinity<3>::scaling(2).is_translation());
+}
+
+BOOST_AUTO_TEST_CASE(nearest_negative_subpixel_translation_test)
+{
+  const auto in = Raster<double, 2>({6, 5}).range();
+  const auto extrapolator = extrapolation(in, -1.);
+  const auto interpolator = interpolation<Nearest>(extrapolator);
+  const Vector<double, 2> vector {0.7, -1.25};
+  const auto out = translate<Nearest>(extrapolator, vector);
+  for (const auto& p : out.domain()) {
+    BOOST_TEST(out[p] == interpolator(Vector<double, 2>(p) - vector));
+  }
+  const Position<2> left {0, 0}; // At -0.7, rounded to -1 and extrapolated
+  BOOST_TEST(out[left] == -1.);
+}
+
 BOOST_AUTO_TEST_CASE(raster_scaling_center_2_test)
 {
   const auto in = Raster<Index, 4>({3, 3, 3, 3}).range();
@@ -145,6 +191,19 @@ BOOST_AUTO_TEST_CASE(patch_rotation_center_30z_test)
   }
 }
 
+BOOST_AUTO_TEST_CASE(blocked_rotation_test)
+{
+  const auto in = Raster<float>({150, 100}).range();
+  const auto blocked_in = blocked<4>(in);
+  const auto out = rotate_deg<Linear>(extrapolation(in), 30);
+  const auto blocked_out = rotate_deg<Linear>(extrapolation(blocked_in), 30);
+  BOOST_TEST(blocked_out == out);
+  const auto rotation = Affinity<2>::rotation_deg(30, 0, 1, center(in));
+  BlockedRaster<float> tiled_out(in.shape());
+  rotation.transform(interpolation<Linear>(extrapolation(blocked_in)), tiled_out);
+  BOOST_TEST(rasterize(tiled_out) == out);
+}
+
 BOOST_AUTO_TEST_CASE(raster_upsampling_sesquiple_test)
 {
   const auto in = Raster<float>({3, 2}).range();
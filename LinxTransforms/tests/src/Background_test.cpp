@@ -0,0 +1,87 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Data/Mask.h"
+#include "Linx/Transforms/Background.h"
+
+#include <boost/test/unit_test.hpp>
+#include <limits>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Background_test)
+
+//-----------------------------------------------------------------------------
+
+double surface(double x, double y)
+{
+  return 10 + .5 * x - .2 * y + .01 * x * y - .003 * x * x + .0001 * y * y * y;
+}
+
+BOOST_AUTO_TEST_CASE(exact_fit_test)
+{
+  Raster<float> in({64, 48});
+  for (const auto& p : in.domain()) {
+    in[p] = surface(p[0], p[1]);
+  }
+  PolynomialBackground background(3);
+  BOOST_TEST(background.term_count() == 10);
+  background.fit(in);
+  BOOST_TEST(background.shape() == in.shape());
+  const auto out = background.raster();
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(out[p] == surface(p[0], p[1]), boost::test_tools::tolerance(1e-5));
+  }
+  BOOST_TEST(background(10.5, 20.5) == surface(10.5, 20.5), boost::test_tools::tolerance(1e-6));
+}
+
+BOOST_AUTO_TEST_CASE(masked_fit_test)
+{
+  Raster<double> in({40, 30});
+  Raster<bool> valid(in.shape());
+  for (const auto& p : in.domain()) {
+    in[p] = surface(p[0], p[1]);
+    valid[p] = true;
+  }
+  for (const auto& p : Box<2>({10, 10}, {15, 15})) {
+    in[p] = 1000; // Source
+    valid[p] = false;
+  }
+  in[{0, 0}] = std::numeric_limits<double>::quiet_NaN();
+  PolynomialBackground background(3);
+  background.fit(in, valid);
+  const auto out = background.raster();
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(out[p] == surface(p[0], p[1]), boost::test_tools::tolerance(1e-8));
+  }
+
+  Mask<2> mask(in.domain());
+  for (const auto& p : Box<2>({10, 10}, {15, 15})) {
+    mask[p] = false;
+  }
+  PolynomialBackground masked(3);
+  masked.fit(in, mask);
+  for (Index j = 0; j <= 3; ++j) {
+    for (Index i = 0; i + j <= 3; ++i) {
+      BOOST_TEST(masked.coefficient(i, j) == background.coefficient(i, j), boost::test_tools::tolerance(1e-9));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(least_squares_test)
+{
+  Raster<double> in({20, 20});
+  for (const auto& p : in.domain()) {
+    in[p] = 5 + ((p[0] + p[1]) % 2 ? 1 : -1); // Zero-mean checkerboard on a plateau
+  }
+  PolynomialBackground background(0);
+  background.fit(in);
+  BOOST_TEST(background.coefficient(0, 0) == 5, boost::test_tools::tolerance(1e-12));
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
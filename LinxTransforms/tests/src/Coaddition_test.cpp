@@ -0,0 +1,118 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Transforms/Coaddition.h"
+#include "Linx/Transforms/Extrapolation.h"
+#include "Linx/Transforms/Interpolation.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Coaddition_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(footprint_test)
+{
+  Coaddition<float> mosaic({100, 50}, {16, 16});
+  BOOST_TEST(mosaic.tile_shape() == Position<2>({16, 16}));
+  const Box<2> frame({0, 0}, {9, 4});
+  const auto translated = mosaic.footprint(frame, Affinity<2>::translation(Vector<double, 2>({20, 30})));
+  BOOST_TEST(translated == Box<2>({20, 30}, {29, 34}));
+  const auto clipped = mosaic.footprint(frame, Affinity<2>::translation(Vector<double, 2>({95, -2})));
+  BOOST_TEST(clipped == Box<2>({95, 0}, {99, 2}));
+}
+
+BOOST_AUTO_TEST_CASE(patch_test)
+{
+  Coaddition<double> mosaic({10, 8}, {4, 4});
+  Raster<double> a({6, 5});
+  a.fill(1);
+  Raster<double> b({6, 5});
+  b.fill(4);
+  Raster<double> w({6, 5});
+  w.fill(2);
+  w[{0, 0}] = 0;
+  mosaic.add(a, Box<2>::from_shape({-2, -1}, a.shape()));
+  mosaic.add(b, w, Box<2>::from_shape({0, 0}, b.shape()));
+  const auto out = mosaic.image(-1);
+  BOOST_TEST((out[{0, 0}] == 1)); // Null weight
+  BOOST_TEST((out[{1, 1}] == 3)); // (1 + 2 * 4) / 3
+  BOOST_TEST((out[{4, 2}] == 4));
+  BOOST_TEST((out[{9, 7}] == -1));
+  BOOST_TEST((mosaic.weights()[{1, 1}] == 3));
+}
+
+BOOST_AUTO_TEST_CASE(warp_test)
+{
+  Raster<float> frame({12, 10});
+  frame.range();
+  Coaddition<float> mosaic({40, 30}, {8, 8});
+  const auto transform = Affinity<2>::translation(Vector<double, 2>({15, 7}));
+  mosaic.add(interpolation<Nearest>(frame), transform);
+  mosaic.add(interpolation<Nearest>(frame), transform, 3);
+  const auto out = mosaic.image(-1);
+  for (const auto& p : frame.domain()) {
+    BOOST_TEST(out[p + Position<2>({15, 7})] == frame[p]);
+  }
+  BOOST_TEST((out[{14, 7}] == -1));
+  BOOST_TEST((mosaic.weights()[{15, 7}] == 4));
+  BOOST_TEST((mosaic.weights()[{26, 16}] == 4));
+  BOOST_TEST((mosaic.weights()[{27, 16}] == 0));
+}
+
+BOOST_AUTO_TEST_CASE(linear_nan_border_test)
+{
+  Raster<double> frame({8, 8});
+  frame.fill(2);
+  Coaddition<double> mosaic({20, 20});
+  const auto transform = Affinity<2>::translation(Vector<double, 2>({5.5, 5.5}));
+  const auto nan = std::numeric_limits<double>::quiet_NaN();
+  mosaic.add(interpolation<Linear>(extrapolation(frame, nan)), transform);
+  const auto out = mosaic.image();
+  BOOST_TEST((out[{6, 6}] == 2));
+  BOOST_TEST((out[{12, 12}] == 2));
+  BOOST_TEST((mosaic.weights()[{5, 5}] == 0)); // Incomplete neighborhood
+  BOOST_TEST((mosaic.weights()[{13, 13}] == 0));
+}
+
+BOOST_AUTO_TEST_CASE(external_accumulators_test)
+{
+  std::vector<double> sums(12, 0);
+  std::vector<double> weights(12, 0);
+  Coaddition<double, 2, PtrHolder<double>> mosaic(
+      PtrRaster<double>({4, 3}, sums.data()),
+      PtrRaster<double>({4, 3}, weights.data()),
+      {2, 2});
+  Raster<double> in({2, 2});
+  in.fill(5);
+  mosaic.add(in, Box<2>::from_shape({1, 1}, in.shape()));
+  BOOST_TEST(sums[5] == 5);
+  BOOST_TEST(weights[5] == 1);
+  BOOST_TEST(weights[0] == 0);
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_add_test)
+{
+  Raster<double> frame({30, 30});
+  frame.fill(1);
+  Coaddition<double> mosaic({64, 64}, {16, 16});
+#pragma omp parallel for
+  for (Index i = 0; i < 16; ++i) {
+    const auto transform = Affinity<2>::translation(Vector<double, 2>({double(i * 2), double(i)}));
+    mosaic.add(interpolation<Nearest>(frame), transform);
+  }
+  double total = 0;
+  for (const auto& w : mosaic.weights()) {
+    total += w;
+  }
+  BOOST_TEST(total == 16 * 900);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
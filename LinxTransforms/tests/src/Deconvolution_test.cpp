@@ -0,0 +1,119 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "LinxTransforms/Deconvolution.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Deconvolution_test)
+
+//-----------------------------------------------------------------------------
+
+/**
+ * @brief Make a 5x5 Gaussian-like PSF.
+ */
+Raster<double> make_psf()
+{
+  Raster<double> psf({5, 5});
+  psf.generate([i = 0]() mutable {
+    const auto x = i % 5 - 2;
+    const auto y = i / 5 - 2;
+    ++i;
+    return std::exp(-.5 * (x * x + y * y));
+  });
+  return psf;
+}
+
+/**
+ * @brief Make a scene with two point sources on a flat background.
+ */
+Raster<double> make_scene()
+{
+  Raster<double> scene({32, 24});
+  scene.fill(1);
+  scene[{8, 8}] = 100;
+  scene[{20, 15}] = 50;
+  return scene;
+}
+
+/**
+ * @brief Blur circularly with the engine's spectrum, i.e. apply the forward model directly.
+ */
+Raster<double> blur(const Raster<double>& in, const Raster<double>& psf)
+{
+  Raster<double> out(in.shape());
+  out.fill(0);
+  double sum = 0;
+  for (const auto& e : psf) {
+    sum += e;
+  }
+  for (const auto& p : in.domain()) {
+    for (const auto& q : psf.domain()) {
+      Position<2> r {(p[0] + q[0] - 2 + 32) % 32, (p[1] + q[1] - 2 + 24) % 24};
+      out[r] += in[p] * psf[q] / sum;
+    }
+  }
+  return out;
+}
+
+double error(const Raster<double>& a, const Raster<double>& b)
+{
+  double out = 0;
+  for (const auto& p : a.domain()) {
+    out += (a[p] - b[p]) * (a[p] - b[p]);
+  }
+  return std::sqrt(out);
+}
+
+BOOST_AUTO_TEST_CASE(spectrum_test)
+{
+  const auto psf = make_psf();
+  Deconvolution<2> deconvolution(psf, Position<2>({32, 24}));
+  BOOST_TEST(deconvolution.spectrum().shape() == Position<2>({17, 24}));
+  BOOST_TEST(std::abs(deconvolution.spectrum()[0] - 1. / (32 * 24)) < 1e-12); // Normalized PSF
+}
+
+BOOST_AUTO_TEST_CASE(richardson_lucy_test)
+{
+  const auto psf = make_psf();
+  const auto scene = make_scene();
+  const auto blurred = blur(scene, psf);
+  Deconvolution<2> deconvolution(psf, blurred);
+  deconvolution.richardson_lucy(20);
+  const auto plain = error(deconvolution.estimate(), scene);
+  BOOST_TEST(plain < error(blurred, scene) * .7);
+
+  // Flux and positivity are preserved
+  double flux = 0;
+  double min = 1;
+  for (const auto& e : deconvolution.estimate()) {
+    flux += e;
+    min = std::min(min, e);
+  }
+  BOOST_TEST(flux == 32 * 24 - 2 + 150, boost::test_tools::tolerance(1e-6));
+  BOOST_TEST(min >= 0);
+
+  // Acceleration converges faster
+  deconvolution.reset(blurred);
+  deconvolution.richardson_lucy(20, true);
+  BOOST_TEST(error(deconvolution.estimate(), scene) < plain * .8);
+}
+
+BOOST_AUTO_TEST_CASE(landweber_test)
+{
+  const auto psf = make_psf();
+  const auto scene = make_scene();
+  const auto blurred = blur(scene, psf);
+  Deconvolution<2> deconvolution(psf, blurred);
+  deconvolution.landweber(50, 1.5);
+  BOOST_TEST(error(deconvolution.estimate(), scene) < error(blurred, scene) * .9);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,125 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Transforms/Drizzle.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Drizzle_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(polygon_overlap_test)
+{
+  Internal::DropPolygon square;
+  square.push(0, 0);
+  square.push(2, 0);
+  square.push(2, 2);
+  square.push(0, 2);
+  BOOST_TEST(square.area() == 4);
+  BOOST_TEST(square.overlap(0, 0) == 1);
+  BOOST_TEST(square.overlap(1.5, .5) == .5);
+  BOOST_TEST(square.overlap(3, 0) == 0);
+  Internal::DropPolygon diamond;
+  diamond.push(1, 0);
+  diamond.push(2, 1);
+  diamond.push(1, 2);
+  diamond.push(0, 1);
+  BOOST_TEST(diamond.area() == 2);
+  BOOST_TEST(diamond.overlap(0, 0) == .5);
+}
+
+BOOST_AUTO_TEST_CASE(identity_test)
+{
+  Raster<float> in({8, 6});
+  in.range();
+  Drizzle<float> drizzle(in.shape());
+  drizzle.add(in, Affinity<2>());
+  const auto out = drizzle.image();
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(out[p] == in[p], boost::test_tools::tolerance(1e-5f));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(half_pixel_shift_test)
+{
+  Raster<double> in({8, 1});
+  in.range();
+  Drizzle<double> drizzle({9, 1});
+  drizzle.add(in, Affinity<2>::translation(Vector<double, 2>({.5, 0})));
+  const auto out = drizzle.image();
+  BOOST_TEST(out[0] == 0);
+  for (Index i = 1; i < 8; ++i) {
+    BOOST_TEST(out[i] == i - .5, boost::test_tools::tolerance(1e-12)); // Mean of both overlapping drops
+  }
+}
+
+BOOST_AUTO_TEST_CASE(flux_conservation_test)
+{
+  Raster<double> in({10, 10});
+  in.generate([i = 0]() mutable {
+    return (i++ * 7919) % 23;
+  });
+  double flux = 0;
+  for (const auto& e : in) {
+    flux += e;
+  }
+  auto transform = Affinity<2>::scaling(2.);
+  transform.rotate_deg(30);
+  transform += Vector<double, 2>({25, 10});
+  Drizzle<double> drizzle({60, 60});
+  drizzle.add(in, transform);
+  const auto weights = drizzle.weights();
+  const auto out = drizzle.image();
+  double out_flux = 0;
+  for (const auto& p : out.domain()) {
+    out_flux += out[p] * weights[p] * 4; // Coverage, i.e. weight times drop area (in output pixels)
+  }
+  BOOST_TEST(out_flux == flux, boost::test_tools::tolerance(1e-9));
+}
+
+BOOST_AUTO_TEST_CASE(multiple_tiles_test)
+{
+  Raster<double> in({300, 300});
+  in.generate([i = 0]() mutable {
+    return (i++ * 7919) % 23;
+  });
+  double flux = 0;
+  for (const auto& e : in) {
+    flux += e;
+  }
+  auto transform = Affinity<2>::rotation_deg(45);
+  transform += Vector<double, 2>({300, 80});
+  Drizzle<double> drizzle({600, 600}, .7); // 3x3 tiles
+  drizzle.add(in, transform);
+  const auto weights = drizzle.weights();
+  const auto out = drizzle.image();
+  double out_flux = 0;
+  for (const auto& p : out.domain()) {
+    out_flux += out[p] * weights[p];
+  }
+  BOOST_TEST(out_flux == flux, boost::test_tools::tolerance(1e-9));
+}
+
+BOOST_AUTO_TEST_CASE(weights_and_nan_test)
+{
+  Raster<double> in({4, 1}, {1, std::numeric_limits<double>::quiet_NaN(), 3, 4});
+  Raster<double> w({4, 1}, {1, 1, 0, 2});
+  Drizzle<double> drizzle({4, 1});
+  drizzle.add(in, Affinity<2>(), w);
+  drizzle.add(Raster<double>({4, 1}, {2, 2, 2, 2}), Affinity<2>());
+  const auto out = drizzle.image();
+  BOOST_TEST(out[0] == 1.5);
+  BOOST_TEST(out[1] == 2);
+  BOOST_TEST(out[2] == 2);
+  BOOST_TEST(out[3] == (4. * 2 + 2) / 3);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,166 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Transforms/EdgePreserving.h"
+#include "Linx/Transforms/Filters.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+Raster<double> step_edge()
+{
+  Raster<double> out({16, 8});
+  out.generate([i = 0]() mutable {
+    const auto x = i % 16;
+    const auto noise = ((i++ * 7919) % 11 - 5) * .01;
+    return (x < 8 ? 0. : 10.) + noise;
+  });
+  return out;
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(EdgePreserving_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(guided_constant_test)
+{
+  Raster<double> in({9, 7});
+  in.fill(3);
+  const auto out = guided_filter(in, Box<2>::from_center(2), .1);
+  for (const auto& e : out) {
+    BOOST_TEST(e == 3, boost::test_tools::tolerance(1e-12));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(guided_brute_force_test)
+{
+  const auto in = step_edge();
+  Raster<double> guide(in.shape());
+  guide.generate([i = 0]() mutable {
+    return (i++ * 31) % 17;
+  });
+  const auto window = Box<2>::from_center(2);
+  const double epsilon = .5;
+  const auto out = guided_filter(in, guide, window, epsilon);
+
+  // Naive implementation with explicit window loops
+  Raster<double> a(in.shape());
+  Raster<double> b(in.shape());
+  for (const auto& p : in.domain()) {
+    double n = 0, si = 0, sp = 0, sii = 0, sip = 0;
+    for (const auto& q : (window + p) & in.domain()) {
+      ++n;
+      si += guide[q];
+      sp += in[q];
+      sii += guide[q] * guide[q];
+      sip += guide[q] * in[q];
+    }
+    const auto mi = si / n;
+    const auto mp = sp / n;
+    a[p] = (sip / n - mi * mp) / (sii / n - mi * mi + epsilon);
+    b[p] = mp - a[p] * mi;
+  }
+  for (const auto& p : in.domain()) {
+    double n = 0, sa = 0, sb = 0;
+    for (const auto& q : (window + p) & in.domain()) {
+      ++n;
+      sa += a[q];
+      sb += b[q];
+    }
+    BOOST_TEST(out[p] == sa / n * guide[p] + sb / n, boost::test_tools::tolerance(1e-9));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(guided_high_level_float_test)
+{
+  Raster<double> in({32, 24});
+  in.generate([i = 0]() mutable {
+    return 1e4 + ((i++ * 7919) % 31 - 15) * .1;
+  });
+  const Raster<float> in_float(in.shape(), in);
+  const auto window = Box<2>::from_center(3);
+  const auto out = guided_filter(in, window, 1.);
+  const auto out_float = guided_filter(in_float, window, 1.);
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(std::abs(out_float[p] - out[p]) < 1e-2);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(guided_preserves_edges_test)
+{
+  const auto in = step_edge();
+  const auto out = guided_filter(in, Box<2>::from_center(2), .01);
+  const auto blurred = mean_filter<double>(Box<2>::from_center(2)) * extrapolation<Nearest>(in);
+  const Position<2> before {7, 4};
+  const Position<2> after {8, 4};
+  BOOST_TEST(out[after] - out[before] > 9.);
+  BOOST_TEST(blurred[after] - blurred[before] < 5.);
+}
+
+BOOST_AUTO_TEST_CASE(guided_extrapolation_test)
+{
+  Raster<double> in({9, 7});
+  in.fill(3);
+  const auto out = guided_filter(extrapolation(in, 0.), Box<2>::from_center(1), .1);
+  BOOST_TEST(out.shape() == in.shape());
+  BOOST_TEST((out[{4, 3}]) == 3, boost::test_tools::tolerance(1e-9));
+  BOOST_TEST((out[{0, 0}]) < 3); // Zero-padding pulls the border down
+}
+
+BOOST_AUTO_TEST_CASE(bilateral_preserves_edges_test)
+{
+  const auto in = step_edge();
+  const auto out = bilateral_filter(in, 2., 1.);
+  const Position<2> before {7, 4};
+  const Position<2> after {8, 4};
+  BOOST_TEST(out[after] - out[before] > 9.9);
+  BOOST_TEST(out[before] == 0., boost::test_tools::tolerance(.05));
+}
+
+BOOST_AUTO_TEST_CASE(bilateral_large_range_is_gaussian_test)
+{
+  Raster<double> in({21, 1});
+  in.fill(0);
+  in[10] = 1;
+  const auto out = bilateral_filter(in, 1.5, 1e6, 4);
+  double norm = 0;
+  for (Index k = -4; k <= 4; ++k) {
+    norm += std::exp(-.5 * k * k / 2.25);
+  }
+  for (Index i = 6; i <= 14; ++i) {
+    const auto k = i - 10;
+    BOOST_TEST(out[i] == std::exp(-.5 * k * k / 2.25) / norm, boost::test_tools::tolerance(1e-6));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(bilateral_degenerate_sigmas_test)
+{
+  const auto in = step_edge();
+  const auto null_range = bilateral_filter(in, 1., 0.);
+  const auto null_spatial = bilateral_filter(extrapolation<Nearest>(in), 0., 10.);
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(null_range[p] == in[p]);
+    BOOST_TEST(null_spatial[p] == in[p]);
+  }
+  BOOST_CHECK_THROW(bilateral_filter(in, -1., 1.), OutOfBoundsError);
+  BOOST_CHECK_THROW(bilateral_filter(extrapolation<Nearest>(in), 1., -1.), OutOfBoundsError);
+}
+
+BOOST_AUTO_TEST_CASE(bilateral_extrapolation_test)
+{
+  Raster<double> in({9, 7});
+  in.fill(3);
+  const auto out = bilateral_filter(extrapolation<Nearest>(in), 1., 1.);
+  BOOST_TEST(out.shape() == in.shape());
+  for (const auto& e : out) {
+    BOOST_TEST(e == 3, boost::test_tools::tolerance(1e-12));
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -27,6 +27,35 @@ BOOST_AUTO_TEST_CASE(laplacian_minus_test)
   BOOST_TEST((laplace_operator<int, 0, 1>(-1).impulse()) == expected);
 }
 
+BOOST_AUTO_TEST_CASE(workspace_test)
+{
+  const auto laplace = laplace_operator<int, 0, 1>();
+  const auto raster = Raster<int>({5, 4}).range();
+  std::decay_t<decltype(laplace)>::Workspace<> workspace;
+  Raster<int> out;
+  laplace.apply(extrapolation(raster, 0), out, workspace);
+  BOOST_TEST(out == laplace * extrapolation(raster, 0));
+  const auto* data = out.data();
+  laplace.apply(extrapolation(raster, 0), out, workspace);
+  BOOST_TEST(out.data() == data);
+}
+
+BOOST_AUTO_TEST_CASE(lower_dimension_filter_test)
+{
+  const auto laplace = laplace_operator<int, 0, 1>();
+  const auto raster = Raster<int, 3>({5, 4, 3}).range();
+  const auto out = laplace * extrapolation(raster, 0);
+  BOOST_TEST(out.shape() == raster.shape());
+  for (Index z = 0; z < 3; ++z) {
+    Raster<int> plane({5, 4});
+    std::copy_n(raster.data() + z * plane.size(), plane.size(), plane.data());
+    const auto expected = laplace * extrapolation(plane, 0);
+    for (const auto& p : plane.domain()) {
+      BOOST_TEST((out[{p[0], p[1], z}] == expected[p]));
+    }
+  }
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
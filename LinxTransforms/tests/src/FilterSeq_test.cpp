@@ -98,6 +98,45 @@ BOOST_AUTO_TEST_CASE(orthogonal_associativity_commutativity_test)
   BOOST_TEST(commutated == direct);
 }
 
+BOOST_AUTO_TEST_CASE(workspace_test)
+{
+  const auto seq = correlation_along<int, 0>({1, 0, -1}) * correlation_along<int, 1>({1, 2, 3});
+  const auto raster = Raster<int>({6, 5}).range();
+  decltype(seq)::Workspace<> workspace;
+  Raster<int> out;
+  seq.apply(extrapolation(raster, 0), out, workspace);
+  BOOST_TEST(out == seq * extrapolation(raster, 0));
+  const auto* data = out.data();
+  const auto* intermediate = std::get<0>(workspace).data();
+  BOOST_TEST(intermediate != nullptr);
+  seq.apply(extrapolation(raster, 1), out, workspace);
+  BOOST_TEST(out == seq * extrapolation(raster, 1));
+  BOOST_TEST(out.data() == data);
+  BOOST_TEST(std::get<0>(workspace).data() == intermediate);
+  seq.apply(raster, out, workspace);
+  BOOST_TEST(out == seq * raster);
+}
+
+BOOST_AUTO_TEST_CASE(lower_dimension_filter_test)
+{
+  const auto seq = correlation_along<int, 0>({1, 0, -1}) * correlation_along<int, 1>({1, 2, 3});
+  const auto raster = Raster<int, 3>({6, 5, 3}).range();
+  const auto out = seq * extrapolation(raster, 0);
+  BOOST_TEST(out.shape() == raster.shape());
+  for (Index z = 0; z < 3; ++z) {
+    Raster<int> plane({6, 5});
+    std::copy_n(raster.data() + z * plane.size(), plane.size(), plane.data());
+    const auto expected = seq * extrapolation(plane, 0);
+    for (const auto& p : plane.domain()) {
+      BOOST_TEST((out[{p[0], p[1], z}] == expected[p]));
+    }
+  }
+  decltype(seq)::Workspace<3> workspace;
+  Raster<int, 3> reused;
+  seq.apply(extrapolation(raster, 0), reused, workspace);
+  BOOST_TEST(reused == out);
+}
+
 // BOOST_AUTO_TEST_CASE(sum3x3_dirichlet_test)
 // {
 //   const SeparableKernel<int, 0, 1, 2> kernel({1, 1, 1});
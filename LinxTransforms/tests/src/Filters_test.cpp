@@ -41,6 +41,22 @@ BOOST_AUTO_TEST_CASE(crop_test)
   }
 }
 
+BOOST_AUTO_TEST_CASE(reused_output_test)
+{
+  const auto in = Raster<int>({10, 8}).range();
+  const auto k = convolution(Raster<int>({3, 3}).fill(1));
+  Raster<int> out;
+  k.apply(extrapolation(in, 0), out);
+  const auto* data = out.data();
+  BOOST_TEST(out == k * extrapolation(in, 0));
+  k.apply(extrapolation(in, 1), out);
+  BOOST_TEST(out.data() == data); // Not reallocated
+  BOOST_TEST(out == k * extrapolation(in, 1));
+  k.apply(in, out);
+  BOOST_TEST(out.shape() == k.output_shape(in)); // Reallocated
+  BOOST_TEST(out == k * in);
+}
+
 BOOST_AUTO_TEST_CASE(inner_box_test)
 {
   const auto in = Raster<int, 3>({5, 6, 7}).range();
@@ -120,6 +136,65 @@ BOOST_AUTO_TEST_CASE(extrapolated_decimate_3d_test)
   }
 }
 
+BOOST_AUTO_TEST_CASE(normalized_convolution_test)
+{
+  const auto nan = std::numeric_limits<double>::quiet_NaN();
+  const Raster<double> values({3, 3}, {0, 1, 0, 1, 2, 1, 0, 1, 0});
+  const auto k = normalized_convolution(values);
+  const auto valid = Raster<double>({4, 3}).range();
+  BOOST_TEST((k * extrapolation<Nearest>(valid)) == (convolution(values) * extrapolation<Nearest>(valid)));
+
+  Raster<double> in({4, 3}, {1, 2, 3, 4, 5, nan, 7, 8, nan, nan, nan, nan});
+  const auto out = k * extrapolation<Nearest>(in);
+  BOOST_TEST((out[{1, 0}]) == (2. + 1. + 2. * 2. + 3.) * 6. / 5.); // Bottom neighbor is invalid
+  BOOST_TEST((std::isnan(out[{1, 2}]))); // No valid neighbors
+}
+
+BOOST_AUTO_TEST_CASE(zero_sum_normalized_convolution_test)
+{
+  const auto nan = std::numeric_limits<double>::quiet_NaN();
+  const Raster<double, 1> values({3}, {-1, 0, 1});
+  const auto k = normalized_convolution(values);
+  const auto valid = Raster<double, 1>({5}).range();
+  BOOST_TEST((k * extrapolation<Nearest>(valid)) == (convolution(values) * extrapolation<Nearest>(valid)));
+
+  const Raster<double, 1> in({5}, {1, nan, 4, nan, nan});
+  const auto out = k * extrapolation<Nearest>(in);
+  BOOST_TEST(out[0] == 1.); // Not renormalized
+  BOOST_TEST(out[1] == -3.);
+  BOOST_TEST(out[3] == 4.);
+  BOOST_TEST(std::isnan(out[4])); // No valid neighbors
+}
+
+BOOST_AUTO_TEST_CASE(nan_mean_median_test)
+{
+  const auto nan = std::numeric_limits<float>::quiet_NaN();
+  Raster<float> in({5, 1}, {1, nan, 4, 2, nan});
+  const Box<2> window({-1, 0}, {1, 0});
+  const auto mean = nan_mean_filter<float>(window) * extrapolation(in, nan);
+  const auto median = nan_median_filter<float>(window) * extrapolation(in, nan);
+  const std::vector<float> expected_mean {1, 2.5, 3, 3, 2};
+  const std::vector<float> expected_median {1, 2.5, 3, 3, 2};
+  for (Index i = 0; i < 5; ++i) {
+    BOOST_TEST(mean[i] == expected_mean[i]);
+    BOOST_TEST(median[i] == expected_median[i]);
+  }
+  Raster<float> all_nan({3, 1}, {nan, nan, nan});
+  BOOST_TEST((std::isnan((nan_mean_filter<float>(window) * extrapolation(all_nan, nan))[1])));
+}
+
+BOOST_AUTO_TEST_CASE(invalidate_test)
+{
+  Raster<float> in({3, 1}, {1, 2, 3});
+  Raster<char> valid({3, 1}, {1, 0, 1});
+  const auto out = invalidate(in, valid);
+  BOOST_TEST(out[0] == 1);
+  BOOST_TEST(std::isnan(out[1]));
+  BOOST_TEST(out[2] == 3);
+  const auto mean = nan_mean_filter<float>(Box<2>({-1, 0}, {1, 0})) * extrapolation<Nearest>(out);
+  BOOST_TEST(mean[1] == 2);
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -48,6 +48,34 @@ BOOST_AUTO_TEST_CASE(periodic_test)
   BOOST_TEST(extra[positive] == (raster[{0, 1, 0}]));
 }
 
+BOOST_AUTO_TEST_CASE(reflect_test)
+{
+  Raster<int, 1> raster({3}, {1, 2, 3});
+  const auto extra = extrapolation<Reflect>(raster);
+  const std::vector<int> expected {1, 2, 3, 3, 2, 1, 1, 2, 3, 3, 2, 1, 1};
+  for (Index i = -6; i <= 6; ++i) {
+    BOOST_TEST(extra[Position<1> {i}] == expected[i + 6]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(extrapolated_copy_test)
+{
+  Raster<int, 3> raster({4, 3, 2});
+  raster.range(1);
+  const auto extra = extrapolation<Nearest>(raster);
+  for (const auto& box : {
+           Box<3>({-2, -1, -1}, {5, 3, 2}),
+           Box<3>({1, 1, 0}, {2, 1, 1}),
+           Box<3>({2, -3, 0}, {6, 1, 0}),
+           Box<3>({-5, -5, -5}, {-3, -2, -1})}) {
+    const auto out = extra.copy(box);
+    BOOST_TEST(out.shape() == box.shape());
+    for (const auto& p : box) {
+      BOOST_TEST(out[p - box.front()] == extra[p]);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE(linear_test)
 {
   Raster<int, 3> raster({2, 2, 2});
@@ -0,0 +1,81 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Transforms/Filters.h"
+#include "Linx/Transforms/LazyFiltered.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(LazyFiltered_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(convolution_test)
+{
+  const auto source = lazy_raster(Position<2> {12, 20}, [](const auto& p) {
+    return double((p[0] * 7 + p[1] * 13) % 11);
+  });
+  const auto in = source.raster();
+  Raster<double> values({3, 4});
+  values.range();
+  const auto k = convolution(values, {1, 2}); // Asymmetric window
+  const auto expected = k * extrapolation<Nearest>(in);
+
+  const auto filtered = lazy_filter(k, source);
+  BOOST_TEST(filtered.raster() == expected);
+  for (Index front = 0; front < 20; front += 3) {
+    const auto back = std::min<Index>(front + 2, 19);
+    const auto chunk = filtered.chunk(front, back);
+    for (const auto& p : chunk.domain()) {
+      BOOST_TEST((chunk[p] == expected[{p[0], p[1] + front}]));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(chained_constant_test)
+{
+  const auto source = lazy_raster(Position<3> {5, 4, 9}, [](const auto& p) {
+    return float(p[0] + p[1] * p[2]);
+  });
+  const auto in = source.raster();
+  const auto mean = mean_filter<float>(Box<3>::from_center(1));
+  const auto expected = mean * extrapolation(Raster<float, 3>(mean * extrapolation(in, 1.F)), 1.F);
+
+  const auto once = lazy_filter<Constant<float>>(mean, source, 1.F);
+  const auto twice = lazy_filter<Constant<float>>(mean, once, 1.F);
+  Raster<float, 3> out({5, 4, 2});
+  for (Index front = 0; front < 9; front += 2) {
+    if (front == 8) {
+      out = Raster<float, 3>({5, 4, 1});
+    }
+    twice.generate(out, front);
+    for (const auto& p : out.domain()) {
+      BOOST_TEST((out[p] == expected[{p[0], p[1], p[2] + front}]), boost::test_tools::tolerance(1e-5F));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(chained_temporary_test)
+{
+  const auto source = lazy_raster(Position<2> {6, 7}, [](const auto& p) {
+    return double(p[0] * p[1] % 5);
+  });
+  const auto in = source.raster();
+  const auto mean = mean_filter<double>(Box<2>::from_center(1));
+  const auto expected = mean * extrapolation<Nearest>(Raster<double>(mean * extrapolation<Nearest>(in)));
+
+  const auto twice = lazy_filter(mean, lazy_filter(mean, source)); // Inner filter is owned
+  const auto out = twice.raster();
+  for (const auto& p : out.domain()) {
+    BOOST_TEST(out[p] == expected[p], boost::test_tools::tolerance(1e-12));
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
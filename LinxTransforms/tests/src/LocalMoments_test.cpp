@@ -0,0 +1,89 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Base/DataDistribution.h"
+#include "Linx/Transforms/LocalMoments.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+template <typename T>
+std::vector<T> window_values(const Raster<T>& in, const Box<2>& window, const Position<2>& p)
+{
+  std::vector<T> out;
+  for (const auto& q : (window + p) & in.domain()) {
+    if (not std::isnan(in[q])) {
+      out.push_back(in[q]);
+    }
+  }
+  return out;
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(LocalMoments_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(constant_test)
+{
+  Raster<float> in({8, 6});
+  in.fill(3);
+  const auto moments = local_moments(in, Box<2>::from_center(2));
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(moments.mean()[p] == 3);
+    BOOST_TEST(moments.variance()[p] == 0);
+  }
+  BOOST_TEST((moments.count()[{0, 0}]) == 9);
+  BOOST_TEST((moments.count()[{4, 3}]) == 25);
+}
+
+BOOST_AUTO_TEST_CASE(brute_force_test)
+{
+  Raster<double> in({19, 13});
+  in.generate([i = 0]() mutable {
+    return 1000 + (i++ * 7919) % 101;
+  });
+  in[{3, 4}] = in[{10, 10}] = in[{11, 10}] = std::numeric_limits<double>::quiet_NaN();
+  const Box<2> window({-3, -1}, {2, 4}); // Asymmetric
+  const auto moments = local_moments(in, window);
+  const auto count = moments.count();
+  const auto mean = moments.mean();
+  const auto variance = moments.variance();
+  const auto biased = moments.variance(false);
+  const auto skewness = moments.skewness();
+  for (const auto& p : in.domain()) {
+    auto values = window_values(in, window, p);
+    DataDistribution<double> distribution(values);
+    BOOST_TEST(count[p] == values.size());
+    BOOST_TEST(mean[p] == distribution.mean(), boost::test_tools::tolerance(1e-9));
+    BOOST_TEST(variance[p] == distribution.variance(), boost::test_tools::tolerance(1e-9));
+    BOOST_TEST(biased[p] == distribution.variance(false), boost::test_tools::tolerance(1e-9));
+    double mu3 = 0;
+    for (auto v : values) {
+      mu3 += std::pow(v - distribution.mean(), 3);
+    }
+    mu3 /= values.size();
+    const auto expected_skewness = mu3 / std::pow(distribution.variance(false), 1.5);
+    BOOST_TEST(skewness[p] == expected_skewness, boost::test_tools::tolerance(1e-6));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(invalid_test)
+{
+  const auto nan = std::numeric_limits<float>::quiet_NaN();
+  Raster<float> in({3, 1}, {nan, 1, nan});
+  const auto moments = local_moments(in, Box<2>({0, 0}, {0, 0}));
+  const auto mean = moments.mean();
+  const auto variance = moments.variance();
+  BOOST_TEST((std::isnan(mean[{0, 0}])));
+  BOOST_TEST((mean[{1, 0}]) == 1);
+  BOOST_TEST((std::isnan(variance[{1, 0}]))); // Unbiased variance of a single value
+  BOOST_TEST((moments.variance(false)[{1, 0}]) == 0);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,259 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Transforms/Extrapolation.h"
+#include "Linx/Transforms/Filters.h"
+#include "Linx/Transforms/Morphology.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+template <typename T, typename TSe>
+Raster<T> brute_erode(const Raster<T>& in, const TSe& se)
+{
+  return minimum_filter<T>(se.mask()) * extrapolation<Nearest>(in);
+}
+
+template <typename T, typename TSe>
+Raster<T> brute_dilate(const Raster<T>& in, const TSe& se)
+{
+  return maximum_filter<T>(se.reflected().mask()) * extrapolation<Nearest>(in);
+}
+
+template <typename T>
+Raster<T> brute_reconstruct_by_dilation(Raster<T> marker, const Raster<T>& limit, const Mask<2>& neighbors)
+{
+  while (true) {
+    Raster<T> next = maximum_filter<T>(neighbors) * extrapolation<Nearest>(marker);
+    next.generate(
+        [](auto n, auto l) {
+          return std::min(n, l);
+        },
+        next,
+        limit);
+    if (next == marker) {
+      return marker;
+    }
+    marker = next;
+  }
+}
+
+template <typename T>
+Raster<T> brute_reconstruct_by_erosion(Raster<T> marker, const Raster<T>& limit, const Mask<2>& neighbors)
+{
+  while (true) {
+    Raster<T> next = minimum_filter<T>(neighbors) * extrapolation<Nearest>(marker);
+    next.generate(
+        [](auto n, auto l) {
+          return std::max(n, l);
+        },
+        next,
+        limit);
+    if (next == marker) {
+      return marker;
+    }
+    marker = next;
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Morphology_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(box_decomposition_test)
+{
+  const Box<2> box({-1, -2}, {3, 2});
+  const auto se = SegmentDecomposition<2>::from_box(box);
+  BOOST_TEST(se.segments().size() == 2);
+  const auto mask = se.mask();
+  BOOST_TEST(mask.box() == box);
+  for (const auto& p : box) {
+    BOOST_TEST(mask[p]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(octagon_decomposition_test)
+{
+  const Index radius = 5;
+  const auto mask = SegmentDecomposition<2>::octagon(radius).mask();
+  BOOST_TEST(mask.box() == Box<2>({-radius, -radius}, {radius, radius}));
+  BOOST_TEST((mask[{radius, 0}]));
+  BOOST_TEST((mask[{0, -radius}]));
+  BOOST_TEST((not mask[{radius, radius}]));
+  const auto ball = Mask<2>::ball<2>(radius);
+  for (const auto& p : ball.box()) {
+    if (ball[p]) {
+      BOOST_TEST(mask[p]); // Octagon contains the disk
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(box_erode_dilate_test)
+{
+  Raster<int> in({17, 11});
+  in.generate([i = 0]() mutable {
+    return (i++ * 7919) % 101;
+  });
+  const Box<2> box({-2, -1}, {3, 4}); // Asymmetric
+  const auto se = SegmentDecomposition<2>::from_box(box);
+  BOOST_TEST(erode(in, box) == brute_erode(in, se));
+  BOOST_TEST(dilate(in, box) == brute_dilate(in, se));
+}
+
+BOOST_AUTO_TEST_CASE(off_origin_box_erode_dilate_test)
+{
+  Raster<int> line({6, 1});
+  line.range();
+  const Box<2> right({2, 0}, {3, 0});
+  const auto eroded_line = erode(line, right);
+  BOOST_TEST(eroded_line == (minimum_filter<int>(right) * extrapolation<Nearest>(line)));
+  BOOST_TEST(eroded_line == (Raster<int>({6, 1}, {2, 3, 4, 5, 5, 5})));
+
+  Raster<float> in({13, 9});
+  in.generate([i = 0]() mutable {
+    return (i++ * 7919) % 101;
+  });
+  for (const auto& box : {Box<2>({2, -5}, {4, -3}), Box<2>({-7, 1}, {-6, 12})}) {
+    BOOST_TEST(erode(in, box) == (minimum_filter<float>(box) * extrapolation<Nearest>(in)));
+    const auto se = SegmentDecomposition<2>::from_box(box);
+    BOOST_TEST(dilate(in, box) == brute_dilate(in, se));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(octagon_erode_dilate_test)
+{
+  Raster<float> in({23, 19});
+  in.generate([i = 0]() mutable {
+    return (i++ * 7919) % 101;
+  });
+  const Index radius = 4;
+  const auto se = SegmentDecomposition<2>::octagon(radius);
+  const auto eroded = erode(in, se);
+  const auto dilated = dilate(in, se);
+  const auto expected_eroded = brute_erode(in, se);
+  const auto expected_dilated = brute_dilate(in, se);
+  for (const auto& p : in.domain() - Box<2>({-radius, -radius}, {radius, radius})) { // Paths are clipped at the boundaries
+    BOOST_TEST(eroded[p] == expected_eroded[p]);
+    BOOST_TEST(dilated[p] == expected_dilated[p]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(opening_closing_test)
+{
+  Raster<int> in({16, 12});
+  in.generate([i = 0]() mutable {
+    return (i++ * 7919) % 101;
+  });
+  const auto se = SegmentDecomposition<2>::octagon(3);
+  const auto opened = opening(in, se);
+  const auto closed = closing(in, se);
+  BOOST_TEST(opened == dilate(erode(in, se), se));
+  BOOST_TEST(closed == erode(dilate(in, se), se));
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(opened[p] <= in[p]); // Anti-extensive
+    BOOST_TEST(closed[p] >= in[p]); // Extensive
+  }
+  BOOST_TEST(opening(opened, se) == opened); // Idempotent
+  BOOST_TEST(closing(closed, se) == closed);
+}
+
+BOOST_AUTO_TEST_CASE(tophat_test)
+{
+  Raster<int> in({15, 15});
+  in.fill(10);
+  in[{7, 7}] = 20; // Small bright peak
+  in[{3, 3}] = 0; // Small dark hole
+  const Box<2> box({-1, -1}, {1, 1});
+  const auto white = white_tophat(in, box);
+  const auto black = black_tophat(in, box);
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(white[p] == (p == Position<2>({7, 7}) ? 10 : 0));
+    BOOST_TEST(black[p] == (p == Position<2>({3, 3}) ? 10 : 0));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(gradient_test)
+{
+  Raster<int> in({9, 9});
+  in.fill(0);
+  for (const auto& p : Box<2>({4, 0}, {8, 8})) {
+    in[p] = 1;
+  }
+  const auto gradient = morphological_gradient(in, Box<2>({-1, -1}, {1, 1}));
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(gradient[p] == (p[0] == 3 || p[0] == 4 ? 1 : 0));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(reconstruction_test)
+{
+  Raster<int> limit({21, 17});
+  limit.generate([i = 0]() mutable {
+    return (i++ * 7919) % 101;
+  });
+  Raster<int> marker(limit.shape());
+  marker.generate(
+      [i = 0](auto l) mutable {
+        return (i++ % 13) ? 0 : l;
+      },
+      limit);
+  for (const auto& neighbors : {Mask<2>::ball<1>(1), Mask<2>::from_center(1)}) {
+    BOOST_TEST(reconstruct_by_dilation(marker, limit, neighbors) == brute_reconstruct_by_dilation(marker, limit, neighbors));
+    auto over = marker;
+    over.generate(
+        [](auto m, auto l) {
+          return m ? l : 100;
+        },
+        marker,
+        limit);
+    BOOST_TEST(reconstruct_by_erosion(over, limit, neighbors) == brute_reconstruct_by_erosion(over, limit, neighbors));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(binary_reconstruction_test)
+{
+  Raster<char> limit({6, 3}, {1, 1, 0, 0, 1, 1, 0, 0, 0, 0, 0, 1, 1, 0, 1, 1, 0, 0});
+  Raster<char> marker({6, 3}, {1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0});
+  Raster<char> expected({6, 3}, {1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0});
+  BOOST_TEST(reconstruct_by_dilation(marker, limit) == expected);
+  marker[{5, 1}] = 1;
+  expected[{4, 0}] = expected[{5, 0}] = expected[{5, 1}] = 1;
+  BOOST_TEST(reconstruct_by_dilation(marker, limit) == expected);
+}
+
+BOOST_AUTO_TEST_CASE(fill_holes_test)
+{
+  Raster<char> in({7, 5},
+                  {0, 0, 0, 0, 0, 0, 0, //
+                   0, 1, 1, 1, 0, 1, 0, //
+                   0, 1, 0, 1, 0, 1, 0, //
+                   0, 1, 1, 1, 0, 0, 0, //
+                   0, 0, 0, 0, 0, 0, 0});
+  auto expected = in;
+  expected[{2, 2}] = 1; // Enclosed hole is filled, open hole is not
+  BOOST_TEST(fill_holes(in) == expected);
+}
+
+BOOST_AUTO_TEST_CASE(regional_maxima_test)
+{
+  Raster<float> in({6, 3},
+                   {1, 2, 2, 1, 0, 3, //
+                    1, 2, 2, 1, 0, 0, //
+                    1, 1, 1, 2.5, 0, 0});
+  const auto maxima = regional_maxima(in);
+  Raster<bool> expected(in.shape());
+  expected.fill(false);
+  expected[{5, 0}] = expected[{3, 2}] = true;
+  expected[{1, 0}] = expected[{2, 0}] = expected[{1, 1}] = expected[{2, 1}] = true; // Plateau
+  BOOST_TEST(maxima == expected);
+  expected[{1, 0}] = expected[{2, 0}] = expected[{1, 1}] = expected[{2, 1}] = false; // Diagonal neighbor is higher
+  BOOST_TEST(regional_maxima(in, Mask<2>::from_center(1)) == expected);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,102 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Transforms/NonLocalMeans.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(NonLocalMeans_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(constant_test)
+{
+  Raster<float> in({12, 9});
+  in.fill(2);
+  const auto out = non_local_means(in, Box<2>::from_center(1), Box<2>::from_center(2), 1.);
+  for (const auto& e : out) {
+    BOOST_TEST(e == 2, boost::test_tools::tolerance(1e-6));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(brute_force_test)
+{
+  Raster<double> in({13, 11});
+  in.generate([i = 0]() mutable {
+    return (i++ * 7919) % 23;
+  });
+  const auto domain = in.domain();
+  const Box<2> patch({-1, -2}, {2, 1});
+  const auto search = Box<2>::from_center(2);
+  const double h = 5;
+  const double sigma = 1;
+  const auto out = non_local_means(in, patch, search, h, sigma);
+
+  for (const auto& p : domain) {
+    double num = 0;
+    double den = 0;
+    for (const auto& d : search) {
+      double distance = 0;
+      double count = 0;
+      for (const auto& q : (patch + p) & domain) {
+        const auto diff = in[q] - in[Internal::nearest(q + d, domain)];
+        distance += diff * diff;
+        ++count;
+      }
+      const auto w = std::exp(-std::max(distance / count - 2 * sigma * sigma, 0.) / (h * h));
+      num += w * in[Internal::nearest(p + d, domain)];
+      den += w;
+    }
+    BOOST_TEST(out[p] == num / den, boost::test_tools::tolerance(1e-9));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(long_float_lines_test)
+{
+  Raster<float> in({4096, 3});
+  in.generate([i = 0]() mutable {
+    const auto x = i % 4096;
+    const auto noise = .01f * (i++ * 7919 % 5);
+    return x < 2048 ? 1000 * (x % 23) : noise; // Large distances first, then small ones
+  });
+  const Raster<double> in_double(in.shape(), in.begin());
+  const Box<2> patch = Box<2>::from_center(1);
+  const Box<2> search = Box<2>::from_center(1);
+  const auto out = non_local_means(in, patch, search, .1);
+  const auto expected = non_local_means(in_double, patch, search, .1);
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(out[p] == expected[p], boost::test_tools::tolerance(1e-4));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(denoising_test)
+{
+  Raster<double> truth({32, 32});
+  truth.generate([i = 0]() mutable {
+    const auto x = i++ % 32;
+    return x < 16 ? 0. : 10.;
+  });
+  auto noisy = truth;
+  noisy.generate(
+      [i = 0](auto v) mutable {
+        return v + ((i++ * 7919) % 11 - 5) * .2;
+      },
+      truth);
+  const auto out = non_local_means(noisy, Box<2>::from_center(2), Box<2>::from_center(5), 1., 1.);
+  double noisy_error = 0;
+  double out_error = 0;
+  for (const auto& p : truth.domain()) {
+    noisy_error += std::abs(noisy[p] - truth[p]);
+    out_error += std::abs(out[p] - truth[p]);
+  }
+  BOOST_TEST(out_error < noisy_error / 2);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
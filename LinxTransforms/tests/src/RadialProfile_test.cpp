@@ -0,0 +1,87 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Transforms/RadialProfile.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(RadialProfile_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(bins_test)
+{
+  const RadialProfile<float> engine({5, 5});
+  BOOST_TEST(engine.bin_count() == 3); // Max radius is sqrt(8)
+  BOOST_TEST(engine.area(0) == 1);
+  BOOST_TEST(engine.area(1) == 8); // Radii 1 and sqrt(2)
+  BOOST_TEST(engine.area(2) == 16);
+  BOOST_TEST(engine.bins()[12] == 0);
+
+  const RadialProfile<float> truncated({5, 5}, 1., 2);
+  BOOST_TEST(truncated.bin_count() == 2);
+  BOOST_TEST(truncated.bins()[0] == -1);
+}
+
+BOOST_AUTO_TEST_CASE(statistics_test)
+{
+  Raster<float> frame({20, 12});
+  frame.range();
+  frame[{6, 4}] = std::numeric_limits<float>::quiet_NaN();
+  std::vector<Patch<float, Raster<float>, Box<2>>> stamps;
+  for (Index x = 0; x < 14; x += 3) {
+    stamps.push_back(frame(Box<2>::from_shape({x, 2}, {6, 7})));
+  }
+  const RadialProfile<float> engine({6, 7}, {2., 3.}, 1.5);
+  const auto bin_count = engine.bin_count();
+  const auto profiles = engine(stamps);
+  const auto means = profiles.mean();
+  BOOST_TEST(profiles.sum.shape() == (Position<2> {bin_count, 5}));
+
+  for (Index s = 0; s < 5; ++s) {
+    std::vector<std::vector<float>> rings(bin_count);
+    for (const auto& p : stamps[s].domain()) {
+      const auto v = frame[p];
+      const auto dx = p[0] - stamps[s].domain().front()[0] - 2.;
+      const auto dy = p[1] - stamps[s].domain().front()[1] - 3.;
+      const auto b = Index(std::sqrt(dx * dx + dy * dy) / 1.5);
+      if (v == v) {
+        rings[b].push_back(v);
+      }
+    }
+    for (Index b = 0; b < bin_count; ++b) {
+      auto& ring = rings[b];
+      std::sort(ring.begin(), ring.end());
+      const auto size = Index(ring.size());
+      const double sum = std::accumulate(ring.begin(), ring.end(), 0.);
+      const double median = size % 2 ? ring[size / 2] : (ring[size / 2 - 1] + ring[size / 2]) * .5;
+      BOOST_TEST((profiles.count[{b, s}] == size));
+      BOOST_TEST((profiles.sum[{b, s}] == sum));
+      BOOST_TEST((profiles.median[{b, s}] == median));
+      const double mean = means[{b, s}];
+      BOOST_TEST(mean == sum / size, boost::test_tools::tolerance(1e-6));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(stamp_size_mismatch_test)
+{
+  const RadialProfile<float> engine({5, 5});
+  std::vector<double> sums(engine.bin_count());
+  std::vector<Index> counts(engine.bin_count());
+  std::vector<float> medians(engine.bin_count());
+  std::vector<float> workspace;
+  const Raster<float> stamp({5, 4});
+  BOOST_CHECK_THROW(engine.apply(stamp, sums.data(), counts.data(), medians.data(), workspace), SizeError);
+  const std::vector<Raster<float>> stamps {Raster<float>({5, 5}), Raster<float>({6, 5})};
+  BOOST_CHECK_THROW(engine(stamps), SizeError);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
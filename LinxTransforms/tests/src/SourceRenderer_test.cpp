@@ -0,0 +1,91 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Transforms/SourceRenderer.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(SourceRenderer_test)
+
+//-----------------------------------------------------------------------------
+
+double gaussian(double x, double y)
+{
+  return std::exp(-(x * x + y * y) / 4.);
+}
+
+BOOST_AUTO_TEST_CASE(kernel_bank_test)
+{
+  const SourceRenderer<double> renderer(3, gaussian, 4);
+  BOOST_TEST(renderer.oversampling() == 4);
+  BOOST_TEST(renderer.window().shape() == (Position<2> {8, 8}));
+  for (Index y = 0; y < 4; ++y) {
+    for (Index x = 0; x < 4; ++x) {
+      const auto& k = renderer.kernel(x, y);
+      BOOST_TEST(std::accumulate(k.begin(), k.end(), 0.) == 1., boost::test_tools::tolerance(1e-12));
+    }
+  }
+  const auto& centered = renderer.kernel(0, 0);
+  const auto& shifted = renderer.kernel(2, 0); // Half a pixel
+  const auto c = -renderer.window().front();
+  const auto right = c + Position<2> {1, 0};
+  BOOST_TEST(shifted[c] == shifted[right], boost::test_tools::tolerance(1e-12));
+  BOOST_TEST(centered[c] > centered[right]);
+}
+
+BOOST_AUTO_TEST_CASE(sampled_psf_test)
+{
+  Raster<float> psf({5, 5});
+  psf.fill(0);
+  psf[{2, 2}] = 1;
+  const SourceRenderer<float> renderer(psf, 2);
+  BOOST_TEST(renderer.window().shape() == (Position<2> {6, 6}));
+  const auto c = -renderer.window().front();
+  BOOST_TEST((renderer.kernel(0, 0)[c] == 1));
+  BOOST_TEST((renderer.kernel(1, 0)[c] == 0.5));
+  BOOST_TEST((renderer.kernel(1, 0)[c + Position<2> {1, 0}] == 0.5));
+  BOOST_TEST((renderer.kernel(1, 1)[c + Position<2> {1, 1}] == 0.25));
+}
+
+BOOST_AUTO_TEST_CASE(render_test)
+{
+  const SourceRenderer<double> renderer(4, gaussian, 4);
+  const std::vector<Vector<double, 2>> positions {{10, 10}, {20.25, 13.5}, {-2.75, 30}, {38.5, 1}, {100, 100}, {5, 5}};
+  const std::vector<double> fluxes {1, 2, 3, 4, 5, std::numeric_limits<double>::quiet_NaN()};
+  Raster<double> frame({40, 35});
+  frame.fill(1);
+  renderer.render(frame, positions, fluxes, {7, 6});
+
+  Raster<double> expected({40, 35});
+  expected.fill(1);
+  for (std::size_t i = 0; i < 5; ++i) {
+    const Position<2> pixel {Index(std::floor(positions[i][0])), Index(std::floor(positions[i][1]))};
+    const auto& k = renderer.kernel(
+        Index((positions[i][0] - pixel[0]) * 4),
+        Index((positions[i][1] - pixel[1]) * 4));
+    for (const auto& p : k.domain()) {
+      const auto q = p + pixel + renderer.window().front();
+      if (expected.domain().contains(q)) {
+        expected[q] += fluxes[i] * k[p];
+      }
+    }
+  }
+  for (const auto& p : frame.domain()) {
+    BOOST_TEST(frame[p] == expected[p], boost::test_tools::tolerance(1e-12));
+  }
+
+  // Fully inside sources conserve flux
+  Raster<double> single({40, 35});
+  single.fill(0);
+  renderer.render(single, std::vector<Vector<double, 2>> {{20.25, 13.5}}, std::vector<double> {2});
+  BOOST_TEST(std::accumulate(single.begin(), single.end(), 0.) == 2., boost::test_tools::tolerance(1e-12));
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,79 @@
+// @copyright 2022-2024, Antoine Basset (CNES)
+// This file is part of Linx <github.com/kabasset/Linx>
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Linx/Transforms/Starlet.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Linx;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Starlet_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(mirror_test)
+{
+  const std::vector<Index> expected {2, 1, 0, 1, 2, 3, 2, 1, 0, 1};
+  for (Index i = -2; i < 8; ++i) {
+    BOOST_TEST(Internal::mirror(i, 4) == expected[i + 2]);
+  }
+  BOOST_TEST(Internal::mirror(5, 1) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(constant_test)
+{
+  Raster<float> in({16, 12});
+  in.fill(3);
+  const auto scales = starlet(in, 3);
+  BOOST_TEST((scales.shape() == Position<3>({16, 12, 4})));
+  for (Index j = 0; j < 3; ++j) {
+    for (const auto& e : scales.section(j)) {
+      BOOST_TEST(e == 0, boost::test_tools::tolerance(1e-6));
+    }
+  }
+  for (const auto& e : scales.section(3)) {
+    BOOST_TEST(e == 3, boost::test_tools::tolerance(1e-6));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(first_scale_test)
+{
+  Raster<double> in({9, 7});
+  in.generate([i = 0]() mutable {
+    return (i++ * 7919) % 23;
+  });
+  const auto scales = starlet(in, 1);
+  const std::vector<double> h {1. / 16., 4. / 16., 6. / 16., 4. / 16., 1. / 16.};
+  for (const auto& p : in.domain()) {
+    double smoothed = 0;
+    for (Index ky = -2; ky <= 2; ++ky) {
+      for (Index kx = -2; kx <= 2; ++kx) {
+        const Position<2> q {Internal::mirror(p[0] + kx, 9), Internal::mirror(p[1] + ky, 7)};
+        smoothed += h[kx + 2] * h[ky + 2] * in[q];
+      }
+    }
+    BOOST_TEST((scales[{p[0], p[1], 1}]) == smoothed, boost::test_tools::tolerance(1e-12));
+    BOOST_TEST((scales[{p[0], p[1], 0}]) == in[p] - smoothed, boost::test_tools::tolerance(1e-12));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(reconstruction_test)
+{
+  Raster<double, 3> in({10, 8, 6});
+  in.generate([i = 0]() mutable {
+    return (i++ * 7919) % 101;
+  });
+  const auto scales = starlet(in, 4);
+  const auto out = inverse_starlet(scales);
+  BOOST_TEST(out.shape() == in.shape());
+  for (const auto& p : in.domain()) {
+    BOOST_TEST(out[p] == in[p], boost::test_tools::tolerance(1e-9));
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()